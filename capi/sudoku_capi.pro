@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# Shared library exposing the solver through a C API, without Qt
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = sudoku_capi
+TEMPLATE = lib
+CONFIG += shared c++11 hide_symbols
+
+DEFINES += SUDOKU_CAPI_BUILD
+
+INCLUDEPATH += ../puzzles
+
+SOURCES += sudokucapi.cpp \
+    ../puzzles/sudokubandboard.cpp \
+    ../puzzles/sudokusatsolver.cpp \
+    ../puzzles/sudokuvalidator.cpp
+
+HEADERS  += sudokucapi.h
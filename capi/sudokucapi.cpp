@@ -0,0 +1,166 @@
+#include "sudokucapi.h"
+
+#include "sudokuboard.h"
+#include "sudokucancellation.h"
+#include "sudokusolver.h"
+#include "sudokuvalidator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    static_assert(static_cast<int>(puzzles::SudokuValidity::Valid) == SUDOKU_VALID
+                  && static_cast<int>(puzzles::SudokuValidity::Conflict) == SUDOKU_CONFLICT,
+                  "the validation results are passed through as they are");
+
+    puzzles::SudokuEngine engineFromFlags(std::uint32_t flags)
+    {
+        switch (flags & SUDOKU_ENGINE_MASK)
+        {
+        case SUDOKU_ENGINE_PROPAGATION: return puzzles::SudokuEngine::Propagation;
+        case SUDOKU_ENGINE_SAT:         return puzzles::SudokuEngine::Sat;
+        case SUDOKU_ENGINE_BITBOARD:    return puzzles::SudokuEngine::Bitboard;
+        case SUDOKU_ENGINE_LOCAL_SEARCH: return puzzles::SudokuEngine::LocalSearch;
+        default:                        return puzzles::SudokuEngine::Automatic;
+        }
+    }
+
+    std::uint32_t engineFlag(puzzles::SudokuEngine engine)
+    {
+        switch (engine)
+        {
+        case puzzles::SudokuEngine::Sat:        return SUDOKU_ENGINE_SAT;
+        case puzzles::SudokuEngine::Bitboard:   return SUDOKU_ENGINE_BITBOARD;
+        case puzzles::SudokuEngine::LocalSearch: return SUDOKU_ENGINE_LOCAL_SEARCH;
+        default:                                return SUDOKU_ENGINE_PROPAGATION;
+        }
+    }
+
+    // One board and one token for the whole batch, so the propagation engine only allocates while
+    // the board's buffers grow
+    template <std::size_t N>
+    void solveBatch(std::uint8_t const* in, std::uint8_t* out, std::size_t count, std::uint32_t flags,
+                    std::uint8_t* status, sudoku_stats* stats)
+    {
+        std::size_t const tileCount{ N*N*N*N };
+        puzzles::SudokuCancellationToken const cancellation{};
+        puzzles::SudokuSolver<N> solver{ puzzles::SudokuSolveOptions{ engineFromFlags(flags), 0 } };
+        puzzles::SudokuBoard<N> board{};
+
+        // Solving in place overwrites the puzzles the solutions are checked against
+        std::vector<std::uint8_t> copy{};
+        std::uint8_t const* givens{ in };
+        if (in < out + count * tileCount && out < in + count * tileCount)
+        {
+            copy.assign(in, in + count * tileCount);
+            givens = copy.data();
+        }
+        std::vector<puzzles::SudokuValidity> checks(count);
+        puzzles::SudokuValidator::checkAllGivens(givens, count, N, checks.data());
+        std::vector<std::uint8_t> solved(count, 0);
+
+        for (std::size_t puzzle = 0; puzzle != count; ++puzzle)
+        {
+            std::uint8_t const* const puzzleIn{ givens + puzzle * tileCount };
+            std::uint8_t* const puzzleOut{ out + puzzle * tileCount };
+            auto const start = puzzles::SudokuCancellationToken::clock_type::now();
+
+            if (checks[puzzle] != puzzles::SudokuValidity::Valid)
+            {
+                std::memmove(puzzleOut, puzzleIn, tileCount);
+                if (status != nullptr)
+                    status[puzzle] = SUDOKU_INVALID;
+                if (stats != nullptr)
+                    stats[puzzle] = sudoku_stats{};
+                continue;
+            }
+
+            board.clearAll();
+            for (std::size_t index = 0; index != tileCount; ++index)
+            {
+                if (puzzleIn[index] != 0)
+                    board.setTileSolution(index / (N*N), index % (N*N), puzzleIn[index]);
+            }
+            solved[puzzle] = solver.solve(board, cancellation);
+            for (std::size_t index = 0; index != tileCount; ++index)
+                puzzleOut[index] = static_cast<std::uint8_t>(board.getTileSolution(index / (N*N), index % (N*N)));
+
+            if (status != nullptr)
+                status[puzzle] = solved[puzzle] ? SUDOKU_SOLVED : SUDOKU_UNSOLVABLE;
+            if (stats != nullptr)
+            {
+                sudoku_stats& puzzleStats = stats[puzzle];
+                puzzleStats.engine = engineFlag(solver.engine());
+                puzzleStats.nodes = solver.searchStatistics().nodes;
+                puzzleStats.backtracks = solver.searchStatistics().backtracks;
+                puzzleStats.decisions = solver.satStatistics().decisions;
+                puzzleStats.conflicts = solver.satStatistics().conflicts;
+                puzzleStats.restarts = solver.localSearchStatistics().restarts;
+                puzzleStats.moves = solver.localSearchStatistics().moves;
+                puzzleStats.time_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    puzzles::SudokuCancellationToken::clock_type::now() - start).count());
+            }
+        }
+
+        // Every solution checked at once
+        puzzles::SudokuValidator::checkAllSolutions(out, givens, count, N, checks.data());
+        for (std::size_t puzzle = 0; puzzle != count; ++puzzle)
+        {
+            if (status != nullptr && solved[puzzle] && checks[puzzle] != puzzles::SudokuValidity::Valid)
+                status[puzzle] = SUDOKU_UNVERIFIED;
+        }
+    }
+}
+
+int sudoku_box_size_supported(size_t box_size)
+{
+    return box_size >= 2 && box_size <= 8;
+}
+
+int sudoku_solve_batch(uint8_t const* in, uint8_t* out, size_t count, size_t box_size, uint32_t flags,
+                       uint8_t* status, sudoku_stats* stats)
+{
+    if ((count != 0 && (in == nullptr || out == nullptr)) || !sudoku_box_size_supported(box_size))
+        return SUDOKU_ERROR_ARGUMENT;
+
+    try
+    {
+        switch (box_size)
+        {
+        case 2: solveBatch<2>(in, out, count, flags, status, stats); break;
+        case 3: solveBatch<3>(in, out, count, flags, status, stats); break;
+        case 4: solveBatch<4>(in, out, count, flags, status, stats); break;
+        case 5: solveBatch<5>(in, out, count, flags, status, stats); break;
+        case 6: solveBatch<6>(in, out, count, flags, status, stats); break;
+        case 7: solveBatch<7>(in, out, count, flags, status, stats); break;
+        case 8: solveBatch<8>(in, out, count, flags, status, stats); break;
+        }
+    }
+    catch (...)
+    {
+        return SUDOKU_ERROR_INTERNAL;
+    }
+    return SUDOKU_OK;
+}
+
+int sudoku_validate_batch(uint8_t const* solutions, uint8_t const* puzzles, size_t count, size_t box_size,
+                          uint8_t* result)
+{
+    if ((count != 0 && (solutions == nullptr || result == nullptr)) || !sudoku_box_size_supported(box_size))
+        return SUDOKU_ERROR_ARGUMENT;
+
+    try
+    {
+        std::vector<puzzles::SudokuValidity> checks(count);
+        puzzles::SudokuValidator::checkAllSolutions(solutions, puzzles, count, box_size, checks.data());
+        for (std::size_t board = 0; board != count; ++board)
+            result[board] = static_cast<std::uint8_t>(checks[board]);
+    }
+    catch (...)
+    {
+        return SUDOKU_ERROR_INTERNAL;
+    }
+    return SUDOKU_OK;
+}
@@ -0,0 +1,117 @@
+#ifndef SUDOKUCAPI_H
+#define SUDOKUCAPI_H
+/*
+Sudoku solver C API
+====================================================================================================
+A plain C interface to the solver, for programs that can't or don't want to link against Qt or C++.
+It is built as its own shared library by capi/sudoku_capi.pro; only the functions here are exported.
+
+Puzzles are passed packed: box_size^4 bytes each, row-major, 0 for an empty tile and 1 to box_size^2
+for a value, one after another. The box size is picked at runtime, from 2 (4x4) to 8 (64x64).
+sudoku_solve_batch() reads from and writes to the caller's buffers directly, which may be the same
+buffer to solve in place. Every puzzle is checked for conflicting givens before it is solved and
+every solution checked against its puzzle afterwards; sudoku_validate_batch() makes the same checks
+on boards from anywhere else.
+
+Each call reuses one board for all of its puzzles, so the propagation engine does no allocation per
+puzzle once the board's undo buffers have grown to fit; the SAT engine builds a clause database for
+every puzzle it is given. Calls share no state, so any number may run at once on different threads.
+No C++ exception escapes a call.
+*/
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(SUDOKU_CAPI_BUILD)
+#    define SUDOKU_CAPI __declspec(dllexport)
+#  else
+#    define SUDOKU_CAPI __declspec(dllimport)
+#  endif
+#else
+#  define SUDOKU_CAPI __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returned by sudoku_solve_batch() and sudoku_validate_batch() */
+enum
+{
+    SUDOKU_OK = 0,
+    SUDOKU_ERROR_ARGUMENT = 1,      /* null buffer or unsupported box size; nothing was written */
+    SUDOKU_ERROR_INTERNAL = 2       /* out of memory or similar; puzzles not reached are untouched */
+};
+
+/* Per puzzle status */
+enum
+{
+    SUDOKU_SOLVED = 0,
+    SUDOKU_UNSOLVABLE = 1,
+    SUDOKU_INVALID = 2,             /* a value out of range or twice in a unit; the puzzle is copied
+                                       to out unsolved */
+    SUDOKU_UNVERIFIED = 3           /* the solver's answer failed the solution check; out holds it,
+                                       but it is not a solution */
+};
+
+/* Per board result of sudoku_validate_batch() */
+enum
+{
+    SUDOKU_VALID = 0,
+    SUDOKU_BAD_VALUE = 1,           /* a value larger than box_size^2 */
+    SUDOKU_INCOMPLETE = 2,          /* an empty tile */
+    SUDOKU_GIVEN_CHANGED = 3,       /* a tile that differs from the puzzle's value there */
+    SUDOKU_CONFLICT = 4             /* a value twice in a row, column or square */
+};
+
+/* Flags: at most one engine, default automatic (bitboard for 9x9, propagation below 25x25, SAT from
+   there). Bitboard on other sizes runs propagation. Local search is simulated annealing, for large
+   sparse boards. */
+enum
+{
+    SUDOKU_ENGINE_AUTOMATIC = 0x0,
+    SUDOKU_ENGINE_PROPAGATION = 0x1,
+    SUDOKU_ENGINE_SAT = 0x2,
+    SUDOKU_ENGINE_BITBOARD = 0x3,
+    SUDOKU_ENGINE_LOCAL_SEARCH = 0x4,
+    SUDOKU_ENGINE_MASK = 0x7
+};
+
+/* Per puzzle statistics. Only the counters of the engine that ran are filled in. */
+typedef struct sudoku_stats
+{
+    uint32_t engine;                /* SUDOKU_ENGINE_PROPAGATION, _SAT, _BITBOARD or _LOCAL_SEARCH */
+    uint64_t nodes;                 /* propagation and bitboard: guesses */
+    uint64_t backtracks;            /* propagation and bitboard: guesses undone */
+    uint64_t decisions;             /* SAT */
+    uint64_t conflicts;             /* SAT */
+    uint64_t restarts;              /* local search */
+    uint64_t moves;                 /* local search: moves tried */
+    uint64_t time_ns;
+} sudoku_stats;
+
+/* Is this box size supported? */
+SUDOKU_CAPI int sudoku_box_size_supported(size_t box_size);
+
+/*
+Solve count puzzles of this box size from in, writing each result to out: the solution, or as far
+as the solve got for one that is unsolvable. status (count bytes) and stats (count entries) are
+optional and may be NULL. Returns SUDOKU_OK or an error.
+*/
+SUDOKU_CAPI int sudoku_solve_batch(uint8_t const* in, uint8_t* out, size_t count, size_t box_size, uint32_t flags,
+                                   uint8_t* status, sudoku_stats* stats);
+
+/*
+Check count solutions of this box size, writing one of the results above per board to result
+(count bytes). puzzles, if not NULL, holds each solution's puzzle, whose values it must keep. For
+9x9 and 16x16 boards eight are checked at a time with SIMD, so checking thousands takes well under
+a millisecond. Returns SUDOKU_OK or an error.
+*/
+SUDOKU_CAPI int sudoku_validate_batch(uint8_t const* solutions, uint8_t const* puzzles, size_t count, size_t box_size,
+                                      uint8_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUDOKUCAPI_H */
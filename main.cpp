@@ -1,8 +1,12 @@
 #include "puzzles/sudokusolverdialog.h"
+#include "puzzles/sudokucommandline.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    if (puzzles::SudokuCommandLine::handles(argc, argv))
+        return puzzles::SudokuCommandLine::run(argc, argv);
+
     QApplication application(argc, argv);
     puzzles::SudokuSolverDialog window;
     window.show();
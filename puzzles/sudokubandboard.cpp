@@ -0,0 +1,408 @@
+#include "sudokubandboard.h"
+
+#include "sudokubits.h"
+
+namespace
+{
+    // Bit (row % 3) * 9 + column of a band
+    std::uint32_t const c_bandMask{ 0x7FFFFFFu };
+    std::uint32_t const c_rowMasks[3]{ 0x1FFu, 0x1FFu << 9, 0x1FFu << 18 };
+    std::uint32_t const c_boxMasks[3]{ 0x1C0E07u, 0x1C0E07u << 3, 0x1C0E07u << 6 };
+    std::uint32_t const c_columnMask{ 0x40201u };
+    // Above the tiles, the rows of the band the word's digit hasn't been solved in yet
+    std::size_t const c_rowFlagShift{ 27 };
+    std::uint32_t const c_rowFlags{ 7u << c_rowFlagShift };
+
+    std::size_t tileBand(std::size_t xPosition)                         { return xPosition / 3; }
+    std::size_t tileBit(std::size_t xPosition, std::size_t yPosition)   { return xPosition % 3 * 9 + yPosition; }
+
+    // Lookups for one digit's word of a band
+    struct BandTables
+    {
+        // The squares a row's nine bits reach
+        std::uint32_t rowSquares[512];
+        // Whether a row's nine bits are down to one
+        std::uint32_t rowSolved[512];
+        // From the squares each row reaches, bit row * 3 + square, the tiles left once every row
+        // has been given its own square; 0 if that can't be done
+        std::uint32_t squareMatches[512];
+        // From the columns a band reaches, what the digit's other bands keep: not the columns the
+        // band is confined to within a square
+        std::uint32_t singleColumns[512];
+        // From the columns two bands reach between them, what the third keeps: in each stack where
+        // they reach only two columns, neither of those
+        std::uint32_t pairedColumns[512];
+        // The tile and the rest of the band outside its row and square
+        std::uint32_t alone[27];
+    };
+
+    std::uint32_t columns(std::uint32_t stackColumns, std::size_t stack)
+    {
+        std::uint32_t result{ 0 };
+        for (std::size_t column = 0; column != 3; ++column)
+        {
+            if ((stackColumns & (1u << column)) != 0)
+                result |= c_columnMask << (stack * 3 + column);
+        }
+        return result;
+    }
+
+    BandTables makeBandTables()
+    {
+        std::size_t const matchings[6][3]{ { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+
+        BandTables tables{};
+        for (std::uint32_t bits = 0; bits != 512; ++bits)
+        {
+            for (std::size_t square = 0; square != 3; ++square)
+            {
+                if ((bits & (7u << (square * 3))) != 0)
+                    tables.rowSquares[bits] |= 1u << square;
+            }
+            tables.rowSolved[bits] = puzzles::isSingleBit(bits) ? 1 : 0;
+
+            for (auto const& matching : matchings)
+            {
+                if ((bits & (1u << matching[0])) != 0 && (bits & (1u << (3 + matching[1]))) != 0 && (bits & (1u << (6 + matching[2]))) != 0)
+                {
+                    for (std::size_t row = 0; row != 3; ++row)
+                        tables.squareMatches[bits] |= c_rowMasks[row] & c_boxMasks[matching[row]];
+                }
+            }
+
+            tables.singleColumns[bits] = c_bandMask | c_rowFlags;
+            tables.pairedColumns[bits] = c_bandMask | c_rowFlags;
+            for (std::size_t stack = 0; stack != 3; ++stack)
+            {
+                std::uint32_t const stackColumns{ (bits >> (stack * 3)) & 7u };
+                if (puzzles::isSingleBit(stackColumns))
+                    tables.singleColumns[bits] &= ~columns(stackColumns, stack);
+                if (puzzles::popCount(stackColumns) == 2)
+                    tables.pairedColumns[bits] &= ~columns(stackColumns, stack);
+            }
+        }
+        for (std::size_t bit = 0; bit != 27; ++bit)
+            tables.alone[bit] = ~((c_rowMasks[bit / 9] | c_boxMasks[bit % 9 / 3]) & ~(1u << bit));
+        return tables;
+    }
+
+    BandTables const c_tables{ makeBandTables() };
+
+    // The columns a word reaches
+    std::uint32_t columnsOf(std::uint32_t word)
+    {
+        return (word | (word >> 9) | (word >> 18)) & 0x1FFu;
+    }
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuBandBoard::SudokuBandBoard() :
+    m_state{},
+    m_searchStatistics{},
+    m_cancellation{ nullptr }
+{
+    m_state.digits.fill(c_bandMask | c_rowFlags);
+    m_state.checked.fill(0);
+    m_state.unsolved.fill(c_bandMask);
+    m_state.contradiction = false;
+}
+
+puzzles::SudokuBandBoard::SudokuBandBoard(std::array<std::size_t, 81> const& tileValuesArray) :
+    SudokuBandBoard()
+{
+    for (std::size_t index = 0; index != tileValuesArray.size(); ++index)
+    {
+        if (tileValuesArray[index] != 0)
+            setTileSolution(index / 9, index % 9, tileValuesArray[index]);
+    }
+}
+
+// Interface
+//============================================================
+void puzzles::SudokuBandBoard::setTileSolution(std::size_t xPosition, std::size_t yPosition, std::size_t value)
+{
+    if (value > 9)
+        return;
+    if (value != 0)
+    {
+        restrictTile(xPosition, yPosition, 1u << (value - 1));
+        return;
+    }
+
+    std::array<std::size_t, 81> values{ getTileSolutions() };
+    values[xPosition * 9 + yPosition] = 0;
+    *this = SudokuBandBoard{ values };
+}
+
+std::size_t puzzles::SudokuBandBoard::getTileSolution(std::size_t xPosition, std::size_t yPosition) const
+{
+    std::size_t const band{ tileBand(xPosition) };
+    std::uint32_t const cell{ 1u << tileBit(xPosition, yPosition) };
+    if ((m_state.unsolved[band] & cell) != 0)
+        return 0;
+    for (std::size_t digit = 0; digit != 9; ++digit)
+    {
+        if ((m_state.digits[digit * 3 + band] & cell) != 0)
+            return digit + 1;
+    }
+    return 0;
+}
+
+std::array<std::size_t, 81> puzzles::SudokuBandBoard::getTileSolutions() const
+{
+    std::array<std::size_t, 81> result{};
+    for (std::size_t index = 0; index != result.size(); ++index)
+        result[index] = getTileSolution(index / 9, index % 9);
+    return result;
+}
+
+bool puzzles::SudokuBandBoard::isSolved() const
+{
+    return !m_state.contradiction && (m_state.unsolved[0] | m_state.unsolved[1] | m_state.unsolved[2]) == 0;
+}
+
+bool puzzles::SudokuBandBoard::propagateAll()
+{
+    return propagate(m_state);
+}
+
+bool puzzles::SudokuBandBoard::solveAll()
+{
+    m_searchStatistics = SudokuSearchStatistics{};
+    if (!propagate(m_state))
+        return false;
+    if (isSolved())
+        return true;
+
+    State root{ m_state };
+    return search(root, 1);
+}
+
+bool puzzles::SudokuBandBoard::solveAll(SudokuCancellationToken const& cancellation)
+{
+    m_cancellation = &cancellation;
+    bool const result{ solveAll() };
+    m_cancellation = nullptr;
+    return result;
+}
+
+puzzles::SudokuSearchStatistics const& puzzles::SudokuBandBoard::searchStatistics() const
+{
+    return m_searchStatistics;
+}
+
+// Helpers
+//============================================================
+void puzzles::SudokuBandBoard::restrictTile(std::size_t xPosition, std::size_t yPosition, std::uint32_t candidates)
+{
+    std::size_t const band{ tileBand(xPosition) };
+    std::size_t const bit{ tileBit(xPosition, yPosition) };
+    std::uint32_t const cell{ 1u << bit };
+
+    std::uint32_t remaining{ 0 };
+    for (std::size_t digit = 0; digit != 9; ++digit)
+    {
+        if ((candidates & (1u << digit)) == 0)
+            m_state.digits[digit * 3 + band] &= ~cell;
+        else if ((m_state.digits[digit * 3 + band] & cell) != 0)
+            remaining |= 1u << digit;
+    }
+    if (remaining == 0)
+        m_state.contradiction = true;
+    else if ((m_state.unsolved[band] & cell) != 0 && isSingleBit(remaining))
+        place(m_state, lowestBitIndex(remaining), band, bit);
+}
+
+// Solve a tile as a digit: the tile goes from the other digits, and the rest of its row and square
+// from this one. Propagation takes its column from the digit's other bands.
+void puzzles::SudokuBandBoard::place(State& state, std::size_t digit, std::size_t band, std::size_t bit)
+{
+    std::uint32_t const cell{ 1u << bit };
+    if ((state.digits[digit * 3 + band] & cell) == 0)
+    {
+        state.contradiction = true;
+        return;
+    }
+
+    state.unsolved[band] &= ~cell;
+    for (std::size_t other = band; other < 27; other += 3)
+        state.digits[other] &= ~cell;
+    state.digits[digit * 3 + band] &= c_tables.alone[bit];
+    state.digits[digit * 3 + band] |= cell;
+}
+
+// Update the changed words until none change, then naked singles, until neither changes anything
+bool puzzles::SudokuBandBoard::propagate(State& state)
+{
+    bool changed{ !state.contradiction };
+    while (changed)
+    {
+        changed = false;
+        if (!update(state) || !nakedSingles(state, changed))
+            state.contradiction = true;
+        if (state.contradiction)
+            return false;
+    }
+    return true;
+}
+
+// Every word that has changed since it was last updated, until none has. The words a word's update
+// changes join those still to do.
+bool puzzles::SudokuBandBoard::update(State& state)
+{
+    std::uint32_t pending{ 0 };
+    for (std::size_t index = 0; index != 27; ++index)
+        pending |= static_cast<std::uint32_t>(state.digits[index] != state.checked[index]) << index;
+    while (pending != 0)
+    {
+        std::size_t const index{ lowestBitIndex(pending) };
+        pending &= pending - 1;
+        if (!updateWord(state, index, pending))
+            return false;
+    }
+    return true;
+}
+
+// Keep the tiles where every row of the band can still have the digit in a square of its own, take
+// from the other bands the columns this one pins down, and solve any row down to one tile
+bool puzzles::SudokuBandBoard::updateWord(State& state, std::size_t index, std::uint32_t& pending)
+{
+    std::size_t const band{ index % 3 };
+    std::uint32_t word{ state.digits[index] };
+    std::uint32_t const rowSquares{ c_tables.rowSquares[word & 0x1FFu]
+                                    | c_tables.rowSquares[(word >> 9) & 0x1FFu] << 3
+                                    | c_tables.rowSquares[(word >> 18) & 0x1FFu] << 6 };
+    word &= c_tables.squareMatches[rowSquares] | c_rowFlags;
+    if ((word & c_bandMask) == 0)
+        return false;
+
+    std::size_t const nextIndex{ index - band + (band + 1) % 3 };
+    std::size_t const lastIndex{ index - band + (band + 2) % 3 };
+    std::uint32_t const next{ state.digits[nextIndex] };
+    std::uint32_t const last{ state.digits[lastIndex] };
+    std::uint32_t const reached{ columnsOf(word) };
+    std::uint32_t const keptNext{ next & c_tables.singleColumns[reached] & c_tables.pairedColumns[reached | columnsOf(last)] };
+    std::uint32_t const keptLast{ last & c_tables.singleColumns[reached] & c_tables.pairedColumns[reached | columnsOf(keptNext)] };
+    state.digits[nextIndex] = keptNext;
+    state.digits[lastIndex] = keptLast;
+    pending |= static_cast<std::uint32_t>(keptNext != next) << nextIndex | static_cast<std::uint32_t>(keptLast != last) << lastIndex;
+
+    // Rows newly down to one tile
+    std::uint32_t const solvedRows{ (c_tables.rowSolved[word & 0x1FFu]
+                                     | c_tables.rowSolved[(word >> 9) & 0x1FFu] << 1
+                                     | c_tables.rowSolved[(word >> 18) & 0x1FFu] << 2) & (word >> c_rowFlagShift) };
+    for (std::uint32_t rows = solvedRows; rows != 0; rows &= rows - 1)
+    {
+        std::size_t const row{ lowestBitIndex(rows) };
+        std::uint32_t const cell{ word & c_rowMasks[row] };
+        word &= ~(1u << (c_rowFlagShift + row));
+        state.unsolved[band] &= ~cell;
+        for (std::size_t other = band; other < 27; other += 3)
+        {
+            pending |= static_cast<std::uint32_t>((state.digits[other] & cell) != 0) << other;
+            state.digits[other] &= ~cell;
+        }
+        pending &= ~(1u << index);
+    }
+
+    state.digits[index] = word;
+    state.checked[index] = word;
+    return true;
+}
+
+// Count each tile's candidates up to two across the digits of its band: tiles with none mean no
+// solution, tiles with one are solved
+bool puzzles::SudokuBandBoard::nakedSingles(State& state, bool& changed)
+{
+    for (std::size_t band = 0; band != 3; ++band)
+    {
+        if (state.unsolved[band] == 0)
+            continue;
+
+        std::uint32_t once{ 0 }, twice{ 0 };
+        for (std::size_t digit = 0; digit != 9; ++digit)
+        {
+            std::uint32_t const candidates{ state.digits[digit * 3 + band] };
+            twice |= once & candidates;
+            once |= candidates;
+        }
+        if ((state.unsolved[band] & ~once) != 0)
+            return false;
+
+        for (std::uint32_t singles = state.unsolved[band] & ~twice; singles != 0; singles &= singles - 1)
+        {
+            std::size_t const bit{ lowestBitIndex(singles) };
+            std::uint32_t const cell{ 1u << bit };
+            std::size_t digit{ 0 };
+            while (digit != 9 && (state.digits[digit * 3 + band] & cell) == 0)
+                ++digit;
+            // a single placed earlier in this pass took this tile's last digit
+            if (digit == 9)
+                return false;
+            place(state, digit, band, bit);
+            changed = true;
+        }
+    }
+    return true;
+}
+
+// Guess at a tile with two candidates if there is one, or else one with fewest
+bool puzzles::SudokuBandBoard::search(State& state, std::size_t depth)
+{
+    if (!propagate(state))
+        return false;
+    if ((state.unsolved[0] | state.unsolved[1] | state.unsolved[2]) == 0)
+    {
+        m_state = state;
+        return true;
+    }
+    if (m_cancellation != nullptr && m_cancellation->shouldStop())
+        return false;
+    if (depth > m_searchStatistics.maxDepth)
+        m_searchStatistics.maxDepth = depth;
+
+    // Count every unsolved tile's candidates up to four at once, band by band, keeping the tiles
+    // of the smallest count seen
+    std::size_t bestBand{ 0 }, bestCount{ 5 };
+    std::uint32_t best{ 0 };
+    for (std::size_t band = 0; band != 3 && bestCount != 2; ++band)
+    {
+        std::uint32_t once{ 0 }, twice{ 0 }, thrice{ 0 }, fourTimes{ 0 };
+        for (std::size_t digit = 0; digit != 9; ++digit)
+        {
+            std::uint32_t const candidates{ state.digits[digit * 3 + band] };
+            fourTimes |= thrice & candidates;
+            thrice |= twice & candidates;
+            twice |= once & candidates;
+            once |= candidates;
+        }
+        std::uint32_t const unsolved{ state.unsolved[band] };
+        std::uint32_t const byCount[3]{ unsolved & ~thrice, unsolved & ~fourTimes, unsolved };
+        for (std::size_t count = 2; count != bestCount && count != 5; ++count)
+        {
+            if (byCount[count - 2] != 0)
+            {
+                bestBand = band;
+                bestCount = count;
+                best = byCount[count - 2];
+                break;
+            }
+        }
+    }
+
+    std::size_t const bit{ lowestBitIndex(best) };
+    std::uint32_t const cell{ 1u << bit };
+    for (std::size_t digit = 0; digit != 9; ++digit)
+    {
+        if ((state.digits[digit * 3 + bestBand] & cell) == 0)
+            continue;
+        ++m_searchStatistics.nodes;
+        State guess{ state };
+        place(guess, digit, bestBand, bit);
+        if (search(guess, depth + 1))
+            return true;
+        ++m_searchStatistics.backtracks;
+    }
+    return false;
+}
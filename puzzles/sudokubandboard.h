@@ -0,0 +1,126 @@
+#ifndef SUDOKUBANDBOARD_H
+#define SUDOKUBANDBOARD_H
+/*
+class SudokuBandBoard
+====================================================================================================
+A 9x9 board laid out for whole-board bit operations rather than per tile, as used by fast 9x9
+solvers such as JCZSolve and fsss. The board is split into three bands of three rows, and each
+digit has one 27 bit word per band saying which tiles of the band could still be that digit, bit
+(row % 3) * 9 + column. A solved tile keeps its bit in its own digit's word and loses it from the
+others, and a word per band records which tiles are still unsolved.
+
+Propagation works a word at a time, redoing any word that has changed since it was last looked at.
+A digit goes in each row and each square of a band exactly once, so which squares each row of the
+word still reaches, nine bits, looks up the tiles left to the digit by every way of matching the
+rows to the squares; that takes in locked candidates and hidden singles within the band. The
+columns the word reaches then look up what the digit's other two bands lose: a column the digit is
+confined to within a square, and in each stack the two columns two bands are confined to between
+them. A row of the word down to one tile is solved there, and the tile goes from the band's other
+digits; bits 27 to 29 of each word say which rows haven't been solved yet. Tiles left with one
+digit are found by counting across the nine words of a band with ORs and ANDs. Guesses go on a
+tile with two digits where there is one, and copy the whole state, so there is nothing to undo.
+
+It is an alternative engine for SudokuBoard<3>, picked with SudokuEngine::Bitboard. The board
+converts to and from SudokuBoard<3>, and has the same solving and tile access functions.
+*/
+#include "sudokuboard.h"
+#include "sudokucancellation.h"
+#include "sudokusearchstatistics.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace puzzles
+{
+
+class SudokuBandBoard
+{
+public:
+    // Special 6
+    //============================================================
+    // Every tile empty
+    SudokuBandBoard();
+    explicit SudokuBandBoard(std::array<std::size_t, 81> const& tileValuesArray);
+    // The candidates of every tile of the board
+    explicit SudokuBandBoard(SudokuBoard<3> const& board)
+        : SudokuBandBoard()
+    {
+        for (std::size_t xPosition = 0; xPosition != 9; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != 9; ++yPosition)
+                restrictTile(xPosition, yPosition, static_cast<std::uint32_t>(board.getTileCandidates(xPosition, yPosition)));
+        }
+    }
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // Solved tiles as SudokuBoard<3> solutions; the board's other tiles are left alone
+    void writeSolutions(SudokuBoard<3>& board) const
+    {
+        for (std::size_t xPosition = 0; xPosition != 9; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != 9; ++yPosition)
+            {
+                std::size_t const value{ getTileSolution(xPosition, yPosition) };
+                if (value != 0)
+                    board.setTileSolution(xPosition, yPosition, value);
+            }
+        }
+    }
+    SudokuBoard<3> toBoard() const
+    {
+        return SudokuBoard<3>{ getTileSolutions() };
+    }
+
+    // This tile is this value. Emptying a tile with 0 rebuilds the board from its solved tiles.
+    void setTileSolution(std::size_t xPosition, std::size_t yPosition, std::size_t value);
+    std::size_t getTileSolution(std::size_t xPosition, std::size_t yPosition) const;
+    std::array<std::size_t, 81> getTileSolutions() const;
+
+    bool isSolved() const;
+
+    // Solve what can be solved without guessing. Returns false if the board has no solution.
+    bool propagateAll();
+    // Solve the puzzle, guessing when propagation stalls. Returns true if it ends up solved; if
+    // not, the board is left as propagation left it.
+    bool solveAll();
+    // Stopping early if the token is cancelled
+    bool solveAll(SudokuCancellationToken const& cancellation);
+
+    SudokuSearchStatistics const& searchStatistics() const;
+
+private:
+    // Typedefs
+    //============================================================
+    struct State
+    {
+        std::array<std::uint32_t, 27> digits;      // per digit and band, digit * 3 + band
+        std::array<std::uint32_t, 27> checked;     // each word as propagation last left it
+        std::array<std::uint32_t, 3> unsolved;     // per band
+        bool contradiction;
+    };
+
+    // Helpers
+    //============================================================
+    // Keep only these values (bit value - 1) on a tile, placing it if one is left
+    void restrictTile(std::size_t xPosition, std::size_t yPosition, std::uint32_t candidates);
+
+    static void place(State& state, std::size_t digit, std::size_t band, std::size_t bit);
+    static bool propagate(State& state);
+    static bool update(State& state);
+    static bool updateWord(State& state, std::size_t index, std::uint32_t& pending);
+    static bool nakedSingles(State& state, bool& changed);
+    bool search(State& state, std::size_t depth);
+
+    // Data Members
+    //============================================================
+    State m_state;
+    SudokuSearchStatistics m_searchStatistics;
+    SudokuCancellationToken const* m_cancellation;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUBANDBOARD_H
@@ -0,0 +1,286 @@
+#include "sudokubatchpipeline.h"
+
+#include "sudokupuzzletext.h"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <thread>
+
+namespace
+{
+    char const* const c_statusNames[]{ "solved ", "unsolvable ", "timeout ", "cancelled " };
+
+    // Call check(first, count, boxSize) for each run of puzzles of one size, so the validator gets
+    // as many boards at once as it can
+    template <typename Check>
+    void forEachRun(std::vector<std::size_t> const& boxSizes, Check check)
+    {
+        for (std::size_t first = 0; first != boxSizes.size();)
+        {
+            std::size_t last{ first + 1 };
+            while (last != boxSizes.size() && boxSizes[last] == boxSizes[first])
+                ++last;
+            if (boxSizes[first] != 0)
+                check(first, last - first, boxSizes[first]);
+            first = last;
+        }
+    }
+
+    void add(puzzles::SudokuBatchStatistics& total, puzzles::SudokuBatchStatistics const& part)
+    {
+        total.puzzles += part.puzzles;
+        total.solved += part.solved;
+        total.unsolvable += part.unsolvable;
+        total.timedOut += part.timedOut;
+        total.cancelled += part.cancelled;
+        total.errors += part.errors;
+        total.batches += part.batches;
+        total.readerWaits += part.readerWaits;
+        total.writerWaits += part.writerWaits;
+        total.solveTime += part.solveTime;
+        puzzles::SudokuPerfCounters::add(total.counters, part.counters);
+    }
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuBatchPipeline::SudokuBatchPipeline(std::size_t solverCount) :
+    m_solverCount{ solverCount != 0 ? solverCount : std::max<std::size_t>(1, std::thread::hardware_concurrency() - std::min(2u, std::thread::hardware_concurrency())) },
+    m_batchSize{ 64 },
+    m_batchesInFlight{ 0 },
+    m_options{ SudokuSolveOptions{} },
+    m_timeout{ 0 },
+    m_solver{}
+{}
+
+// Interface
+//============================================================
+puzzles::SudokuBatchStatistics puzzles::SudokuBatchPipeline::run(std::istream& input, std::ostream& output,
+                                                                 SudokuCancellationToken const& cancellation)
+{
+    clock_type::time_point const started{ clock_type::now() };
+
+    std::size_t const batchCount{ m_batchesInFlight != 0 ? m_batchesInFlight : m_solverCount * 4 };
+    std::vector<Batch> batches(std::max<std::size_t>(2, batchCount));
+    Ring freeRing{ batches.size() };
+    Ring solveRing{ batches.size() + m_solverCount };
+    Ring writeRing{ batches.size() + m_solverCount };
+    for (auto& batch : batches)
+        freeRing.push(&batch);
+
+    // Each stage counts into its own statistics, added up once they have all stopped
+    std::vector<SudokuBatchStatistics> solverStatistics(m_solverCount, SudokuBatchStatistics{});
+    SudokuBatchStatistics writerStatistics{};
+    std::vector<std::thread> solvers{};
+    for (std::size_t index = 0; index != m_solverCount; ++index)
+    {
+        SudokuBatchStatistics& statistics{ solverStatistics[index] };
+        solvers.emplace_back([this, &solveRing, &writeRing, &cancellation, &statistics]()
+        {
+            solveStage(solveRing, writeRing, cancellation, statistics);
+        });
+    }
+    std::thread writer{ [this, &output, &writeRing, &freeRing, &batches, &writerStatistics]()
+    {
+        writeStage(output, writeRing, freeRing, batches.size(), writerStatistics);
+    }};
+
+    // Read and parse on this thread
+    SudokuBatchStatistics statistics{};
+    std::string line{};
+    std::vector<std::uint8_t> values{};
+    std::uint64_t sequence{ 0 };
+    bool reading{ true };
+    while (reading)
+    {
+        Batch* batch{ nullptr };
+        if (freeRing.pop(batch) != 0)
+            ++statistics.readerWaits;
+        batch->boxSizes.clear();
+        batch->offsets.clear();
+        batch->values.clear();
+        batch->output.clear();
+
+        while (batch->boxSizes.size() < m_batchSize)
+        {
+            if (cancellation.shouldStop() || !std::getline(input, line))
+            {
+                reading = false;
+                break;
+            }
+            std::size_t first{ 0 };
+            std::size_t length{ 0 };
+            if (!SudokuPuzzleText::findPuzzle(line.data(), line.size(), first, length))
+                continue;
+
+            std::size_t boxSize{ 0 };
+            if (!SudokuPuzzleText::parse(line.data() + first, length, values, boxSize))
+                boxSize = 0;
+            batch->boxSizes.push_back(boxSize);
+            batch->offsets.push_back(batch->values.size());
+            batch->values.insert(batch->values.end(), values.cbegin(), values.cend());
+        }
+
+        if (batch->boxSizes.empty())
+        {
+            freeRing.push(batch);
+            break;
+        }
+        batch->sequence = sequence++;
+        solveRing.push(batch);
+    }
+
+    // One empty batch per solver tells it to stop, and it passes that on to the writer
+    for (std::size_t index = 0; index != m_solverCount; ++index)
+        solveRing.push(nullptr);
+    for (auto& solver : solvers)
+        solver.join();
+    writer.join();
+
+    for (auto const& part : solverStatistics)
+        add(statistics, part);
+    add(statistics, writerStatistics);
+    statistics.wallTime = clock_type::now() - started;
+    return statistics;
+}
+
+std::size_t puzzles::SudokuBatchPipeline::solverCount() const
+{
+    return m_solverCount;
+}
+
+void puzzles::SudokuBatchPipeline::setBatchSize(std::size_t batchSize)
+{
+    m_batchSize = std::max<std::size_t>(1, batchSize);
+}
+
+void puzzles::SudokuBatchPipeline::setBatchesInFlight(std::size_t batches)
+{
+    m_batchesInFlight = batches;
+}
+
+void puzzles::SudokuBatchPipeline::setOptions(SudokuSolveOptions const& options)
+{
+    m_options = options;
+}
+
+void puzzles::SudokuBatchPipeline::setTimeout(std::chrono::milliseconds timeout)
+{
+    m_timeout = timeout;
+}
+
+void puzzles::SudokuBatchPipeline::setCacheLimit(std::size_t boxSize)
+{
+    m_solver.setCacheLimit(boxSize);
+}
+
+// Helpers
+//============================================================
+void puzzles::SudokuBatchPipeline::solveStage(Ring& solveRing, Ring& writeRing, SudokuCancellationToken const& cancellation,
+                                              SudokuBatchStatistics& statistics) const
+{
+    SudokuPerfCounters const counters{};
+    while (true)
+    {
+        Batch* batch{ nullptr };
+        solveRing.pop(batch);
+        if (batch == nullptr)
+        {
+            writeRing.push(nullptr);
+            return;
+        }
+
+        // Check the givens, solve the puzzles that pass, then check the solutions
+        std::size_t const count{ batch->boxSizes.size() };
+        batch->solutions.resize(batch->values.size());
+        batch->statuses.assign(count, SudokuSolveStatus::Unsolvable);
+        batch->givenChecks.assign(count, SudokuValidity::Valid);
+        batch->solutionChecks.assign(count, SudokuValidity::Valid);
+        forEachRun(batch->boxSizes, [batch](std::size_t first, std::size_t runCount, std::size_t boxSize)
+        {
+            SudokuValidator::checkAllGivens(batch->values.data() + batch->offsets[first], runCount, boxSize,
+                                            batch->givenChecks.data() + first);
+        });
+        SudokuPerfSample const start{ counters.read() };
+        for (std::size_t index = 0; index != count; ++index)
+        {
+            std::size_t const boxSize{ batch->boxSizes[index] };
+            if (boxSize == 0 || batch->givenChecks[index] != SudokuValidity::Valid)
+                continue;
+
+            std::uint8_t const* const values{ batch->values.data() + batch->offsets[index] };
+            std::uint8_t* const solution{ batch->solutions.data() + batch->offsets[index] };
+            clock_type::time_point const deadline{ m_timeout.count() == 0 ? clock_type::time_point::max() : clock_type::now() + m_timeout };
+            SudokuRuntimeReport const report{ m_solver.solve(boxSize, values, solution, m_options, deadline, cancellation) };
+            statistics.solveTime += report.time;
+            batch->statuses[index] = report.status;
+        }
+        counters.addSince(start, statistics.counters);
+        forEachRun(batch->boxSizes, [batch](std::size_t first, std::size_t runCount, std::size_t boxSize)
+        {
+            std::size_t const offset{ batch->offsets[first] };
+            SudokuValidator::checkAllSolutions(batch->solutions.data() + offset, batch->values.data() + offset, runCount, boxSize,
+                                               batch->solutionChecks.data() + first);
+        });
+
+        for (std::size_t index = 0; index != count; ++index)
+        {
+            ++statistics.puzzles;
+            SudokuSolveStatus const status{ batch->statuses[index] };
+            if (batch->boxSizes[index] == 0 || batch->givenChecks[index] != SudokuValidity::Valid
+                || (status == SudokuSolveStatus::Solved && batch->solutionChecks[index] != SudokuValidity::Valid))
+            {
+                ++statistics.errors;
+                batch->output += batch->boxSizes[index] == 0 ? "error bad puzzle\n"
+                               : batch->givenChecks[index] != SudokuValidity::Valid ? "error conflicting givens\n"
+                               : "error invalid solution\n";
+                continue;
+            }
+
+            switch (status)
+            {
+            case SudokuSolveStatus::Solved:     ++statistics.solved; break;
+            case SudokuSolveStatus::Unsolvable: ++statistics.unsolvable; break;
+            case SudokuSolveStatus::TimedOut:   ++statistics.timedOut; break;
+            case SudokuSolveStatus::Cancelled:  ++statistics.cancelled; break;
+            }
+            batch->output += c_statusNames[static_cast<std::size_t>(status)];
+            SudokuPuzzleText::append(batch->solutions.data() + batch->offsets[index], batch->boxSizes[index], batch->output);
+            batch->output += '\n';
+        }
+        ++statistics.batches;
+        writeRing.push(batch);
+    }
+}
+
+// Write batches in sequence, holding early ones back. Only batchCount batches exist and the one
+// being waited for is one of them, so the sequences held back all fit in batchCount slots.
+void puzzles::SudokuBatchPipeline::writeStage(std::ostream& output, Ring& writeRing, Ring& freeRing, std::size_t batchCount,
+                                              SudokuBatchStatistics& statistics) const
+{
+    std::vector<Batch*> pending(batchCount, nullptr);
+    std::uint64_t next{ 0 };
+    std::size_t stoppedSolvers{ 0 };
+    while (stoppedSolvers != m_solverCount)
+    {
+        Batch* batch{ nullptr };
+        if (writeRing.pop(batch) != 0)
+            ++statistics.writerWaits;
+        if (batch == nullptr)
+        {
+            ++stoppedSolvers;
+            continue;
+        }
+
+        pending[batch->sequence % batchCount] = batch;
+        while (Batch* const ready = pending[next % batchCount])
+        {
+            output.write(ready->output.data(), static_cast<std::streamsize>(ready->output.size()));
+            pending[next % batchCount] = nullptr;
+            ++next;
+            freeRing.push(ready);
+        }
+    }
+    output.flush();
+}
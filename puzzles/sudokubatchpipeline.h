@@ -0,0 +1,132 @@
+#ifndef SUDOKUBATCHPIPELINE_H
+#define SUDOKUBATCHPIPELINE_H
+/*
+struct SudokuBatchStatistics
+====================================================================================================
+Totals from one SudokuBatchPipeline::run(). solveTime is summed over the solver threads, so it is
+more than wallTime when they overlap. readerWaits counts the times the reader had to wait for a free
+batch (the solvers or the writer were behind) and writerWaits the times the writer had to wait for
+a solved one. counters are the hardware counters of the solver threads while they solved, read
+once a batch through SudokuPerfCounters; counters.counted is 0 where they can't be read.
+
+class SudokuBatchPipeline
+====================================================================================================
+Solves a stream of puzzles, one per line in any form SudokuPuzzleText reads, writing one line per
+puzzle in the same order:
+    <status> <board>
+    error bad puzzle
+    error conflicting givens
+    error invalid solution
+where status is solved, unsolvable, timeout or cancelled and board is the solution, or as far as
+the solve got. Blank lines and lines starting with '#' are skipped. Each batch's puzzles are checked
+with SudokuValidator before they are solved, so puzzles with a value twice in a unit are turned
+away without a search, and its solutions are checked against their puzzles afterwards, so a board
+is only ever reported solved if it is one.
+
+The work is split into stages so reading and writing overlap with solving: the calling thread reads
+and parses lines into batches, the solver threads solve and format them, and a writer thread writes
+them out. Batches go between the stages through SudokuRingBuffer<Batch*> rings. Solvers finish
+batches out of order, so each carries a sequence number and the writer holds on to early ones until
+the gap is filled. A fixed number of batches is allocated up front and passed back to the reader
+once written, which bounds the memory in use and makes the reader wait when the later stages fall
+behind; their buffers are reused, so a run doesn't allocate once it is going.
+*/
+#include "sudokucancellation.h"
+#include "sudokuperfcounters.h"
+#include "sudokuringbuffer.h"
+#include "sudokuruntimesolver.h"
+#include "sudokusolver.h"
+#include "sudokuvalidator.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace puzzles
+{
+
+struct SudokuBatchStatistics
+{
+    std::size_t puzzles;
+    std::size_t solved;
+    std::size_t unsolvable;
+    std::size_t timedOut;
+    std::size_t cancelled;
+    std::size_t errors;
+    std::size_t batches;
+    std::size_t readerWaits;
+    std::size_t writerWaits;
+    std::chrono::nanoseconds solveTime;
+    std::chrono::nanoseconds wallTime;
+    SudokuPerfSample counters;
+};
+
+class SudokuBatchPipeline
+{
+public:
+    // Special 6
+    //============================================================
+    // solverCount 0 means one per hardware thread, less the reader and writer
+    explicit SudokuBatchPipeline(std::size_t solverCount = 0);
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // Read puzzles from input until it ends or the token is cancelled, writing results to output
+    SudokuBatchStatistics run(std::istream& input, std::ostream& output,
+                              SudokuCancellationToken const& cancellation = SudokuCancellationToken{});
+
+    std::size_t solverCount() const;
+
+    // Puzzles per batch, default 64
+    void setBatchSize(std::size_t batchSize);
+    // Batches allocated for the run, default four per solver
+    void setBatchesInFlight(std::size_t batches);
+    void setOptions(SudokuSolveOptions const& options);
+    // Time allowed for each puzzle, from when its solve starts; 0, the default, for no limit
+    void setTimeout(std::chrono::milliseconds timeout);
+    void setCacheLimit(std::size_t boxSize);
+
+private:
+    // Typedefs
+    //============================================================
+    using clock_type = SudokuCancellationToken::clock_type;
+
+    struct Batch
+    {
+        std::uint64_t sequence;
+        std::vector<std::size_t> boxSizes;      // per puzzle, 0 if the line wasn't a puzzle
+        std::vector<std::size_t> offsets;       // per puzzle, where its values start
+        std::vector<std::uint8_t> values;
+        std::vector<std::uint8_t> solutions;    // laid out as values
+        std::vector<SudokuSolveStatus> statuses;
+        std::vector<SudokuValidity> givenChecks;
+        std::vector<SudokuValidity> solutionChecks;
+        std::string output;
+    };
+
+    using Ring = SudokuRingBuffer<Batch*>;
+
+    // Helpers
+    //============================================================
+    void solveStage(Ring& solveRing, Ring& writeRing, SudokuCancellationToken const& cancellation,
+                    SudokuBatchStatistics& statistics) const;
+    void writeStage(std::ostream& output, Ring& writeRing, Ring& freeRing, std::size_t batchCount,
+                    SudokuBatchStatistics& statistics) const;
+
+    // Data Members
+    //============================================================
+    std::size_t m_solverCount;
+    std::size_t m_batchSize;
+    std::size_t m_batchesInFlight;
+    SudokuSolveOptions m_options;
+    std::chrono::milliseconds m_timeout;
+    SudokuRuntimeSolver m_solver;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUBATCHPIPELINE_H
@@ -0,0 +1,219 @@
+#include "sudokubenchmark.h"
+
+#include "sudokubandboard.h"
+#include "sudokuboard.h"
+#include "sudokupuzzletext.h"
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace
+{
+    using clock_type = puzzles::SudokuCancellationToken::clock_type;
+
+    char const* const c_phaseNames[3]{ "setup    ", "propagate", "search   " };
+
+    // Where a phase starts: the time and the counters
+    struct Mark
+    {
+        clock_type::time_point time;
+        puzzles::SudokuPerfSample counters;
+    };
+
+    Mark mark(puzzles::SudokuPerfCounters const& counters)
+    {
+        return Mark{ clock_type::now(), counters.read() };
+    }
+
+    // Add the phase from start until now to the class's totals for it
+    void endPhase(Mark const& start, puzzles::SudokuPerfCounters const& counters, puzzles::SudokuBenchmark::ClassTotals& totals,
+                  std::size_t phase)
+    {
+        counters.addSince(start.counters, totals.counters[phase]);
+        totals.times[phase] += clock_type::now() - start.time;
+    }
+
+    // The phases on SudokuBoard<N>, whose propagation the Propagation, SAT and local search engines
+    // all start from. Returns whether the puzzle was solved.
+    template <std::size_t N>
+    bool boardPhases(std::uint8_t const* values, puzzles::SudokuEngine engine, puzzles::SudokuPerfCounters const& counters,
+                     puzzles::SudokuBenchmark::ClassTotals& totals, puzzles::SudokuCancellationToken const& cancellation)
+    {
+        Mark start{ mark(counters) };
+        puzzles::SudokuBoard<N> board{};
+        for (std::size_t tile = 0; tile != N*N*N*N; ++tile)
+        {
+            if (values[tile] != 0)
+                board.setTileSolution(tile / (N*N), tile % (N*N), values[tile]);
+        }
+        endPhase(start, counters, totals, 0);
+
+        start = mark(counters);
+        board.propagateAll(cancellation);
+        endPhase(start, counters, totals, 1);
+
+        start = mark(counters);
+        puzzles::SudokuSolver<N>{ puzzles::SudokuSolveOptions{ engine, 0 } }.solve(board, cancellation);
+        endPhase(start, counters, totals, 2);
+        return board.isSolved();
+    }
+
+    // The phases as each engine runs them
+    template <std::size_t N>
+    bool enginePhases(std::uint8_t const* values, puzzles::SudokuEngine engine, puzzles::SudokuPerfCounters const& counters,
+                      puzzles::SudokuBenchmark::ClassTotals& totals, puzzles::SudokuCancellationToken const& cancellation)
+    {
+        return boardPhases<N>(values, engine, counters, totals, cancellation);
+    }
+
+    // The bitboard engine builds and propagates a SudokuBandBoard of its own instead
+    template <>
+    bool enginePhases<3>(std::uint8_t const* values, puzzles::SudokuEngine engine, puzzles::SudokuPerfCounters const& counters,
+                         puzzles::SudokuBenchmark::ClassTotals& totals, puzzles::SudokuCancellationToken const& cancellation)
+    {
+        if (engine != puzzles::SudokuEngine::Bitboard)
+            return boardPhases<3>(values, engine, counters, totals, cancellation);
+
+        Mark start{ mark(counters) };
+        std::array<std::size_t, 81> tileValues{};
+        std::copy(values, values + tileValues.size(), tileValues.begin());
+        puzzles::SudokuBandBoard bands{ tileValues };
+        endPhase(start, counters, totals, 0);
+
+        start = mark(counters);
+        bands.propagateAll();
+        endPhase(start, counters, totals, 1);
+
+        start = mark(counters);
+        bands.solveAll(cancellation);
+        endPhase(start, counters, totals, 2);
+        return bands.isSolved();
+    }
+
+    void writePhase(std::ostream& output, char const* name, std::chrono::nanoseconds time, puzzles::SudokuPerfSample const& counters,
+                    std::size_t puzzles)
+    {
+        double const divisor{ static_cast<double>(std::max<std::size_t>(1, puzzles)) };
+        output << "    " << name << " wall_us=" << std::fixed << std::setprecision(2)
+               << std::chrono::duration<double, std::micro>(time).count() / divisor;
+        if (counters.counted != 0)
+            output << ' ' << puzzles::SudokuPerfCounters::format(counters, puzzles);
+        output << '\n';
+    }
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuBenchmark::SudokuBenchmark() :
+    m_engines{ SudokuEngine::Automatic },
+    m_timeout{ 0 },
+    m_totals{}
+{}
+
+// Interface
+//============================================================
+std::size_t puzzles::SudokuBenchmark::run(std::istream& input, std::ostream& output, SudokuCancellationToken const& cancellation)
+{
+    m_totals.clear();
+    SudokuPerfCounters const counters{};
+    std::size_t badLines{ 0 };
+    std::string line{};
+    std::vector<std::uint8_t> values{};
+    while (!cancellation.shouldStop() && std::getline(input, line))
+    {
+        std::size_t first{ 0 };
+        std::size_t length{ 0 };
+        if (!SudokuPuzzleText::findPuzzle(line.data(), line.size(), first, length))
+            continue;
+        std::size_t boxSize{ 0 };
+        if (!SudokuPuzzleText::parse(line.data() + first, length, values, boxSize))
+        {
+            ++badLines;
+            continue;
+        }
+
+        switch (boxSize)
+        {
+        case 2: measure<2>(values.data(), counters, cancellation); break;
+        case 3: measure<3>(values.data(), counters, cancellation); break;
+        case 4: measure<4>(values.data(), counters, cancellation); break;
+        case 5: measure<5>(values.data(), counters, cancellation); break;
+        case 6: measure<6>(values.data(), counters, cancellation); break;
+        case 7: measure<7>(values.data(), counters, cancellation); break;
+        case 8: measure<8>(values.data(), counters, cancellation); break;
+        default: ++badLines; break;
+        }
+    }
+
+    report(output, counters);
+    return badLines;
+}
+
+void puzzles::SudokuBenchmark::setEngines(std::vector<SudokuEngine> const& engines)
+{
+    m_engines = engines;
+}
+
+void puzzles::SudokuBenchmark::setTimeout(std::chrono::milliseconds timeout)
+{
+    m_timeout = timeout;
+}
+
+std::map<std::pair<std::size_t, puzzles::SudokuEngine>, puzzles::SudokuBenchmark::ClassTotals> const& puzzles::SudokuBenchmark::totals() const
+{
+    return m_totals;
+}
+
+// Helpers
+//============================================================
+template <std::size_t N>
+void puzzles::SudokuBenchmark::measure(std::uint8_t const* values, SudokuPerfCounters const& counters,
+                                       SudokuCancellationToken const& cancellation)
+{
+    for (std::size_t index = 0; index != m_engines.size(); ++index)
+    {
+        SudokuEngine const engine{ SudokuSolver<N>::chooseEngine(m_engines[index]) };
+        bool const repeated{ std::any_of(m_engines.cbegin(), m_engines.cbegin() + static_cast<std::ptrdiff_t>(index),
+                                         [engine](SudokuEngine other) { return SudokuSolver<N>::chooseEngine(other) == engine; }) };
+        if (repeated)
+            continue;
+
+        ClassTotals& totals = m_totals.emplace(std::make_pair(N, engine), ClassTotals{}).first->second;
+        SudokuCancellationToken const bounded{ m_timeout.count() == 0 ? SudokuCancellationToken::linkedTo(cancellation)
+                                               : SudokuCancellationToken::linkedTo(cancellation, clock_type::now() + m_timeout) };
+
+        ++totals.puzzles;
+        if (enginePhases<N>(values, engine, counters, totals, bounded))
+            ++totals.solved;
+    }
+}
+
+void puzzles::SudokuBenchmark::report(std::ostream& output, SudokuPerfCounters const& counters) const
+{
+    if (!counters.isAvailable())
+        output << "hardware counters unavailable: " << counters.errorString() << '\n';
+    else if (!counters.errorString().empty())
+        output << "some hardware counters unavailable: " << counters.errorString() << '\n';
+
+    for (auto const& entry : m_totals)
+    {
+        std::size_t const size{ entry.first.first * entry.first.first };
+        ClassTotals const& totals = entry.second;
+        std::chrono::nanoseconds const time{ totals.times[0] + totals.times[1] + totals.times[2] };
+        SudokuPerfSample sum{};
+        for (auto const& phase : totals.counters)
+            SudokuPerfCounters::add(sum, phase);
+
+        output << size << 'x' << size << ' ' << SudokuSolver<3>::name(entry.first.second) << ": " << totals.puzzles
+               << " puzzles, " << totals.solved << " solved, " << std::fixed << std::setprecision(2)
+               << std::chrono::duration<double, std::micro>(time).count() / static_cast<double>(std::max<std::size_t>(1, totals.puzzles))
+               << " us each\n";
+        for (std::size_t phase = 0; phase != 3; ++phase)
+            writePhase(output, c_phaseNames[phase], totals.times[phase], totals.counters[phase], totals.puzzles);
+        writePhase(output, "total    ", time, sum, totals.puzzles);
+    }
+}
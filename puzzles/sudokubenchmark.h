@@ -0,0 +1,94 @@
+#ifndef SUDOKUBENCHMARK_H
+#define SUDOKUBENCHMARK_H
+/*
+class SudokuBenchmark
+====================================================================================================
+Solves a corpus one puzzle at a time on the calling thread with each of a set of engines, and
+reports where the time goes. Puzzles are grouped into classes by box size and the engine that
+solved them, and every solve is split into three phases:
+- setup:        building the engine's board from the givens,
+- propagate:    the engine's own propagation,
+- search:       the engine's solve() from the propagated board.
+The Propagation, SAT and local search engines all start from SudokuBoard<N>::propagateAll(), so
+their first two phases are the same work. Bitboard builds and propagates a SudokuBandBoard instead.
+Each phase gets its wall time and its hardware counters (SudokuPerfCounters) around it, so a
+class's report has the time, cycles, instructions, IPC, cache misses and branch misses per puzzle
+of each phase next to each other, and engines can be compared on any of them. Where the counters
+can't be read the report says why and gives the times alone.
+
+The report is one block per class:
+    <size> <engine>: <n> puzzles, <n> solved, <us> us each
+        setup     wall_us=<x> cycles=<n> instructions=<n> ipc=<x> cache_misses=<n> branch_misses=<n>
+        propagate ...
+        search    ...
+        total     ...
+Nothing is cached, so repeated puzzles are solved again.
+*/
+#include "sudokucancellation.h"
+#include "sudokuperfcounters.h"
+#include "sudokusolver.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace puzzles
+{
+
+class SudokuBenchmark
+{
+public:
+    // Typedefs
+    //============================================================
+    // A class's totals: per phase, the wall time and the counters
+    struct ClassTotals
+    {
+        std::size_t puzzles;
+        std::size_t solved;
+        std::chrono::nanoseconds times[3];
+        SudokuPerfSample counters[3];
+    };
+
+    // Special 6
+    //============================================================
+    SudokuBenchmark();
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // Solve every puzzle read from input with every engine, then write the report to output.
+    // Returns the number of lines that weren't puzzles.
+    std::size_t run(std::istream& input, std::ostream& output,
+                    SudokuCancellationToken const& cancellation = SudokuCancellationToken{});
+
+    // The engines to compare, default just Automatic. An engine that runs as another for some
+    // box size (Bitboard other than 9x9) is skipped for that size if the other is in the set too.
+    void setEngines(std::vector<SudokuEngine> const& engines);
+    // Time allowed for each solve; 0, the default, for no limit
+    void setTimeout(std::chrono::milliseconds timeout);
+
+    // The totals from the last run, by box size and the engine that ran
+    std::map<std::pair<std::size_t, SudokuEngine>, ClassTotals> const& totals() const;
+
+private:
+    // Helpers
+    //============================================================
+    template <std::size_t N>
+    void measure(std::uint8_t const* values, SudokuPerfCounters const& counters, SudokuCancellationToken const& cancellation);
+
+    void report(std::ostream& output, SudokuPerfCounters const& counters) const;
+
+    // Data Members
+    //============================================================
+    std::vector<SudokuEngine> m_engines;
+    std::chrono::milliseconds m_timeout;
+    std::map<std::pair<std::size_t, SudokuEngine>, ClassTotals> m_totals;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUBENCHMARK_H
@@ -0,0 +1,86 @@
+#ifndef SUDOKUBITS_H
+#define SUDOKUBITS_H
+/*
+struct SudokuMask<N>
+====================================================================================================
+Picks the smallest unsigned integer that can hold one bit per value for a tile that can be 1 to N,
+so a 9x9 board uses 16 bit masks and a 16x16 board does too. Bit (value - 1) is set if the tile
+can be value.
+
+Bit helpers
+====================================================================================================
+Counting bits and finding the lowest set bit, using the compiler intrinsics where there are some.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace puzzles
+{
+
+template <std::size_t N>
+struct SudokuMask
+{
+    static_assert(N <= 64, "SudokuMask cannot hold more than 64 values.");
+
+    using type = typename std::conditional<(N <= 16), std::uint16_t,
+                 typename std::conditional<(N <= 32), std::uint32_t, std::uint64_t>::type>::type;
+
+    // Every value 1 to N
+    static type full()
+    {
+        return static_cast<type>(N == 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << N) - 1);
+    }
+
+    // Just this value
+    static type bit(std::size_t value)
+    {
+        return static_cast<type>(std::uint64_t{ 1 } << (value - 1));
+    }
+};
+
+// How many bits are set?
+inline std::size_t popCount(std::uint64_t mask)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<std::size_t>(__popcnt64(mask));
+#elif defined(__GNUC__)
+    return static_cast<std::size_t>(__builtin_popcountll(mask));
+#else
+    std::size_t count{ 0 };
+    for (; mask != 0; mask &= mask - 1)
+        ++count;
+    return count;
+#endif
+}
+
+// Index of the lowest set bit, mask must not be 0
+inline std::size_t lowestBitIndex(std::uint64_t mask)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index{ 0 };
+    _BitScanForward64(&index, mask);
+    return static_cast<std::size_t>(index);
+#elif defined(__GNUC__)
+    return static_cast<std::size_t>(__builtin_ctzll(mask));
+#else
+    std::size_t index{ 0 };
+    for (; (mask & 1) == 0; mask >>= 1)
+        ++index;
+    return index;
+#endif
+}
+
+// Is exactly one bit set?
+inline bool isSingleBit(std::uint64_t mask)
+{
+    return mask != 0 && (mask & (mask - 1)) == 0;
+}
+
+} // namespace puzzles
+
+#endif // SUDOKUBITS_H
@@ -5,11 +5,42 @@ class SudokuBoard<N>
 ====================================================================================================
 Where N*N is the maximum number that can appear in the puzzle. This is mostly so that we don't have
 to square root the templated number to check it makes sense.
+
+Alongside the tiles the board keeps a used-digit mask for every unit, updated whenever a tile
+becomes solved or stops being solved. A tile's candidates are then its own mask less the masks of
+its units, so checking or placing a digit is a handful of bit operations and propagation is a sweep
+over the masks rather than a loop over each unit per solved tile.
+
+Which tiles make up the units comes from a shared SudokuUnitTable<N>: classic rows, columns and
+squares unless setUnitTable() gives the board another, such as jigsaw regions, the diagonals of
+Sudoku X or windoku's extra boxes. Propagation, the singles and the subset strategies go through
+the table's unit and peer lists, so every variant gets the same propagation and search. The
+intersection strategies use the squares' geometry on a classic table and the table's list of unit
+intersections otherwise. Units are numbered as in the table: rows, columns, regions, extras.
+
+Changes to tiles can be undone: checkpoint() starts recording, and every tile mask that changes
+after it is written to a trail once, before its first change. rollback() puts those masks back, so
+undoing a guess costs time proportional to what the guess changed rather than copying the board.
+solveAll() uses this to search when propagation alone can't finish the puzzle. It can be given a
+SudokuCancellationToken, checked on every propagation pass and before every guess.
+
+Once the basic eliminations and singles stall, propagation runs the board's SudokuStrategyPipeline:
+naked and hidden subsets, pointing pairs and box/line reduction, in the pipeline's order and only
+those enabled, going back to the basic eliminations as soon as one removes a candidate.
 */
 #include "sudokutile.h"
 #include "sudokutileposition.h"
-#include <iosfwd>
-#include <map>
+#include "sudokucancellation.h"
+#include "sudokusearchstatistics.h"
+#include "sudokustrategypipeline.h"
+#include "sudokuunittable.h"
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
 
 namespace puzzles
 {
@@ -18,8 +49,14 @@ template <std::size_t N>
 class SudokuBoard
 {
     static_assert(N >= 2, "SudokuBoard cannot be instantiated with a template value less than 2.");
+    static_assert(N*N <= 64, "SudokuBoard cannot be instantiated with a template value greater than 8.");
 
 public:
+    // Typedefs
+    //============================================================
+    using mask_type = typename SudokuTile<N*N>::canbe_type;
+    using unit_table = SudokuUnitTable<N>;
+
     // Special 6
     //============================================================
     // SudokuTile has a default constuctor so the arrays should auto-initialise to empty correctly...
@@ -31,14 +68,12 @@ public:
         for (std::size_t index = 0, end = tileValuesArray.size(); index != end; ++index)
         {
             // Set the solution for the corresponding tile
-            m_tileMatrix[index / maxNumber()][index % maxNumber()].setSolution(tileValuesArray[index]);
+            setTileSolution(index / maxNumber(), index % maxNumber(), tileValuesArray[index]);
         }
     }
     SudokuBoard(std::vector<std::size_t> const& tileValuesVector) :
         m_tileMatrix{}
     {
-        //
-
         // For each value in the vector
         // if the vector is as long as or longer than N^4, use N^4, otherwise use its size
         for (std::size_t index = 0,
@@ -46,7 +81,7 @@ public:
             index != end; ++index)
         {
             // Set the solution for the corresponding tile
-            m_tileMatrix[index / maxNumber()][index % maxNumber()].setSolution(tileValuesArray[index]);
+            setTileSolution(index / maxNumber(), index % maxNumber(), tileValuesVector[index]);
         }
     }
 
@@ -73,7 +108,11 @@ public:
     void setTileSolution(std::size_t xPosition, std::size_t yPosition, std::size_t value)
     {
         if (isValidValue(value))
-            m_tileMatrix[xPosition][yPosition].setSolution(value);
+        {
+            tile_type tile{};
+            tile.setSolution(value);
+            setTileMask(xPosition, yPosition, tile.mask());
+        }
     }
     // This tile is this value.
     void setTileSolution(SudokuTilePosition postition, std::size_t value)
@@ -91,73 +130,246 @@ public:
         return getTileSolution(postition.x, postition.y);
     }
 
-    // Is the board solved?
-    bool isSolved() const
+    // Get the solutions for every tile in the same order the array constructor takes them, with 0
+    // for tiles that aren't solved
+    std::array<std::size_t, N*N*N*N> getTileSolutions() const
     {
-        // for each row on the board (starting at the top)
-        for (std::size_t xPostition = 0; xPostition != maxNumber(); ++xPostition)
+        std::array<std::size_t, N*N*N*N> result{};
+        for (std::size_t index = 0, end = result.size(); index != end; ++index)
+            result[index] = m_tileMatrix[index / maxNumber()][index % maxNumber()].solution();
+        return result;
+    }
+
+    // Digits already solved in a row, column, square (the tile's region, on a jigsaw board) or any
+    // unit
+    mask_type usedInRow(std::size_t xPosition) const                            { return m_unitMasks[rowUnit(xPosition)]; }
+    mask_type usedInColumn(std::size_t yPosition) const                         { return m_unitMasks[columnUnit(yPosition)]; }
+    mask_type usedInSquare(std::size_t xPosition, std::size_t yPosition) const  { return m_unitMasks[squareUnit(xPosition, yPosition)]; }
+    mask_type usedInUnit(std::size_t unit) const                                { return m_unitMasks[unit]; }
+
+    // The values a tile could be: its own mask, less anything solved elsewhere in its units. A
+    // solved tile just gives its solution.
+    mask_type getTileCandidates(std::size_t xPosition, std::size_t yPosition) const
+    {
+        tile_type const& tile = m_tileMatrix[xPosition][yPosition];
+        if (tile.isSolved())
+            return tile.mask();
+        return static_cast<mask_type>(tile.mask() & ~usedAround(xPosition * maxNumber() + yPosition));
+    }
+
+    // Can this unsolved tile be this value without clashing with a solved tile?
+    bool canPlace(std::size_t xPosition, std::size_t yPosition, std::size_t value) const
+    {
+        return value != 0 && isValidValue(value) && !m_tileMatrix[xPosition][yPosition].isSolved()
+            && (getTileCandidates(xPosition, yPosition) & tile_mask::bit(value)) != 0;
+    }
+
+    // Is this tile solved as a value that another tile in one of its units is also solved as? Free
+    // on a board without conflicts, otherwise a scan of the tile's peers.
+    bool isTileConflicting(std::size_t xPosition, std::size_t yPosition) const
+    {
+        mask_type const mask{ m_tileMatrix[xPosition][yPosition].mask() };
+        if (m_conflicts == 0 || !isSingleBit(mask))
+            return false;
+
+        std::size_t const tile{ xPosition * maxNumber() + yPosition };
+        std::uint16_t const* const peers = m_units->peers(tile);
+        for (std::size_t index = 0, end = m_units->peerCount(tile); index != end; ++index)
         {
-            // for each column in that row (starting on the left)
-            for (std::size_t yPosition = 0; yPosition != maxNumber(); ++yPosition)
-            {
-                // If a tile that isn't solved is found, then the board isn't solved, return false
-                if (!m_tileMatrix[xPostition][yPosition].isSolved())
-                    return false;
-            }
+            if (m_tileMatrix[peers[index] / maxNumber()][peers[index] % maxNumber()].mask() == mask)
+                return true;
         }
-        // All tiles were checked and solved, so the board is solved, return true
+        return false;
+    }
+
+    // Solve this tile as this value if that doesn't clash, returning whether it did
+    bool placeTileSolution(std::size_t xPosition, std::size_t yPosition, std::size_t value)
+    {
+        if (!canPlace(xPosition, yPosition, value))
+            return false;
+        setTileMask(xPosition, yPosition, tile_mask::bit(value));
         return true;
     }
 
-    // Solve the puzzle.
-    void solveAll()
+    // This tile cannot be any of these values. Returns how many values were removed.
+    std::size_t eliminateTileCandidates(std::size_t xPosition, std::size_t yPosition, mask_type values)
     {
-        // get list of newlySolved
-        std::vector<SudokuTilePosition> newlySolved{};
-        // for each row on the board (starting at the top)
-        for (std::size_t xPostition = 0; xPostition != maxNumber(); ++xPostition)
+        mask_type const mask{ m_tileMatrix[xPosition][yPosition].mask() };
+        mask_type const removed{ static_cast<mask_type>(mask & values) };
+        if (removed == 0)
+            return 0;
+        setTileMask(xPosition, yPosition, static_cast<mask_type>(mask & ~values));
+        return popCount(removed);
+    }
+
+    // The strategies propagation runs once the basics stall, and their statistics
+    SudokuStrategyPipeline const& strategyPipeline() const
+    {
+        return m_strategyPipeline;
+    }
+    SudokuStrategyPipeline& strategyPipeline()
+    {
+        return m_strategyPipeline;
+    }
+    void setStrategyPipeline(SudokuStrategyPipeline const& pipeline)
+    {
+        m_strategyPipeline = pipeline;
+    }
+
+    // The units this board is played with, classic unless set otherwise
+    unit_table const& unitTable() const
+    {
+        return *m_units;
+    }
+    std::shared_ptr<unit_table const> const& sharedUnitTable() const
+    {
+        return m_units;
+    }
+    // Play the board with these units. The tiles stay as they are and the unit masks and conflicts
+    // are worked out again for the new units. Open checkpoints are closed, keeping their changes.
+    void setUnitTable(std::shared_ptr<unit_table const> const& table)
+    {
+        m_units = table ? table : unit_table::classic();
+        m_classicUnits = m_units->isClassic();
+        m_checkpoints.clear();
+        m_trail.clear();
+        nextTrailStamp();
+
+        m_unitMasks.fill(0);
+        m_conflicts = 0;
+        for (std::size_t tile = 0; tile != N*N*N*N; ++tile)
         {
-            // for each column in that row (starting on the left)
-            for (std::size_t yPosition = 0; yPosition != maxNumber(); ++yPosition)
-            {
-                if (m_tileMatrix[xPostition][yPosition].isSolved())
-                    newlySolved.push_back(makeTilePosition(xPostition, yPosition));
-            }
+            mask_type const mask{ m_tileMatrix[tile / maxNumber()][tile % maxNumber()].mask() };
+            if (!isSingleBit(mask))
+                continue;
+            std::uint16_t const* const units = m_units->tileUnits(tile);
+            for (std::size_t index = 0, end = m_units->tileUnitCount(tile); index != end; ++index)
+                addToUnit(units[index], mask);
         }
-        // the loop counter is there to stop the loop if it manages to get stuck
-        std::size_t loop{ 0 };
-        while (!(isSolved() || newlySolved.empty() || loop >100))
-        {
-            ++loop;
-            // Copy the last batch of solved tiles and clear the container to store ones
-            // that will be stored this loop.
-            std::vector<SudokuTilePosition> toCheck{ newlySolved };
-            newlySolved.clear();
+    }
 
-            for (auto tile : toCheck)
-            {
-                std::vector<SudokuTilePosition> solved{};
-                // For each solving function, capture the list of tiles solved and add them
-                // to newSolved.
-                solved = resolve_row(tile);
-                newlySolved.insert(newlySolved.end(), solved.begin(), solved.end());
-                solved = resolve_column(tile);
-                newlySolved.insert(newlySolved.end(), solved.begin(), solved.end());
-                solved = resolve_square(tile);
-                newlySolved.insert(newlySolved.end(), solved.begin(), solved.end());
-                solved = check_singular(tile);
-                newlySolved.insert(newlySolved.end(), solved.begin(), solved.end());
-            }
-        }
+    // Is the board solved?
+    bool isSolved() const
+    {
+        return m_solvedTiles == N*N*N*N && isConsistent();
+    }
+
+    // Does every tile have a candidate and no unit contain a solution twice?
+    bool isConsistent() const
+    {
+        return m_conflicts == 0 && m_emptyTiles == 0;
+    }
+
+    // Solve the puzzle. Propagation goes as far as it can, then tiles are guessed and the guesses
+    // undone through the trail until the board is solved or shown to have no solution.
+    void solveAll()
+    {
+        m_searchStatistics = SudokuSearchStatistics{};
+        m_searchRandom = m_searchSeed;
+        if (propagate() && !isSolved())
+            search(1);
+    }
+
+    // Solve the puzzle, stopping early if the token is cancelled. A cancelled solve leaves the
+    // board partly propagated with any guesses undone.
+    void solveAll(SudokuCancellationToken const& cancellation)
+    {
+        m_cancellation = &cancellation;
+        solveAll();
+        m_cancellation = nullptr;
+    }
+
+    // With a seed of 0 guesses are tried lowest value first. Any other seed tries them in a
+    // pseudo-random order, so boards with different seeds search differently.
+    void setSearchSeed(std::uint64_t seed)
+    {
+        m_searchSeed = seed;
+    }
+    std::uint64_t searchSeed() const
+    {
+        return m_searchSeed;
+    }
+
+    // Only propagate: solve what can be solved without guessing. Returns false if the board has
+    // been shown to have no solution.
+    bool propagateAll()
+    {
+        return propagate();
+    }
+    // Also returns false if the token is cancelled before propagation finishes
+    bool propagateAll(SudokuCancellationToken const& cancellation)
+    {
+        m_cancellation = &cancellation;
+        bool const result{ propagate() };
+        m_cancellation = nullptr;
+        return result;
+    }
+
+    // Counters from the last solveAll()
+    SudokuSearchStatistics const& searchStatistics() const
+    {
+        return m_searchStatistics;
     }
 
     void clearAll()
     {
         for (std::size_t xPostition = 0; xPostition != maxNumber(); ++xPostition)
             for (std::size_t yPosition = 0; yPosition != maxNumber(); ++yPosition)
-                m_tileMatrix[xPostition][yPosition].clear();
+                setTileMask(xPostition, yPosition, tile_mask::full());
+    }
+
+    // Undo
+    //============================================================
+    // Start recording changes so they can be undone. Checkpoints nest; returns how many are open.
+    std::size_t checkpoint()
+    {
+        m_checkpoints.push_back(m_trail.size());
+        nextTrailStamp();
+        return m_checkpoints.size();
+    }
+
+    // Undo every change made since the last checkpoint and close it.
+    void rollback()
+    {
+        if (m_checkpoints.empty())
+            return;
+
+        // restore newest first so a tile ends up with the mask it had at the checkpoint
+        std::size_t const mark{ m_checkpoints.back() };
+        m_checkpoints.pop_back();
+        while (m_trail.size() != mark)
+        {
+            TrailEntry const& entry = m_trail.back();
+            writeTileMask(entry.tile / maxNumber(), entry.tile % maxNumber(), entry.mask);
+            m_trail.pop_back();
+        }
+        nextTrailStamp();
+    }
+
+    // Keep the changes made since the last checkpoint and close it. They can still be undone by
+    // rolling back an enclosing checkpoint.
+    void commit()
+    {
+        if (m_checkpoints.empty())
+            return;
+
+        m_checkpoints.pop_back();
+        if (m_checkpoints.empty())
+            m_trail.clear();
+        nextTrailStamp();
     }
 
+    // How many checkpoints are open?
+    std::size_t checkpointDepth() const
+    {
+        return m_checkpoints.size();
+    }
+
+    // How many tile masks are waiting to be restored?
+    std::size_t trailSize() const
+    {
+        return m_trail.size();
+    }
 
     std::ostream& print(std::ostream& os)
     {
@@ -221,7 +433,7 @@ public:
             {
                 std::size_t tileSolution{ 0 };
                 is >> tileSolution;
-                m_tileMatrix[xPostition][yPosition].setSolution(tileSolution);
+                setTileSolution(xPostition, yPosition, tileSolution);
             }
         }
         return is;
@@ -229,8 +441,16 @@ public:
 
 private:
     using tile_type = SudokuTile<N*N>;
+    using tile_mask = SudokuMask<N*N>;
     using tile_matrix = std::array<std::array<tile_type, N*N>, N*N>;
 
+    // A tile's mask before the first change made to it since the last checkpoint
+    struct TrailEntry
+    {
+        std::size_t tile;
+        mask_type mask;
+    };
+
     // Helpers
     //============================================================
 
@@ -239,6 +459,247 @@ private:
         return SudokuTilePosition{ xPosition, yPosition };
     }
 
+    // Unit numbers: rows, then columns, then regions, then any extra units
+    static std::size_t rowUnit(std::size_t xPosition)                           { return xPosition; }
+    static std::size_t columnUnit(std::size_t yPosition)                        { return N*N + yPosition; }
+    std::size_t squareUnit(std::size_t xPosition, std::size_t yPosition) const  { return m_units->regionUnit(xPosition * maxNumber() + yPosition); }
+
+    // Position of the index-th tile in a unit
+    SudokuTilePosition unitTilePosition(std::size_t unit, std::size_t index) const
+    {
+        std::size_t const tile{ m_units->unitTiles(unit)[index] };
+        return makeTilePosition(tile / maxNumber(), tile % maxNumber());
+    }
+
+    // The units of a tile. A classic table's lists are worked out here rather than read from the
+    // table, which keeps the hottest loops free of its loads.
+    std::size_t tileUnits(std::size_t tile, std::size_t (&units)[unit_table::c_maxTileUnits]) const
+    {
+        if (m_classicUnits)
+        {
+            std::size_t const xPosition{ tile / maxNumber() };
+            std::size_t const yPosition{ tile % maxNumber() };
+            units[0] = rowUnit(xPosition);
+            units[1] = columnUnit(yPosition);
+            units[2] = 2*N*N + xPosition / N * N + yPosition / N;
+            return 3;
+        }
+        std::uint16_t const* const tableUnits = m_units->tileUnits(tile);
+        std::size_t const count{ m_units->tileUnitCount(tile) };
+        for (std::size_t index = 0; index != count; ++index)
+            units[index] = tableUnits[index];
+        return count;
+    }
+
+    // Everything solved in a tile's units
+    mask_type usedAround(std::size_t tile) const
+    {
+        if (m_classicUnits)
+        {
+            std::size_t const xPosition{ tile / maxNumber() };
+            std::size_t const yPosition{ tile % maxNumber() };
+            return static_cast<mask_type>(m_unitMasks[rowUnit(xPosition)] | m_unitMasks[columnUnit(yPosition)]
+                                        | m_unitMasks[2*N*N + xPosition / N * N + yPosition / N]);
+        }
+        std::uint16_t const* const units = m_units->tileUnits(tile);
+        std::size_t const count{ m_units->tileUnitCount(tile) };
+        mask_type used{ 0 };
+        for (std::size_t index = 0; index != count; ++index)
+            used |= m_unitMasks[units[index]];
+        return used;
+    }
+
+    // Every change to a tile goes through here so it can be undone
+    void setTileMask(std::size_t xPosition, std::size_t yPosition, mask_type mask)
+    {
+        tile_type const& tile = m_tileMatrix[xPosition][yPosition];
+        if (tile.mask() == mask)
+            return;
+
+        // record the old mask if this tile hasn't been recorded since the last checkpoint
+        if (!m_checkpoints.empty())
+        {
+            std::size_t const index{ xPosition * maxNumber() + yPosition };
+            if (m_trailStamps[index] != m_trailStamp)
+            {
+                m_trailStamps[index] = m_trailStamp;
+                m_trail.push_back(TrailEntry{ index, tile.mask() });
+            }
+        }
+        writeTileMask(xPosition, yPosition, mask);
+    }
+
+    // Change a tile and keep the unit masks and counts in step with it
+    void writeTileMask(std::size_t xPosition, std::size_t yPosition, mask_type mask)
+    {
+        tile_type& tile = m_tileMatrix[xPosition][yPosition];
+        mask_type const oldMask{ tile.mask() };
+        bool const wasSolved{ isSingleBit(oldMask) };
+        bool const isNowSolved{ isSingleBit(mask) };
+
+        tile.setMask(mask);
+
+        if (oldMask == 0)
+            --m_emptyTiles;
+        if (mask == 0)
+            ++m_emptyTiles;
+
+        std::size_t const index{ xPosition * maxNumber() + yPosition };
+        std::size_t units[unit_table::c_maxTileUnits];
+        std::size_t const unitCount{ tileUnits(index, units) };
+        if (wasSolved && (!isNowSolved || oldMask != mask))
+        {
+            --m_solvedTiles;
+            for (std::size_t unit = 0; unit != unitCount; ++unit)
+                removeFromUnit(units[unit], oldMask, index);
+        }
+        if (isNowSolved && (!wasSolved || oldMask != mask))
+        {
+            ++m_solvedTiles;
+            for (std::size_t unit = 0; unit != unitCount; ++unit)
+                addToUnit(units[unit], mask);
+        }
+    }
+
+    // A tile in this unit has been solved as this bit
+    void addToUnit(std::size_t unit, mask_type bit)
+    {
+        if ((m_unitMasks[unit] & bit) != 0)
+            ++m_conflicts;
+        m_unitMasks[unit] |= bit;
+    }
+
+    // The tile in this unit that was solved as this bit no longer is. Without conflicts the bit
+    // just goes; with them another tile may still hold it, so the unit is rebuilt from the others.
+    // The tile itself is left out: it already has its new mask, which is added after this.
+    void removeFromUnit(std::size_t unit, mask_type bit, std::size_t changedTile)
+    {
+        if (m_conflicts == 0)
+        {
+            m_unitMasks[unit] &= static_cast<mask_type>(~bit);
+            return;
+        }
+
+        mask_type used{ 0 };
+        std::uint16_t const* const tiles = m_units->unitTiles(unit);
+        for (std::size_t index = 0; index != maxNumber(); ++index)
+        {
+            if (tiles[index] == changedTile)
+                continue;
+            mask_type const mask{ m_tileMatrix[tiles[index] / maxNumber()][tiles[index] % maxNumber()].mask() };
+            if (isSingleBit(mask))
+                used |= mask;
+        }
+        m_unitMasks[unit] = used;
+        // still there means it was held twice, which was counted as a conflict
+        if ((used & bit) != 0)
+            --m_conflicts;
+    }
+
+    // A new checkpoint level: tiles need recording again before they change. Stamps start at 1 so
+    // that 0 never matches, and wrapping round clears them all.
+    void nextTrailStamp()
+    {
+        if (++m_trailStamp == 0)
+        {
+            m_trailStamps.fill(0);
+            m_trailStamp = 1;
+        }
+    }
+
+    // Run the solving functions until nothing more is solved. Returns false if the board has been
+    // shown to have no solution.
+    bool propagate()
+    {
+        bool changed{ isConsistent() };
+        while (changed)
+        {
+            if (stopRequested())
+                return false;
+            changed = false;
+            if (!resolve_tiles(changed) || !check_singular(changed))
+                return false;
+            // the stronger strategies only once the basics have stalled
+            if (!changed && m_solvedTiles != N*N*N*N)
+                changed = apply_strategies();
+            if (!isConsistent())
+                return false;
+        }
+        return isConsistent();
+    }
+
+    // Guess a value for the unsolved tile with the fewest candidates, propagate, and go deeper.
+    // Returns true once the board is solved, leaving the guesses that worked in place.
+    bool search(std::size_t depth)
+    {
+        // Find the unsolved tile with the fewest candidates
+        std::size_t xBest{ 0 }, yBest{ 0 }, bestCount{ maxNumber() + 1 };
+        for (std::size_t xPosition = 0; xPosition != maxNumber() && bestCount != 2; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != maxNumber() && bestCount != 2; ++yPosition)
+            {
+                std::size_t const count{ m_tileMatrix[xPosition][yPosition].possibleNumbersCount() };
+                if (count > 1 && count < bestCount)
+                {
+                    xBest = xPosition;
+                    yBest = yPosition;
+                    bestCount = count;
+                }
+            }
+        }
+        // Nothing left to guess: propagation has already checked the board
+        if (bestCount > maxNumber())
+            return true;
+
+        if (depth > m_searchStatistics.maxDepth)
+            m_searchStatistics.maxDepth = depth;
+
+        // Try each candidate in turn
+        for (mask_type remaining = m_tileMatrix[xBest][yBest].mask(); remaining != 0;)
+        {
+            if (stopRequested())
+                return false;
+            mask_type const guess{ nextGuess(remaining) };
+            remaining &= static_cast<mask_type>(~guess);
+
+            ++m_searchStatistics.nodes;
+            checkpoint();
+            setTileMask(xBest, yBest, guess);
+
+            bool const solved{ propagate() && search(depth + 1) };
+            if (m_trail.size() > m_searchStatistics.maxTrailSize)
+                m_searchStatistics.maxTrailSize = m_trail.size();
+            if (solved)
+            {
+                commit();
+                return true;
+            }
+            rollback();
+            ++m_searchStatistics.backtracks;
+        }
+        return false;
+    }
+
+    // The next candidate to guess from these: the lowest, or a pseudo-random one if seeded
+    mask_type nextGuess(mask_type candidates)
+    {
+        if (m_searchSeed != 0)
+        {
+            // xorshift64
+            m_searchRandom ^= m_searchRandom << 13;
+            m_searchRandom ^= m_searchRandom >> 7;
+            m_searchRandom ^= m_searchRandom << 17;
+            for (std::size_t skip = m_searchRandom % popCount(candidates); skip != 0; --skip)
+                candidates &= candidates - 1;
+        }
+        return static_cast<mask_type>(candidates & (~candidates + 1));
+    }
+
+    bool stopRequested() const
+    {
+        return m_cancellation != nullptr && m_cancellation->shouldStop();
+    }
+
     // Convert a coordinate value to that of the local square it's in.
     static std::size_t squareStartPosition(std::size_t postition)
     {
@@ -294,154 +755,405 @@ private:
         return squareStartPosition(postition) + N;
     }
 
-    // If the given tile is solved, then no other tiles inside this local square can have this tile's solution.
-    std::vector<SudokuTilePosition> resolve_square(std::size_t xPosition, std::size_t yPosition)
+    // No tile can be a value already solved in one of its units, so strip those from
+    // every unsolved tile. Sets changed if a tile was solved; returns false if a tile is left
+    // with nothing.
+    bool resolve_tiles(bool& changed)
     {
-        // vector of the tiles that have been solved by this function
-        std::vector<SudokuTilePosition> solvedTiles{};
-        // if the given tile is solved
-        if (m_tileMatrix[xPosition][yPosition].isSolved())
+        for (std::size_t xPosition = 0; xPosition != maxNumber(); ++xPosition)
         {
-            // for each tile in this row starting from the local square and ending at the end of the local square
-            for (std::size_t xLoop = squareStartPosition(xPosition), xEnd = squareEndPosition(xPosition); xLoop != xEnd; ++xLoop)
+            for (std::size_t yPosition = 0; yPosition != maxNumber(); ++yPosition)
             {
-                // for each tile in this column starting from the local square and ending at the end of the local square
-                for (std::size_t yLoop = squareStartPosition(yPosition), yEnd = squareEndPosition(yPosition); yLoop != yEnd; ++yLoop)
-                {
-                    // if the value was removed from the tile by this action to remove it
-                    if (m_tileMatrix[xLoop][yLoop].cannotBe(m_tileMatrix[xPosition][yPosition].solution()))
-                        // if this action solved it
-                        if (m_tileMatrix[xLoop][yLoop].isSolved())
-                            // a tile has been solved
-                            solvedTiles.push_back(makeTilePosition(xLoop, yLoop));
-                }
+                if (m_tileMatrix[xPosition][yPosition].isSolved())
+                    continue;
+
+                mask_type const candidates{ getTileCandidates(xPosition, yPosition) };
+                if (candidates == m_tileMatrix[xPosition][yPosition].mask())
+                    continue;
+                if (candidates == 0)
+                    return false;
+                setTileMask(xPosition, yPosition, candidates);
+                if (isSingleBit(candidates))
+                    changed = true;
             }
         }
-        return solvedTiles;
+        return true;
     }
 
-    std::vector<SudokuTilePosition> resolve_square(SudokuTilePosition tilePosition)
+    // If only one tile in a unit can be a value, then it is that value. Sets changed if a tile was
+    // solved; returns false if a unit has a value nowhere to go.
+    bool check_singular(bool& changed)
     {
-        return resolve_square(tilePosition.x, tilePosition.y);
+        for (std::size_t unit = 0, units = m_units->unitCount(); unit != units; ++unit)
+        {
+            // the values that appear in at least one and at least two unsolved tiles
+            mask_type once{ 0 }, twice{ 0 };
+            std::uint16_t const* const tiles = m_units->unitTiles(unit);
+            for (std::size_t index = 0; index != maxNumber(); ++index)
+            {
+                tile_type const& tile = m_tileMatrix[tiles[index] / maxNumber()][tiles[index] % maxNumber()];
+                if (tile.isSolved())
+                    continue;
+                mask_type const candidates{ static_cast<mask_type>(tile.mask() & ~usedAround(tiles[index])) };
+                twice |= static_cast<mask_type>(once & candidates);
+                once |= candidates;
+            }
+
+            if ((once | m_unitMasks[unit]) != tile_mask::full())
+                return false;
+
+            mask_type singles{ static_cast<mask_type>(once & ~twice & ~m_unitMasks[unit]) };
+            for (std::size_t index = 0; index != maxNumber() && singles != 0; ++index)
+            {
+                SudokuTilePosition const position{ unitTilePosition(unit, index) };
+                if (m_tileMatrix[position.x][position.y].isSolved())
+                    continue;
+                mask_type const single{ static_cast<mask_type>(getTileCandidates(position.x, position.y) & singles) };
+                if (single == 0)
+                    continue;
+                // two values that can only go in the same tile can't both be satisfied
+                if (!isSingleBit(single))
+                    return false;
+                setTileMask(position.x, position.y, single);
+                singles &= static_cast<mask_type>(~single);
+                changed = true;
+            }
+            if (!isConsistent())
+                return false;
+        }
+        return true;
     }
 
-    // If the given tile is solved, then no other tiles inside this row can have this tile's solution.
-    std::vector<SudokuTilePosition> resolve_row(std::size_t xPosition, std::size_t yPosition)
+    // Run the enabled strategies in order until one of them removes a candidate, timing each.
+    // Returns true if anything was removed. The strategies read getTileCandidates() rather than
+    // the tile masks, since a strategy that solves a tile leaves its value in the other tiles of
+    // its units until the next resolve_tiles().
+    bool apply_strategies()
     {
-        // vector of the tiles that have been solved by this function
-        std::vector<SudokuTilePosition> solvedTiles{};
-        // if the given tile is solved
-        if (m_tileMatrix[xPosition][yPosition].isSolved())
+        for (auto& step : m_strategyPipeline.steps())
         {
-            // for each tile in this row
-            for (std::size_t yLoop = 0; yLoop != maxNumber(); ++yLoop)
+            if (!step.enabled)
+                continue;
+
+            auto const start = std::chrono::steady_clock::now();
+            std::size_t const eliminated{ run_strategy(step.strategy) };
+            step.statistics.time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            ++step.statistics.calls;
+            if (eliminated != 0)
             {
-                // if the tile isn't solved
-                if (!m_tileMatrix[xPosition][yLoop].isSolved())
-                    // if the value was removed from the tile by this action to remove it
-                    if (m_tileMatrix[xPosition][yLoop].cannotBe(m_tileMatrix[xPosition][yPosition].solution()))
-                        // if this action solved it
-                        if (m_tileMatrix[xPosition][yLoop].isSolved())
-                            // a tile has been solved
-                            solvedTiles.push_back(makeTilePosition(xPosition, yLoop));
+                ++step.statistics.hits;
+                step.statistics.eliminations += eliminated;
+                return true;
             }
         }
-        return solvedTiles;
+        return false;
     }
 
-    std::vector<SudokuTilePosition> resolve_row(SudokuTilePosition tilePosition)
+    std::size_t run_strategy(SudokuStrategy strategy)
     {
-        return resolve_row(tilePosition.x, tilePosition.y);
+        switch (strategy)
+        {
+        case SudokuStrategy::NakedPairs:        return naked_subsets(2);
+        case SudokuStrategy::HiddenPairs:       return hidden_subsets(2);
+        case SudokuStrategy::PointingPairs:     return m_units->isClassic() ? pointing_pairs() : unit_intersections(false);
+        case SudokuStrategy::BoxLineReduction:  return m_units->isClassic() ? box_line_reduction() : unit_intersections(true);
+        case SudokuStrategy::NakedTriples:      return naked_subsets(3);
+        case SudokuStrategy::HiddenTriples:     return hidden_subsets(3);
+        default:                                return 0;
+        }
     }
 
-    // If the given tile is solved, then no other tiles inside this row can have column tile's solution.
-    std::vector<SudokuTilePosition> resolve_column(std::size_t xPosition, std::size_t yPosition)
+    // If size unsolved tiles in a unit can only be size values between them, no other tile in the
+    // unit can be those values. Returns how many candidates were removed.
+    std::size_t naked_subsets(std::size_t size)
     {
-        // vector of the tiles that have been solved by this function
-        std::vector<SudokuTilePosition> solvedTiles{};
-        // if the given tile is solved
-        if (m_tileMatrix[xPosition][yPosition].isSolved())
+        std::size_t eliminated{ 0 };
+        for (std::size_t unit = 0, units = m_units->unitCount(); unit != units; ++unit)
         {
-            // for each tile in this column
-            for (std::size_t xLoop = 0; xLoop != maxNumber(); ++xLoop)
+            // the unsolved tiles small enough to be part of a subset
+            std::array<std::size_t, N*N> items{};
+            std::size_t itemCount{ 0 };
+            for (std::size_t index = 0; index != maxNumber(); ++index)
             {
-                // if the tile isn't solved and the one checked is
-                if (!m_tileMatrix[xLoop][yPosition].isSolved())
-                    // if the value was removed from the tile by this action to remove it
-                    if (m_tileMatrix[xLoop][yPosition].cannotBe(m_tileMatrix[xPosition][yPosition].solution()))
-                        // if this action solved it
-                        if (m_tileMatrix[xLoop][yPosition].isSolved())
-                            // a tile has been solved
-                            solvedTiles.push_back(makeTilePosition(xLoop, yPosition));
+                SudokuTilePosition const position{ unitTilePosition(unit, index) };
+                std::size_t const count{ popCount(getTileCandidates(position.x, position.y)) };
+                if (count >= 2 && count <= size)
+                    items[itemCount++] = index;
             }
+            if (itemCount >= size)
+                eliminated += naked_combinations(unit, items, itemCount, size, 0, 0, 0, 0);
         }
-        return solvedTiles;
+        return eliminated;
     }
 
-    std::vector<SudokuTilePosition> resolve_column(SudokuTilePosition tilePosition)
+    // Try every combination of size items from start onwards, eliminating for each one whose
+    // candidates come to exactly size values
+    std::size_t naked_combinations(std::size_t unit, std::array<std::size_t, N*N> const& items, std::size_t itemCount,
+                                   std::size_t size, std::size_t start, std::size_t chosenCount, std::uint64_t chosenIndexes, mask_type values)
     {
-        return resolve_column(tilePosition.x, tilePosition.y);
+        if (popCount(values) > size)
+            return 0;
+
+        std::size_t eliminated{ 0 };
+        if (chosenCount == size)
+        {
+            // every other unsolved tile in the unit loses these values
+            for (std::size_t index = 0; index != maxNumber(); ++index)
+            {
+                SudokuTilePosition const position{ unitTilePosition(unit, index) };
+                if (((chosenIndexes >> index) & 1) == 0 && !m_tileMatrix[position.x][position.y].isSolved())
+                    eliminated += eliminateTileCandidates(position.x, position.y, values);
+            }
+            return eliminated;
+        }
+
+        for (std::size_t item = start; item != itemCount; ++item)
+        {
+            SudokuTilePosition const position{ unitTilePosition(unit, items[item]) };
+            eliminated += naked_combinations(unit, items, itemCount, size, item + 1, chosenCount + 1,
+                                             chosenIndexes | (std::uint64_t{ 1 } << items[item]),
+                                             static_cast<mask_type>(values | getTileCandidates(position.x, position.y)));
+        }
+        return eliminated;
     }
 
-    // If the given tile is solved, then check whether the other tiles in the local square can be solved by being the only tile that can be a number (any number)
-    std::vector<SudokuTilePosition> check_singular(std::size_t xPosition, std::size_t yPosition)
+    // If size values can only go in size tiles of a unit, those tiles can't be anything else.
+    // Returns how many candidates were removed.
+    std::size_t hidden_subsets(std::size_t size)
     {
-        // vector of the tiles that have been solved by this function
-        std::vector<SudokuTilePosition> solvedTiles{};
+        std::size_t eliminated{ 0 };
+        for (std::size_t unit = 0, units = m_units->unitCount(); unit != units; ++unit)
+        {
+            // where in the unit each value can go, as a mask of tile indexes
+            std::array<std::uint64_t, N*N> places{};
+            for (std::size_t index = 0; index != maxNumber(); ++index)
+            {
+                SudokuTilePosition const position{ unitTilePosition(unit, index) };
+                if (m_tileMatrix[position.x][position.y].isSolved())
+                    continue;
+                for (mask_type remaining = getTileCandidates(position.x, position.y); remaining != 0; remaining &= remaining - 1)
+                    places[lowestBitIndex(remaining)] |= std::uint64_t{ 1 } << index;
+            }
 
-        // if the given tile is solved
-        if (m_tileMatrix[xPosition][yPosition].isSolved())
+            // the unsolved values with few enough places to be part of a subset
+            std::array<std::size_t, N*N> items{};
+            std::size_t itemCount{ 0 };
+            for (std::size_t valueIndex = 0; valueIndex != maxNumber(); ++valueIndex)
+            {
+                std::size_t const count{ popCount(places[valueIndex]) };
+                if (count >= 2 && count <= size)
+                    items[itemCount++] = valueIndex;
+            }
+            if (itemCount >= size)
+                eliminated += hidden_combinations(unit, places, items, itemCount, size, 0, 0, 0, 0);
+        }
+        return eliminated;
+    }
+
+    // Try every combination of size values from start onwards, eliminating for each one that fits
+    // in exactly size tiles
+    std::size_t hidden_combinations(std::size_t unit, std::array<std::uint64_t, N*N> const& places, std::array<std::size_t, N*N> const& items,
+                                    std::size_t itemCount, std::size_t size, std::size_t start, std::size_t chosenCount, mask_type values, std::uint64_t indexes)
+    {
+        if (popCount(indexes) > size)
+            return 0;
+
+        std::size_t eliminated{ 0 };
+        if (chosenCount == size)
+        {
+            // fewer tiles than values is a contradiction which propagation will find
+            if (popCount(indexes) != size)
+                return 0;
+            for (std::uint64_t remaining = indexes; remaining != 0; remaining &= remaining - 1)
+            {
+                SudokuTilePosition const position{ unitTilePosition(unit, lowestBitIndex(remaining)) };
+                eliminated += eliminateTileCandidates(position.x, position.y, static_cast<mask_type>(~values));
+            }
+            return eliminated;
+        }
+
+        for (std::size_t item = start; item != itemCount; ++item)
         {
-            // We will build a map of number : tilePosition for the local square
+            eliminated += hidden_combinations(unit, places, items, itemCount, size, item + 1, chosenCount + 1,
+                                              static_cast<mask_type>(values | (mask_type{ 1 } << items[item])),
+                                              indexes | places[items[item]]);
+        }
+        return eliminated;
+    }
 
-            using PossibleNumber_TilePosition_multimap = std::multimap<std::size_t, SudokuTilePosition>;
-            PossibleNumber_TilePosition_multimap existingPossibleNumbers;
+    // If a value can only go in one row (or column) of a square, then it can't go in that row (or
+    // column) outside the square. Returns how many candidates were removed.
+    std::size_t pointing_pairs()
+    {
+        std::size_t eliminated{ 0 };
+        for (std::size_t square = 0; square != maxNumber(); ++square)
+        {
+            std::size_t const xStart{ square / N * N };
+            std::size_t const yStart{ square % N * N };
 
-            // for each tile in this row starting from the local square and ending at the end of the local square
-            for (std::size_t xLoop = squareStartPosition(xPosition), xEnd = squareEndPosition(xPosition); xLoop != xEnd; ++xLoop)
+            // which rows and columns of the square each value can go in
+            std::array<std::uint64_t, N*N> rows{}, columns{};
+            for (std::size_t xPosition = xStart; xPosition != xStart + N; ++xPosition)
             {
-                // for each tile in this column starting from the local square and ending at the end of the local square
-                for (std::size_t yLoop = squareStartPosition(yPosition), yEnd = squareEndPosition(yPosition); yLoop != yEnd; ++yLoop)
+                for (std::size_t yPosition = yStart; yPosition != yStart + N; ++yPosition)
                 {
-                    // for each number in the current tile's possible numbers
-                    for (auto number : m_tileMatrix[xLoop][yLoop].possibleNumbers())
+                    if (m_tileMatrix[xPosition][yPosition].isSolved())
+                        continue;
+                    for (mask_type remaining = getTileCandidates(xPosition, yPosition); remaining != 0; remaining &= remaining - 1)
                     {
-                        existingPossibleNumbers.emplace(number, makeTilePosition(xLoop, yLoop));
+                        rows[lowestBitIndex(remaining)] |= std::uint64_t{ 1 } << xPosition;
+                        columns[lowestBitIndex(remaining)] |= std::uint64_t{ 1 } << yPosition;
                     }
                 }
             }
-            // For all possible numbers
-            for (std::size_t number = 1; number <= maxNumber(); ++number)
+
+            for (std::size_t valueIndex = 0; valueIndex != maxNumber(); ++valueIndex)
             {
-                // if there is only one entry for the number
-                if (existingPossibleNumbers.count(number) == 1)
+                mask_type const value{ static_cast<mask_type>(mask_type{ 1 } << valueIndex) };
+                if (isSingleBit(rows[valueIndex]))
                 {
-                    auto foundIterator = existingPossibleNumbers.find(number);
-                    std::size_t xOnlyPossible = foundIterator->second.x;
-                    std::size_t yOnlyPossible = foundIterator->second.y;
+                    std::size_t const xPosition{ lowestBitIndex(rows[valueIndex]) };
+                    for (std::size_t yPosition = 0; yPosition != maxNumber(); ++yPosition)
+                        if ((yPosition < yStart || yPosition >= yStart + N) && !m_tileMatrix[xPosition][yPosition].isSolved())
+                            eliminated += eliminateTileCandidates(xPosition, yPosition, value);
+                }
+                if (isSingleBit(columns[valueIndex]))
+                {
+                    std::size_t const yPosition{ lowestBitIndex(columns[valueIndex]) };
+                    for (std::size_t xPosition = 0; xPosition != maxNumber(); ++xPosition)
+                        if ((xPosition < xStart || xPosition >= xStart + N) && !m_tileMatrix[xPosition][yPosition].isSolved())
+                            eliminated += eliminateTileCandidates(xPosition, yPosition, value);
+                }
+            }
+        }
+        return eliminated;
+    }
 
-                    // if the tile isn't solved
-                    if (!m_tileMatrix[xOnlyPossible][yOnlyPossible].isSolved())
-                    {
-                        m_tileMatrix[xOnlyPossible][yOnlyPossible].setSolution(number);
-                        // a tile has been solved
-                        solvedTiles.push_back(makeTilePosition(xOnlyPossible, yOnlyPossible));
-                    }
+    // If a value can only go in one square within a row (or column), then it can't go anywhere
+    // else in that square. Returns how many candidates were removed.
+    std::size_t box_line_reduction()
+    {
+        std::size_t eliminated{ 0 };
+        for (std::size_t line = 0; line != maxNumber(); ++line)
+        {
+            // which squares along row line and column line each value can go in
+            std::array<std::uint64_t, N*N> rowSquares{}, columnSquares{};
+            for (std::size_t other = 0; other != maxNumber(); ++other)
+            {
+                if (!m_tileMatrix[line][other].isSolved())
+                    for (mask_type remaining = getTileCandidates(line, other); remaining != 0; remaining &= remaining - 1)
+                        rowSquares[lowestBitIndex(remaining)] |= std::uint64_t{ 1 } << (other / N);
+
+                if (!m_tileMatrix[other][line].isSolved())
+                    for (mask_type remaining = getTileCandidates(other, line); remaining != 0; remaining &= remaining - 1)
+                        columnSquares[lowestBitIndex(remaining)] |= std::uint64_t{ 1 } << (other / N);
+            }
+
+            for (std::size_t valueIndex = 0; valueIndex != maxNumber(); ++valueIndex)
+            {
+                mask_type const value{ static_cast<mask_type>(mask_type{ 1 } << valueIndex) };
+                if (isSingleBit(rowSquares[valueIndex]))
+                {
+                    std::size_t const yStart{ lowestBitIndex(rowSquares[valueIndex]) * N };
+                    for (std::size_t xPosition = squareStartPosition(line); xPosition != squareEndPosition(line); ++xPosition)
+                        for (std::size_t yPosition = yStart; yPosition != yStart + N; ++yPosition)
+                            if (xPosition != line && !m_tileMatrix[xPosition][yPosition].isSolved())
+                                eliminated += eliminateTileCandidates(xPosition, yPosition, value);
+                }
+                if (isSingleBit(columnSquares[valueIndex]))
+                {
+                    std::size_t const xStart{ lowestBitIndex(columnSquares[valueIndex]) * N };
+                    for (std::size_t xPosition = xStart; xPosition != xStart + N; ++xPosition)
+                        for (std::size_t yPosition = squareStartPosition(line); yPosition != squareEndPosition(line); ++yPosition)
+                            if (yPosition != line && !m_tileMatrix[xPosition][yPosition].isSolved())
+                                eliminated += eliminateTileCandidates(xPosition, yPosition, value);
                 }
             }
         }
-        return solvedTiles;
+        return eliminated;
+    }
+
+    // The variants' pointing pairs and box/line reduction, over any two units sharing tiles: if a
+    // value can only go in the part of one unit that is also in the other, it can't go anywhere
+    // else in the other. fromLines picks box/line reduction, starting from rows and columns;
+    // otherwise it starts from regions and extra units. Returns how many candidates were removed.
+    std::size_t unit_intersections(bool fromLines)
+    {
+        std::size_t eliminated{ 0 };
+        for (auto const& intersection : m_units->intersections())
+        {
+            bool const firstIsLine{ unit_table::unitKind(intersection.first) == unit_table::UnitKind::Row
+                                    || unit_table::unitKind(intersection.first) == unit_table::UnitKind::Column };
+            bool const secondIsLine{ unit_table::unitKind(intersection.second) == unit_table::UnitKind::Row
+                                     || unit_table::unitKind(intersection.second) == unit_table::UnitKind::Column };
+            if (firstIsLine == fromLines)
+                eliminated += locked_candidates(intersection.first, intersection.inFirst, intersection.second, intersection.inSecond);
+            if (secondIsLine == fromLines)
+                eliminated += locked_candidates(intersection.second, intersection.inSecond, intersection.first, intersection.inFirst);
+        }
+        return eliminated;
     }
 
-    std::vector<SudokuTilePosition> check_singular(SudokuTilePosition tilePosition)
+    // Values of source that can only go in its tiles inSource are removed from target's tiles
+    // outside inTarget
+    std::size_t locked_candidates(std::size_t source, std::uint64_t inSource, std::size_t target, std::uint64_t inTarget)
     {
-        return check_singular(tilePosition.x, tilePosition.y);
+        mask_type inside{ 0 }, outside{ 0 };
+        std::uint16_t const* const sourceTiles = m_units->unitTiles(source);
+        for (std::size_t index = 0; index != maxNumber(); ++index)
+        {
+            std::size_t const tile{ sourceTiles[index] };
+            if (m_tileMatrix[tile / maxNumber()][tile % maxNumber()].isSolved())
+                continue;
+            mask_type const candidates{ getTileCandidates(tile / maxNumber(), tile % maxNumber()) };
+            if (((inSource >> index) & 1) != 0)
+                inside |= candidates;
+            else
+                outside |= candidates;
+        }
+        mask_type const locked{ static_cast<mask_type>(inside & ~outside & ~m_unitMasks[source]) };
+        if (locked == 0)
+            return 0;
+
+        std::size_t eliminated{ 0 };
+        std::uint16_t const* const targetTiles = m_units->unitTiles(target);
+        for (std::size_t index = 0; index != maxNumber(); ++index)
+        {
+            std::size_t const tile{ targetTiles[index] };
+            if (((inTarget >> index) & 1) == 0 && !m_tileMatrix[tile / maxNumber()][tile % maxNumber()].isSolved())
+                eliminated += eliminateTileCandidates(tile / maxNumber(), tile % maxNumber(), locked);
+        }
+        return eliminated;
     }
 
     // Data Members
     //============================================================
 
     tile_matrix m_tileMatrix;
+
+    // The units, shared with every board of the same variant
+    std::shared_ptr<unit_table const> m_units{ unit_table::classic() };
+    bool m_classicUnits{ true };
+
+    // Solved digits in each unit, and how many times a digit has been solved twice in one unit
+    std::array<mask_type, 4*N*N> m_unitMasks{};     // unit_table::maxUnitCount()
+    std::size_t m_conflicts{ 0 };
+    std::size_t m_solvedTiles{ 0 };
+    std::size_t m_emptyTiles{ 0 };
+
+    // Undo trail, the trail size at each open checkpoint, and which tiles have been recorded at
+    // the current checkpoint level
+    std::vector<TrailEntry> m_trail{};
+    std::vector<std::size_t> m_checkpoints{};
+    std::array<std::uint32_t, N*N*N*N> m_trailStamps{};
+    std::uint32_t m_trailStamp{ 1 };
+
+    SudokuSearchStatistics m_searchStatistics{};
+    SudokuStrategyPipeline m_strategyPipeline{};
+
+    std::uint64_t m_searchSeed{ 0 };
+    std::uint64_t m_searchRandom{ 0 };
+    SudokuCancellationToken const* m_cancellation{ nullptr };
 };
 
 } // namespace puzzles
@@ -0,0 +1,365 @@
+#ifndef SUDOKUBOARDSNAPSHOT_H
+#define SUDOKUBOARDSNAPSHOT_H
+/*
+class SudokuBoardSnapshot<N>
+====================================================================================================
+A copy of a board's tiles that is cheap to fork, for asking many "what if this tile were that
+value" questions of one propagated board. Each row of tile masks is held through a shared pointer,
+so copying a snapshot copies N*N pointers and the used-digit masks of the units, and a fork only
+gets its own copy of a row when it first changes a tile in it. A thousand branches that each place
+a value and propagate a little cost a thousand sets of changed rows, not a thousand boards.
+
+To keep rows shared for as long as possible a tile's mask is only written when the tile is solved
+or narrowed by something other than its units; what the units rule out is taken off when the
+candidates are read, as SudokuBoard<N>::getTileCandidates() does. propagate() runs the basic
+eliminations and singles, which is what most what-if questions need; for anything more, toBoard()
+gives a full SudokuBoard<N> to solve.
+
+The unit masks are those of the classic rows, columns and squares, so only boards played with the
+classic units can be snapshot: one with diagonals, jigsaw regions or extra units gives a snapshot
+with a contradiction rather than one that makes deductions the board's own units don't allow.
+
+A snapshot only writes in place to rows it owns, marked in a bitmask when it makes its own copy
+of one. Copying a snapshot clears the marks on both sides, so from then on each copies a row
+before changing it. Forks can be made on one thread, or on several at once from a snapshot that
+isn't being changed, and used on others: a row is only ever written by the one snapshot that owns
+it, and no other snapshot holds it.
+*/
+#include "sudokuboard.h"
+#include "sudokubits.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace puzzles
+{
+
+template <std::size_t N>
+class SudokuBoardSnapshot
+{
+    static_assert(N >= 2, "SudokuBoardSnapshot cannot be instantiated with a template value less than 2.");
+public:
+    // Typedefs
+    //============================================================
+    using mask_type = typename SudokuBoard<N>::mask_type;
+
+    // Special 6
+    //============================================================
+    // Every tile empty
+    SudokuBoardSnapshot() :
+        m_rows(),
+        m_unitMasks(),
+        m_ownedRows{ 0 },
+        m_solvedTiles{ 0 },
+        m_contradiction{ false }
+    {
+        std::shared_ptr<Row> const empty{ std::make_shared<Row>() };
+        empty->fill(tile_mask::full());
+        m_rows.fill(empty);
+    }
+    // The candidates of every tile of the board as it stands; a board with other than the classic
+    // units gives a contradiction
+    explicit SudokuBoardSnapshot(SudokuBoard<N> const& board) :
+        m_rows(),
+        m_unitMasks(),
+        m_ownedRows{ 0 },
+        m_solvedTiles{ 0 },
+        m_contradiction{ !board.unitTable().isClassic() || !board.isConsistent() }
+    {
+        for (std::size_t xPosition = 0; xPosition != N*N; ++xPosition)
+        {
+            m_rows[xPosition] = std::make_shared<Row>();
+            for (std::size_t yPosition = 0; yPosition != N*N; ++yPosition)
+            {
+                mask_type const mask{ board.getTileCandidates(xPosition, yPosition) };
+                (*m_rows[xPosition])[yPosition] = mask;
+                if (isSingleBit(mask))
+                    addSolution(xPosition, yPosition, mask);
+            }
+        }
+    }
+
+    // A copy shares every row, and neither side owns any of them afterwards
+    SudokuBoardSnapshot(SudokuBoardSnapshot const& other) :
+        m_rows(other.m_rows),
+        m_unitMasks(other.m_unitMasks),
+        m_ownedRows{ 0 },
+        m_solvedTiles{ other.m_solvedTiles },
+        m_contradiction{ other.m_contradiction }
+    {
+        other.m_ownedRows.store(0, std::memory_order_relaxed);
+    }
+    SudokuBoardSnapshot& operator=(SudokuBoardSnapshot const& other)
+    {
+        m_rows = other.m_rows;
+        m_unitMasks = other.m_unitMasks;
+        m_ownedRows.store(0, std::memory_order_relaxed);
+        other.m_ownedRows.store(0, std::memory_order_relaxed);
+        m_solvedTiles = other.m_solvedTiles;
+        m_contradiction = other.m_contradiction;
+        return *this;
+    }
+
+    // A move takes the rows along with their ownership
+    SudokuBoardSnapshot(SudokuBoardSnapshot&& other) :
+        m_rows(std::move(other.m_rows)),
+        m_unitMasks(other.m_unitMasks),
+        m_ownedRows{ other.m_ownedRows.exchange(0, std::memory_order_relaxed) },
+        m_solvedTiles{ other.m_solvedTiles },
+        m_contradiction{ other.m_contradiction }
+    {}
+    SudokuBoardSnapshot& operator=(SudokuBoardSnapshot&& other)
+    {
+        if (this == &other)
+            return *this;
+        m_rows = std::move(other.m_rows);
+        m_unitMasks = other.m_unitMasks;
+        m_ownedRows.store(other.m_ownedRows.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        m_solvedTiles = other.m_solvedTiles;
+        m_contradiction = other.m_contradiction;
+        return *this;
+    }
+
+    // Interface
+    //============================================================
+    // A copy to change without affecting this one
+    SudokuBoardSnapshot fork() const
+    {
+        return *this;
+    }
+
+    std::size_t getTileSolution(std::size_t xPosition, std::size_t yPosition) const
+    {
+        mask_type const mask{ tileMask(xPosition, yPosition) };
+        return isSingleBit(mask) ? lowestBitIndex(mask) + 1 : 0;
+    }
+
+    // The values a tile could be, less anything solved elsewhere in its units
+    mask_type getTileCandidates(std::size_t xPosition, std::size_t yPosition) const
+    {
+        mask_type const mask{ tileMask(xPosition, yPosition) };
+        if (isSingleBit(mask))
+            return mask;
+        return static_cast<mask_type>(mask & ~(m_unitMasks[rowUnit(xPosition)] | m_unitMasks[columnUnit(yPosition)]
+                                               | m_unitMasks[squareUnit(xPosition, yPosition)]));
+    }
+
+    // Solve this tile as this value, returning false if that clashes with the board as it is
+    bool placeTileSolution(std::size_t xPosition, std::size_t yPosition, std::size_t value)
+    {
+        if (m_contradiction || value == 0 || value > N*N || isSingleBit(tileMask(xPosition, yPosition)))
+            return false;
+        mask_type const bit{ tile_mask::bit(value) };
+        if ((getTileCandidates(xPosition, yPosition) & bit) == 0)
+            return false;
+        solveTile(xPosition, yPosition, bit);
+        return true;
+    }
+
+    // This tile cannot be any of these values. Returns false if that leaves it with none.
+    bool eliminateTileCandidates(std::size_t xPosition, std::size_t yPosition, mask_type values)
+    {
+        mask_type const mask{ tileMask(xPosition, yPosition) };
+        mask_type const remaining{ static_cast<mask_type>(mask & ~values) };
+        if (remaining == mask)
+            return true;
+        if (remaining == 0)
+        {
+            m_contradiction = true;
+            return false;
+        }
+        if (isSingleBit(remaining))
+            solveTile(xPosition, yPosition, remaining);
+        else
+            writeTileMask(xPosition, yPosition, remaining);
+        return !m_contradiction;
+    }
+
+    // Naked and hidden singles until nothing changes. Returns false if the board has been shown to
+    // have no solution.
+    bool propagate()
+    {
+        bool changed{ !m_contradiction };
+        while (changed && !m_contradiction)
+        {
+            changed = false;
+            if (!solveNakedSingles(changed) || !solveHiddenSingles(changed))
+                m_contradiction = true;
+        }
+        return !m_contradiction;
+    }
+
+    // Place a value and propagate: the what-if question. Returns false if it leads to a
+    // contradiction, leaving the snapshot somewhere part way.
+    bool assume(std::size_t xPosition, std::size_t yPosition, std::size_t value)
+    {
+        return placeTileSolution(xPosition, yPosition, value) && propagate();
+    }
+
+    bool isSolved() const
+    {
+        return !m_contradiction && m_solvedTiles == N*N*N*N;
+    }
+    bool hasContradiction() const
+    {
+        return m_contradiction;
+    }
+    std::size_t solvedTileCount() const
+    {
+        return m_solvedTiles;
+    }
+
+    // How many rows this snapshot has its own copy of rather than sharing
+    std::size_t ownedRowCount() const
+    {
+        return popCount(m_ownedRows.load(std::memory_order_relaxed));
+    }
+
+    // A full board with the same candidates, to solve or to run the stronger strategies on
+    SudokuBoard<N> toBoard() const
+    {
+        SudokuBoard<N> result{};
+        for (std::size_t xPosition = 0; xPosition != N*N; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != N*N; ++yPosition)
+                result.eliminateTileCandidates(xPosition, yPosition, static_cast<mask_type>(~tileMask(xPosition, yPosition)));
+        }
+        return result;
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    using tile_mask = SudokuMask<N*N>;
+    using Row = std::array<mask_type, N*N>;
+
+    // Helpers
+    //============================================================
+    static std::size_t rowUnit(std::size_t xPosition)                           { return xPosition; }
+    static std::size_t columnUnit(std::size_t yPosition)                        { return N*N + yPosition; }
+    static std::size_t squareUnit(std::size_t xPosition, std::size_t yPosition) { return 2*N*N + xPosition / N * N + yPosition / N; }
+
+    static SudokuTilePosition unitTilePosition(std::size_t unit, std::size_t index)
+    {
+        std::size_t const kind{ unit / (N*N) };
+        std::size_t const number{ unit % (N*N) };
+        if (kind == 0)
+            return SudokuTilePosition{ number, index };
+        if (kind == 1)
+            return SudokuTilePosition{ index, number };
+        return SudokuTilePosition{ number / N * N + index / N, number % N * N + index % N };
+    }
+
+    mask_type tileMask(std::size_t xPosition, std::size_t yPosition) const
+    {
+        return (*m_rows[xPosition])[yPosition];
+    }
+
+    // The only place rows are written: a row this snapshot doesn't own is copied first
+    void writeTileMask(std::size_t xPosition, std::size_t yPosition, mask_type mask)
+    {
+        std::shared_ptr<Row>& row = m_rows[xPosition];
+        mask_type const rowBit{ tile_mask::bit(xPosition + 1) };
+        if ((m_ownedRows.load(std::memory_order_relaxed) & rowBit) == 0)
+        {
+            row = std::make_shared<Row>(*row);
+            m_ownedRows.fetch_or(rowBit, std::memory_order_relaxed);
+        }
+        (*row)[yPosition] = mask;
+    }
+
+    void solveTile(std::size_t xPosition, std::size_t yPosition, mask_type bit)
+    {
+        writeTileMask(xPosition, yPosition, bit);
+        addSolution(xPosition, yPosition, bit);
+    }
+
+    // A value solved twice in one unit is a contradiction
+    void addSolution(std::size_t xPosition, std::size_t yPosition, mask_type bit)
+    {
+        ++m_solvedTiles;
+        for (std::size_t const unit : { rowUnit(xPosition), columnUnit(yPosition), squareUnit(xPosition, yPosition) })
+        {
+            if ((m_unitMasks[unit] & bit) != 0)
+                m_contradiction = true;
+            m_unitMasks[unit] |= bit;
+        }
+    }
+
+    // Solve every unsolved tile its units leave one value. Returns false if one has none.
+    bool solveNakedSingles(bool& changed)
+    {
+        for (std::size_t xPosition = 0; xPosition != N*N; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != N*N; ++yPosition)
+            {
+                if (isSingleBit(tileMask(xPosition, yPosition)))
+                    continue;
+                mask_type const candidates{ getTileCandidates(xPosition, yPosition) };
+                if (candidates == 0)
+                    return false;
+                if (isSingleBit(candidates))
+                {
+                    solveTile(xPosition, yPosition, candidates);
+                    changed = true;
+                    if (m_contradiction)
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Solve every value that can only go in one tile of a unit. Returns false if a value can go
+    // nowhere in a unit, or two values only in the same tile.
+    bool solveHiddenSingles(bool& changed)
+    {
+        for (std::size_t unit = 0; unit != 3*N*N; ++unit)
+        {
+            mask_type once{ 0 }, twice{ 0 };
+            for (std::size_t index = 0; index != N*N; ++index)
+            {
+                SudokuTilePosition const position{ unitTilePosition(unit, index) };
+                if (isSingleBit(tileMask(position.x, position.y)))
+                    continue;
+                mask_type const candidates{ getTileCandidates(position.x, position.y) };
+                twice |= static_cast<mask_type>(once & candidates);
+                once |= candidates;
+            }
+            if ((once | m_unitMasks[unit]) != tile_mask::full())
+                return false;
+
+            mask_type singles{ static_cast<mask_type>(once & ~twice & ~m_unitMasks[unit]) };
+            for (std::size_t index = 0; index != N*N && singles != 0; ++index)
+            {
+                SudokuTilePosition const position{ unitTilePosition(unit, index) };
+                if (isSingleBit(tileMask(position.x, position.y)))
+                    continue;
+                mask_type const single{ static_cast<mask_type>(getTileCandidates(position.x, position.y) & singles) };
+                if (single == 0)
+                    continue;
+                if (!isSingleBit(single))
+                    return false;
+                solveTile(position.x, position.y, single);
+                singles &= static_cast<mask_type>(~single);
+                changed = true;
+                if (m_contradiction)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Data Members
+    //============================================================
+    std::array<std::shared_ptr<Row>, N*N> m_rows;
+    std::array<mask_type, 3*N*N> m_unitMasks;
+    mutable std::atomic<mask_type> m_ownedRows;    // bit x for row x; copying clears the source's too
+    std::size_t m_solvedTiles;
+    bool m_contradiction;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUBOARDSNAPSHOT_H
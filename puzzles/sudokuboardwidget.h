@@ -4,9 +4,27 @@
 class SudokuBoardWidget<N>
 ====================================================================================================
 Consists of a SudokuBoard<N> and N^4 SudokuTileWidget to enter and display the values.
+
+The board is kept in step with the tiles as they are edited, through each tile's valueChanged
+signal. An edit changes one tile of the board, which updates the used-digit masks of its row,
+column and square, and then only the tiles in those three units are looked at again: a tile solved
+as a value another tile in one of its units also has is coloured as a conflict, an empty tile with
+nothing left it could be is coloured as unsolved, and every tile's candidate count is refreshed.
+Solve then starts from the live board without rebuilding it. It doesn't run if there is a conflict,
+an empty tile with nothing left it could be, or nothing has changed since the last solve, and says
+which through solveRefused() instead.
+
+Hint asks a SudokuHintEngine<N> for the simplest next step on the live board and takes it: a single
+is entered in its tile as if typed, and an elimination is made on the board, where the candidate
+counts show it and later hints build on it. Eliminations follow from the digits on the board when
+they were made, so they hold while digits are only added; once a digit is changed or cleared, or the
+board is reset or solved, the board is rebuilt from the tiles and they are dropped. The
+engine keeps what it learnt between hints, so it only looks again where the board has changed.
 */
 #include "sudokuboardwidgetbase.h"
 #include "sudokuboard.h"
+#include "sudokuhintengine.h"
+#include "sudokusolutioncache.h"
 #include "sudokutilewidget.h"
 
 #include <QSpinBox>
@@ -27,6 +45,7 @@ public:
     // Typedefs
     //============================================================
     using SudokuTileWidgetArray = std::array<std::unique_ptr<SudokuTileWidget>, N*N*N*N>;
+    using StartTileArray = std::array<bool, N*N*N*N>;
     using QFrameArray = std::array<std::unique_ptr<QFrame>, N*N*(N-1)*2>;
 
     using HLineArray = std::array<std::unique_ptr<QFrame>, N+1>;
@@ -37,10 +56,15 @@ public:
     explicit SudokuBoardWidget(QWidget *parent = nullptr):
         SudokuBoardWidgetBase(parent),
         m_board(),
+        m_hintEngine(),
         m_tileWidgetArray(),
+        m_startTiles(),
         m_hlineFrameArray(),
         m_vlineFrameArray(),
-        m_gridLayout(new QGridLayout)
+        m_gridLayout(new QGridLayout),
+        m_updatingTiles(false),
+        m_solveIsCurrent(false),
+        m_hintEliminations(false)
     {
 
         // Initialise the tile widgets and add them to the layout
@@ -56,7 +80,12 @@ public:
             int xPosModified = xPos + xPos / N +1; // if xp is 5 and N is 3, xpm = 5 + 1
             int yPosModified = yPos + yPos / N +1;
             m_gridLayout->addWidget(m_tileWidgetArray[index].get(), xPosModified, yPosModified);
+
+            // Connected after the tile's own handler, so the state set here is the one that stays
+            QObject::connect(m_tileWidgetArray[index].get(), static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+                             this, [this, index](int value) { tileEdited(index, value); });
         }
+        refreshAllCandidates();
 
 
         // Initialise the hline frame array and add them to the layout
@@ -103,21 +132,76 @@ protected:
     void clear() override final
     {
         m_board.clearAll();
+        m_updatingTiles = true;
         clearTileWidgetValues();
+        m_updatingTiles = false;
+        m_startTiles.fill(false);
+        m_solveIsCurrent = false;
+        m_hintEliminations = false;
+        refreshAllCandidates();
     }
     // Zero all tiles not marked as start tiles
     void reset() override final
     {
-        m_board.clearAll();
+        m_updatingTiles = true;
         resetTileWidgetValues();
+        m_updatingTiles = false;
+        rebuildBoard();
+        m_solveIsCurrent = false;
+        refreshAllTiles();
     }
+    // The board already matches the tiles, so there's nothing to rebuild; conflicts are already
+    // coloured and can't be solved, and a board that hasn't changed has already been solved.
     void solve() override final
     {
-        updateBoardValues();
+        if (m_solveIsCurrent)
+        {
+            emit solveRefused(QStringLiteral("Already solved: change a tile to solve again."));
+            return;
+        }
+        if (!m_board.isConsistent())
+        {
+            refreshAllTiles();
+            emit solveRefused(hasConflict()
+                ? QStringLiteral("Can't solve: the red tiles repeat a digit in a row, column or box.")
+                : QStringLiteral("Can't solve: an empty tile has no digit left it could be."));
+            return;
+        }
+
         colourStartTiles();
-        m_board.solveAll();
+        SudokuSolutionCache<N>::shared().solve(m_board);
+        m_updatingTiles = true;
         updateTileWidgetValues();
+        m_updatingTiles = false;
         colourUnsolvedTiles();
+
+        // Only the solved tiles are on show, so that is what the board keeps, without the candidates
+        // the solver ruled out on the way
+        rebuildBoard();
+        m_solveIsCurrent = true;
+        refreshAllCandidates();
+    }
+    // Take the simplest next step and say why
+    void hint() override final
+    {
+        SudokuHint const step{ m_hintEngine.next(m_board) };
+        if (step.kind == SudokuHintKind::NakedSingle || step.kind == SudokuHintKind::HiddenSingle)
+        {
+            // through the tile, so it goes on the board like any edit
+            m_tileWidgetArray[step.tile]->setValue(static_cast<int>(step.value));
+        }
+        else if (step.kind == SudokuHintKind::Elimination)
+        {
+            for (auto const& elimination : step.eliminations)
+            {
+                std::size_t const xPosition{ elimination.tile / (N*N) };
+                std::size_t const yPosition{ elimination.tile % (N*N) };
+                m_board.eliminateTileCandidates(xPosition, yPosition, static_cast<typename SudokuBoard<N>::mask_type>(elimination.values));
+                refreshTile(xPosition, yPosition);
+            }
+            m_hintEliminations = true;
+        }
+        emit hintGiven(QString::fromStdString(step.text));
     }
 
 private:
@@ -143,7 +227,7 @@ private:
     {
         for (std::size_t index = 0, end = m_tileWidgetArray.size(); index != end; ++index)
         {
-            if (m_tileWidgetArray[index]->getState() == SudokuTileState::Start)
+            if (m_startTiles[index])
             {
                 m_tileWidgetArray[index]->setState(SudokuTileState::Solved);
             }
@@ -161,11 +245,19 @@ private:
     {
         for (std::size_t index = 0, end = m_tileWidgetArray.size(); index != end; ++index)
         {
-            if (m_tileWidgetArray[index]->getState() != SudokuTileState::Start)
+            if (!m_startTiles[index])
                 m_tileWidgetArray[index]->setValue(static_cast<int>(m_board.getTileSolution(index / (N*N), index % (N*N))));
         }
     }
 
+    // Start the board again from the tiles' values, dropping any eliminations made on it
+    void rebuildBoard()
+    {
+        m_board.clearAll();
+        updateBoardValues();
+        m_hintEliminations = false;
+    }
+
     // Set the board to use the data in the QSpinBoxes
     void updateBoardValues()
     {
@@ -175,11 +267,93 @@ private:
         }
     }
 
+    // The user changed a tile: change it on the board and look again at its row, column and square,
+    // the only tiles whose candidates or conflicts it can affect
+    void tileEdited(std::size_t index, int value)
+    {
+        if (m_updatingTiles)
+            return;
+
+        std::size_t const xPosition{ index / (N*N) };
+        std::size_t const yPosition{ index % (N*N) };
+        m_solveIsCurrent = false;
+        // A given the user has changed is theirs now, and Reset clears it like any other
+        m_startTiles[index] = false;
+        // Hint eliminations may rest on the digit that was here, so they can't be kept
+        if (m_hintEliminations && m_board.getTileSolution(xPosition, yPosition) != 0)
+        {
+            rebuildBoard();
+            refreshAllTiles();
+            return;
+        }
+        m_board.setTileSolution(xPosition, yPosition, static_cast<std::size_t>(value));
+
+        std::size_t const xSquare{ xPosition / N * N };
+        std::size_t const ySquare{ yPosition / N * N };
+        for (std::size_t unitIndex = 0; unitIndex != N*N; ++unitIndex)
+        {
+            refreshTile(xPosition, unitIndex);
+            refreshTile(unitIndex, yPosition);
+            refreshTile(xSquare + unitIndex / N, ySquare + unitIndex % N);
+        }
+    }
+
+    // Colour a tile for a conflict or for having no candidates left, and update its count
+    void refreshTile(std::size_t xPosition, std::size_t yPosition)
+    {
+        SudokuTileWidget& tileWidget = *m_tileWidgetArray[xPosition * N*N + yPosition];
+        std::size_t const candidateCount{ popCount(m_board.getTileCandidates(xPosition, yPosition)) };
+        tileWidget.setCandidateCount(candidateCount);
+
+        SudokuTileState const state{ tileWidget.getState() };
+        SudokuTileState newState{ state };
+        if (tileWidget.value() != 0)
+        {
+            if (m_board.isTileConflicting(xPosition, yPosition))
+                newState = SudokuTileState::Conflict;
+            else if (state == SudokuTileState::Conflict)
+                newState = m_startTiles[xPosition * N*N + yPosition] ? SudokuTileState::Start : SudokuTileState::Solved;
+        }
+        else
+        {
+            newState = candidateCount == 0 ? SudokuTileState::Unsolved : SudokuTileState::Empty;
+        }
+        if (newState != state)
+            tileWidget.setState(newState);
+    }
+
+    // Look again at every tile's colour and count
+    void refreshAllTiles()
+    {
+        for (std::size_t index = 0, end = m_tileWidgetArray.size(); index != end; ++index)
+            refreshTile(index / (N*N), index % (N*N));
+    }
+
+    // Is any tile solved as a digit another tile in one of its units has?
+    bool hasConflict() const
+    {
+        for (std::size_t index = 0, end = m_tileWidgetArray.size(); index != end; ++index)
+        {
+            if (m_board.isTileConflicting(index / (N*N), index % (N*N)))
+                return true;
+        }
+        return false;
+    }
+
+    // Update every tile's candidate count, leaving the colours alone
+    void refreshAllCandidates()
+    {
+        for (std::size_t index = 0, end = m_tileWidgetArray.size(); index != end; ++index)
+            m_tileWidgetArray[index]->setCandidateCount(popCount(m_board.getTileCandidates(index / (N*N), index % (N*N))));
+    }
+
+    // Mark the tiles solved before a solve as the puzzle's givens
     void colourStartTiles()
     {
         for (std::size_t index = 0, end = m_tileWidgetArray.size(); index != end; ++index)
         {
-            if (m_board.getTileSolution(index / (N*N), index % (N*N)) != 0)
+            m_startTiles[index] = m_board.getTileSolution(index / (N*N), index % (N*N)) != 0;
+            if (m_startTiles[index])
                 m_tileWidgetArray[index]->setState(SudokuTileState::Start);
         }
     }
@@ -198,10 +372,15 @@ private:
     //============================================================
 
     SudokuBoard<N> m_board;
+    SudokuHintEngine<N> m_hintEngine;
     SudokuTileWidgetArray m_tileWidgetArray;
+    StartTileArray m_startTiles;    // the givens at the last solve, whatever colour they have now
     HLineArray m_hlineFrameArray;
     VLineArray m_vlineFrameArray;
     std::unique_ptr<QGridLayout> m_gridLayout;
+    bool m_updatingTiles;       // the tiles are being set from the board, so don't copy them back
+    bool m_solveIsCurrent;      // nothing has changed since the last solve
+    bool m_hintEliminations;    // hints have made eliminations since the board was last rebuilt
 };
 
 
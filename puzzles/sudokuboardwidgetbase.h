@@ -6,7 +6,11 @@ abstract class SudokuBoardWidgetBase
 Abstract base class for SudokuBoardWidget<N> so it can be manipulated without knowing the true type.
 Why? SudokuSolverDialog doesn't need to know the details of data input of layout, but does need
 access to generic actions that apply regardless of the size of the board.
+
+A hint is reported back through hintGiven(), with the sentence explaining it, and a solve that
+can't go ahead through solveRefused(), with the reason.
 */
+#include <QString>
 #include <QWidget>
 #include "sudokutileposition.h"
 
@@ -37,6 +41,13 @@ public slots:
     void slot_clear()   { this->clear(); }
     void slot_reset()   { this->reset(); }
     void slot_solve()   { this->solve(); }
+    void slot_hint()    { this->hint(); }
+
+    // Signals
+    //============================================================
+signals:
+    void hintGiven(QString const& text);
+    void solveRefused(QString const& reason);
 
 protected:
     // Virtual Functions
@@ -44,6 +55,7 @@ protected:
     virtual void clear() = 0;
     virtual void reset() = 0;
     virtual void solve()  = 0;
+    virtual void hint()  = 0;
 };
 
 } // namespace puzzles
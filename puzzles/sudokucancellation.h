@@ -0,0 +1,133 @@
+#ifndef SUDOKUCANCELLATION_H
+#define SUDOKUCANCELLATION_H
+/*
+class SudokuCancellationToken
+====================================================================================================
+A flag shared between everyone holding a copy of the token, and optionally a deadline. Solvers call
+shouldStop() at their propagation and branch points and stop early once the token is cancelled or
+its deadline has passed. That is a relaxed atomic load per token in the chain, plus a read of the
+steady clock while a deadline is pending, so it can be done often; once a deadline has passed it is
+remembered and the clock isn't read again.
+
+A token made with linkedTo(parent) also stops when its parent does, but cancelling it leaves the
+parent alone. That lets a caller cancel a group of solves while the group cancels its own members,
+or give one solve a tighter deadline than the rest.
+*/
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace puzzles
+{
+
+class SudokuCancellationToken
+{
+public:
+    // Typedefs
+    //============================================================
+    using clock_type = std::chrono::steady_clock;
+
+    // Special 6
+    //============================================================
+    SudokuCancellationToken() :
+        m_state(std::make_shared<State>())
+    {}
+
+    // Implicit default copy and move: copies share the flag
+
+    // A new token that stops once this time has passed
+    static SudokuCancellationToken withDeadline(clock_type::time_point deadline)
+    {
+        SudokuCancellationToken result{};
+        result.m_state->hasDeadline = true;
+        result.m_state->deadline = deadline;
+        return result;
+    }
+
+    // A new token that is cancelled along with the parent
+    static SudokuCancellationToken linkedTo(SudokuCancellationToken const& parent)
+    {
+        SudokuCancellationToken result{};
+        result.m_state->parent = parent.m_state;
+        return result;
+    }
+    // ...and also stops once this time has passed
+    static SudokuCancellationToken linkedTo(SudokuCancellationToken const& parent, clock_type::time_point deadline)
+    {
+        SudokuCancellationToken result{ withDeadline(deadline) };
+        result.m_state->parent = parent.m_state;
+        return result;
+    }
+
+    // Interface
+    //============================================================
+    void cancel() const
+    {
+        m_state->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    // Has this token or a parent been cancelled?
+    bool isCancelled() const
+    {
+        for (State const* state = m_state.get(); state != nullptr; state = state->parent.get())
+        {
+            if (state->cancelled.load(std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    // Has the deadline of this token or a parent passed?
+    bool hasExpired() const
+    {
+        for (State const* state = m_state.get(); state != nullptr; state = state->parent.get())
+        {
+            if (state->expired())
+                return true;
+        }
+        return false;
+    }
+
+    // Either of the above
+    bool shouldStop() const
+    {
+        for (State const* state = m_state.get(); state != nullptr; state = state->parent.get())
+        {
+            if (state->cancelled.load(std::memory_order_relaxed) || state->expired())
+                return true;
+        }
+        return false;
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    struct State
+    {
+        bool expired() const
+        {
+            if (!hasDeadline)
+                return false;
+            if (passed.load(std::memory_order_relaxed))
+                return true;
+            if (clock_type::now() < deadline)
+                return false;
+            passed.store(true, std::memory_order_relaxed);
+            return true;
+        }
+
+        std::atomic<bool> cancelled{ false };
+        mutable std::atomic<bool> passed{ false };
+        bool hasDeadline{ false };
+        clock_type::time_point deadline{};
+        std::shared_ptr<State const> parent{};
+    };
+
+    // Data Members
+    //============================================================
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUCANCELLATION_H
@@ -0,0 +1,577 @@
+#ifndef SUDOKUCANONICALFORM_H
+#define SUDOKUCANONICALFORM_H
+/*
+struct SudokuCanonicalHash
+====================================================================================================
+128 bit hash of a canonical puzzle, stored as two 64 bit halves so it can be used as a map key or
+cut down to 64 bits by just using low.
+
+class SudokuSymmetry<N>
+====================================================================================================
+One element of the Sudoku symmetry group: an optional transposition, an ordering of the rows and
+columns that keeps bands and stacks together, and a relabelling of the digits. It maps a board to
+its canonical position and maps a canonical board back to the original position.
+
+Canonical tile (row, column) holds digitMap[source(a, b)], where a = rowOrder[row] and
+b = columnOrder[column] after the source has been transposed (if transposed is true).
+
+class SudokuCanonicalForm<N>
+====================================================================================================
+The canonical representative of a puzzle along with its hash and the symmetry that takes the
+puzzle there. Two puzzles are the same up to symmetry if and only if their canonical values match.
+
+class SudokuCanonicaliser<N>
+====================================================================================================
+Computes the minlex canonical form of a puzzle. Empty tiles compare greater than any digit, so
+clues are pulled to the top left, and digits are relabelled in the order they are first read. The
+search builds the row ordering one row at a time, keeping only the candidate transforms that give
+the smallest prefix so far, which prunes the 2 * (N!)^(2N+2) group down to a handful of branches
+for real puzzles.
+
+The candidate buffers are kept between calls so canonicalising a stream of puzzles doesn't
+allocate once the buffers have grown.
+*/
+#include "sudokuboard.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace puzzles
+{
+
+struct SudokuCanonicalHash
+{
+    std::uint64_t high;
+    std::uint64_t low;
+};
+
+inline bool operator==(SudokuCanonicalHash lhs, SudokuCanonicalHash rhs) { return (lhs.high == rhs.high) && (lhs.low == rhs.low); }
+inline bool operator!=(SudokuCanonicalHash lhs, SudokuCanonicalHash rhs) { return !operator==(lhs, rhs); }
+inline bool operator<(SudokuCanonicalHash lhs, SudokuCanonicalHash rhs) { return (lhs.high < rhs.high) || (lhs.high == rhs.high && lhs.low < rhs.low); }
+
+template <std::size_t N>
+class SudokuSymmetry
+{
+public:
+    using value_array = std::array<std::size_t, N*N*N*N>;
+    using order_array = std::array<std::size_t, N*N>;
+    using digit_array = std::array<std::size_t, N*N + 1>;
+
+    // Special 6
+    //============================================================
+    // The identity transform
+    SudokuSymmetry() :
+        m_transposed{ false },
+        m_rowOrder(),
+        m_columnOrder(),
+        m_digitMap()
+    {
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            m_rowOrder[index] = index;
+            m_columnOrder[index] = index;
+        }
+        for (std::size_t digit = 0; digit != N*N + 1; ++digit)
+            m_digitMap[digit] = digit;
+    }
+    SudokuSymmetry(bool transposed, order_array const& rowOrder, order_array const& columnOrder, digit_array const& digitMap) :
+        m_transposed{ transposed },
+        m_rowOrder(rowOrder),
+        m_columnOrder(columnOrder),
+        m_digitMap(digitMap)
+    {}
+
+    // Interface
+    //============================================================
+    bool transposed() const                 { return m_transposed; }
+    order_array const& rowOrder() const     { return m_rowOrder; }
+    order_array const& columnOrder() const  { return m_columnOrder; }
+    digit_array const& digitMap() const     { return m_digitMap; }
+
+    // Take values in the original position to the canonical position
+    value_array apply(value_array const& values) const
+    {
+        value_array result{};
+        for (std::size_t row = 0; row != N*N; ++row)
+        {
+            for (std::size_t column = 0; column != N*N; ++column)
+            {
+                result[row * N*N + column] = m_digitMap[values[sourceIndex(row, column)]];
+            }
+        }
+        return result;
+    }
+
+    // Take values in the canonical position back to the original position
+    value_array applyInverse(value_array const& values) const
+    {
+        // invert the digit map, 0 always maps to 0
+        digit_array inverseDigitMap{};
+        for (std::size_t digit = 0; digit != N*N + 1; ++digit)
+            inverseDigitMap[m_digitMap[digit]] = digit;
+
+        value_array result{};
+        for (std::size_t row = 0; row != N*N; ++row)
+        {
+            for (std::size_t column = 0; column != N*N; ++column)
+            {
+                result[sourceIndex(row, column)] = inverseDigitMap[values[row * N*N + column]];
+            }
+        }
+        return result;
+    }
+
+    SudokuBoard<N> apply(SudokuBoard<N> const& board) const
+    {
+        return SudokuBoard<N>(apply(board.getTileSolutions()));
+    }
+    SudokuBoard<N> applyInverse(SudokuBoard<N> const& board) const
+    {
+        return SudokuBoard<N>(applyInverse(board.getTileSolutions()));
+    }
+
+private:
+    // Helpers
+    //============================================================
+    // Index in the original values of canonical tile (row, column)
+    std::size_t sourceIndex(std::size_t row, std::size_t column) const
+    {
+        if (m_transposed)
+            return m_columnOrder[column] * N*N + m_rowOrder[row];
+        else
+            return m_rowOrder[row] * N*N + m_columnOrder[column];
+    }
+
+    // Data Members
+    //============================================================
+    bool m_transposed;
+    order_array m_rowOrder;
+    order_array m_columnOrder;
+    digit_array m_digitMap;
+};
+
+template <std::size_t N>
+class SudokuCanonicalForm
+{
+public:
+    using value_array = std::array<std::size_t, N*N*N*N>;
+
+    // Special 6
+    //============================================================
+    SudokuCanonicalForm() = default;
+    SudokuCanonicalForm(value_array const& values, SudokuSymmetry<N> const& symmetry) :
+        m_values(values),
+        m_symmetry(symmetry),
+        m_hash(hashValues(values))
+    {}
+
+    // Interface
+    //============================================================
+    value_array const& values() const           { return m_values; }
+    SudokuSymmetry<N> const& symmetry() const   { return m_symmetry; }
+    SudokuCanonicalHash hash() const            { return m_hash; }
+
+    // The canonical puzzle as a board
+    SudokuBoard<N> board() const
+    {
+        return SudokuBoard<N>(m_values);
+    }
+
+    // Two independent 64 bit mixes over the values, seeded with the board size so different sizes
+    // never share a hash.
+    static SudokuCanonicalHash hashValues(value_array const& values)
+    {
+        // FNV-1a for the low half
+        std::uint64_t low{ 14695981039346656037ull ^ N };
+        // multiply-rotate for the high half
+        std::uint64_t high{ 0x9E3779B97F4A7C15ull * (N + 1) };
+        for (auto value : values)
+        {
+            low ^= static_cast<std::uint64_t>(value);
+            low *= 1099511628211ull;
+
+            high += static_cast<std::uint64_t>(value) + 1;
+            high *= 0xBF58476D1CE4E5B9ull;
+            high ^= high >> 31;
+        }
+        // finalise so that short differences spread over all the bits
+        high ^= high >> 30;
+        high *= 0x94D049BB133111EBull;
+        high ^= high >> 31;
+        return SudokuCanonicalHash{ high, low };
+    }
+
+private:
+    // Data Members
+    //============================================================
+    value_array m_values;
+    SudokuSymmetry<N> m_symmetry;
+    SudokuCanonicalHash m_hash;
+};
+
+template <std::size_t N>
+class SudokuCanonicaliser
+{
+    static_assert(N*N < 255, "SudokuCanonicaliser stores values in bytes so N*N must be less than 255.");
+
+public:
+    using value_array = std::array<std::size_t, N*N*N*N>;
+
+    // Special 6
+    //============================================================
+    SudokuCanonicaliser() = default;
+
+    // Interface
+    //============================================================
+    SudokuCanonicalForm<N> canonicalise(SudokuBoard<N> const& board)
+    {
+        return canonicalise(board.getTileSolutions());
+    }
+
+    SudokuCanonicalForm<N> canonicalise(value_array const& values)
+    {
+        loadGrids(values);
+
+        // An empty board is its own canonical form, and trying to rank its transforms would
+        // visit the whole group.
+        if (m_clueCount == 0)
+            return SudokuCanonicalForm<N>(value_array{}, SudokuSymmetry<N>());
+
+        m_candidates.clear();
+        chooseFirstRow();
+
+        // Add rows until every row has been placed
+        std::size_t depth{ 1 };
+        while (depth != N*N)
+            depth = chooseNextRow(depth);
+
+        return makeForm(m_candidates.front());
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    // Empty tiles read as this so they sort after every digit
+    static std::uint8_t emptyCode() { return static_cast<std::uint8_t>(N*N + 1); }
+
+    using byte_grid = std::array<std::array<std::uint8_t, N*N>, N*N>;
+    using row_string = std::array<std::uint8_t, N*N>;
+
+    // A partially built transform
+    struct Candidate
+    {
+        std::size_t transposed;
+        std::array<std::uint8_t, N*N> rowOrder;
+        std::array<std::uint8_t, N*N> columnOrder;
+        std::array<std::uint8_t, N*N + 1> digitMap;
+        std::uint8_t nextDigit;
+        std::array<bool, N*N> rowUsed;
+    };
+
+    // Helpers
+    //============================================================
+    // Store the values as bytes, once as given and once transposed
+    void loadGrids(value_array const& values)
+    {
+        m_clueCount = 0;
+        for (std::size_t row = 0; row != N*N; ++row)
+        {
+            for (std::size_t column = 0; column != N*N; ++column)
+            {
+                std::size_t value{ values[row * N*N + column] };
+                std::uint8_t byte{ static_cast<std::uint8_t>(value <= N*N ? value : 0) };
+                m_grids[0][row][column] = byte;
+                m_grids[1][column][row] = byte;
+                if (byte != 0)
+                    ++m_clueCount;
+            }
+        }
+        for (std::size_t transposed = 0; transposed != 2; ++transposed)
+        {
+            for (std::size_t column = 0; column != N*N; ++column)
+            {
+                m_columnEmpty[transposed][column] = true;
+                for (std::size_t row = 0; row != N*N; ++row)
+                    if (m_grids[transposed][row][column] != 0)
+                        m_columnEmpty[transposed][column] = false;
+            }
+        }
+    }
+
+    // Pick the first row and every column ordering that gives the smallest possible first row.
+    // Digits in one row are all different, so the first row only depends on which tiles are
+    // clues: the best arrangement puts the stacks with the most clues first and the clues first
+    // within each stack. Any reordering within those groups ties.
+    void chooseFirstRow()
+    {
+        row_string best{};
+        best.fill(emptyCode());
+        bool haveBest{ false };
+
+        for (std::size_t transposed = 0; transposed != 2; ++transposed)
+        {
+            for (std::size_t row = 0; row != N*N; ++row)
+            {
+                std::array<std::size_t, N> stackOrder{};
+                std::array<std::size_t, N> clueCounts{};
+                sortStacks(m_grids[transposed][row], stackOrder, clueCounts);
+
+                // build the row string this gives
+                row_string rowString{};
+                std::uint8_t nextDigit{ 1 };
+                for (std::size_t stack = 0; stack != N; ++stack)
+                {
+                    for (std::size_t offset = 0; offset != N; ++offset)
+                        rowString[stack * N + offset] = (offset < clueCounts[stackOrder[stack]] ? nextDigit++ : emptyCode());
+                }
+
+                if (!haveBest || rowString < best)
+                {
+                    best = rowString;
+                    haveBest = true;
+                    m_candidates.clear();
+                }
+                if (rowString == best)
+                    addFirstRowCandidates(transposed, row, stackOrder, clueCounts);
+            }
+        }
+    }
+
+    // Order stacks by clue count (most first), ties broken by stacks with clues anywhere in the
+    // grid going first, then by index.
+    void sortStacks(row_string const& rowValues, std::array<std::size_t, N>& stackOrder, std::array<std::size_t, N>& clueCounts) const
+    {
+        for (std::size_t stack = 0; stack != N; ++stack)
+        {
+            stackOrder[stack] = stack;
+            clueCounts[stack] = 0;
+            for (std::size_t offset = 0; offset != N; ++offset)
+                if (rowValues[stack * N + offset] != 0)
+                    ++clueCounts[stack];
+        }
+        std::stable_sort(stackOrder.begin(), stackOrder.end(),
+                         [&clueCounts](std::size_t lhs, std::size_t rhs) { return clueCounts[lhs] > clueCounts[rhs]; });
+    }
+
+    // Enumerate the column orderings that tie for the first row
+    void addFirstRowCandidates(std::size_t transposed, std::size_t row, std::array<std::size_t, N> stackOrder, std::array<std::size_t, N> const& clueCounts)
+    {
+        row_string const& rowValues = m_grids[transposed][row];
+        auto const& columnEmpty = m_columnEmpty[transposed];
+
+        // Within a stack: clue columns, then columns empty in this row but not the whole grid,
+        // then columns empty in the whole grid. Columns with nothing in them are all the same, so
+        // they stay in index order rather than being permuted.
+        std::array<std::array<std::uint8_t, N>, N> stackColumns{};
+        std::array<std::size_t, N> partialEnds{};
+        std::array<bool, N> stackEmpty{};
+        for (std::size_t stack = 0; stack != N; ++stack)
+        {
+            std::size_t count{ 0 };
+            stackEmpty[stack] = true;
+            for (std::size_t offset = 0; offset != N; ++offset)
+                if (rowValues[stack * N + offset] != 0)
+                    stackColumns[stack][count++] = static_cast<std::uint8_t>(stack * N + offset);
+            for (std::size_t offset = 0; offset != N; ++offset)
+                if (rowValues[stack * N + offset] == 0 && !columnEmpty[stack * N + offset])
+                    stackColumns[stack][count++] = static_cast<std::uint8_t>(stack * N + offset);
+            partialEnds[stack] = count;
+            for (std::size_t offset = 0; offset != N; ++offset)
+                if (columnEmpty[stack * N + offset])
+                    stackColumns[stack][count++] = static_cast<std::uint8_t>(stack * N + offset);
+                else
+                    stackEmpty[stack] = false;
+        }
+
+        // Likewise stacks with nothing in them go last among the stacks they tie with
+        std::stable_sort(stackOrder.begin(), stackOrder.end(),
+                         [&clueCounts, &stackEmpty](std::size_t lhs, std::size_t rhs)
+        {
+            return clueCounts[lhs] > clueCounts[rhs] || (clueCounts[lhs] == clueCounts[rhs] && !stackEmpty[lhs] && stackEmpty[rhs]);
+        });
+
+        // Collect the ranges that can be permuted freely
+        m_ranges.clear();
+        for (std::size_t begin = 0; begin != N; )
+        {
+            std::size_t end{ begin + 1 };
+            while (end != N && clueCounts[stackOrder[end]] == clueCounts[stackOrder[begin]] && stackEmpty[stackOrder[end]] == stackEmpty[stackOrder[begin]])
+                ++end;
+            if (!stackEmpty[stackOrder[begin]])
+                m_ranges.emplace_back(stackOrder.data() + begin, stackOrder.data() + end);
+            begin = end;
+        }
+        std::array<std::size_t, N*N> stackColumnsWide{};
+        for (std::size_t stack = 0; stack != N; ++stack)
+        {
+            for (std::size_t offset = 0; offset != N; ++offset)
+                stackColumnsWide[stack * N + offset] = stackColumns[stack][offset];
+            std::size_t* base{ stackColumnsWide.data() + stack * N };
+            m_ranges.emplace_back(base, base + clueCounts[stack]);
+            m_ranges.emplace_back(base + clueCounts[stack], base + partialEnds[stack]);
+        }
+        for (auto& range : m_ranges)
+            std::sort(range.first, range.second);
+
+        // Odometer over the permutations of every range
+        do
+        {
+            Candidate candidate{};
+            candidate.transposed = transposed;
+            candidate.rowOrder[0] = static_cast<std::uint8_t>(row);
+            candidate.rowUsed.fill(false);
+            candidate.rowUsed[row] = true;
+            candidate.digitMap.fill(0);
+            candidate.nextDigit = 1;
+            for (std::size_t stack = 0; stack != N; ++stack)
+                for (std::size_t offset = 0; offset != N; ++offset)
+                    candidate.columnOrder[stack * N + offset] = static_cast<std::uint8_t>(stackColumnsWide[stackOrder[stack] * N + offset]);
+            for (std::size_t position = 0; position != N*N; ++position)
+            {
+                std::uint8_t value{ rowValues[candidate.columnOrder[position]] };
+                if (value != 0)
+                    candidate.digitMap[value] = candidate.nextDigit++;
+            }
+            m_candidates.push_back(candidate);
+        }
+        while (nextRangePermutation());
+    }
+
+    bool nextRangePermutation()
+    {
+        for (std::size_t index = m_ranges.size(); index != 0; --index)
+        {
+            if (std::next_permutation(m_ranges[index - 1].first, m_ranges[index - 1].second))
+                return true;
+        }
+        return false;
+    }
+
+    // Extend every candidate by one row, keeping those that give the smallest prefix. Returns the
+    // new depth, which can jump ahead when the rest of a band is empty.
+    std::size_t chooseNextRow(std::size_t depth)
+    {
+        bool const bandStart{ depth % N == 0 };
+        row_string best{};
+        bool haveBest{ false };
+        m_nextCandidates.clear();
+
+        for (auto const& candidate : m_candidates)
+        {
+            auto const& grid = m_grids[candidate.transposed];
+            std::size_t const band{ candidate.rowOrder[depth - 1] / N };
+            std::size_t const rowBegin{ bandStart ? 0 : band * N };
+            std::size_t const rowEnd{ bandStart ? N*N : band * N + N };
+
+            for (std::size_t row = rowBegin; row != rowEnd; ++row)
+            {
+                if (candidate.rowUsed[row])
+                    continue;
+
+                // Read the row through this candidate, comparing as we go
+                std::array<std::uint8_t, N*N + 1> digitMap(candidate.digitMap);
+                std::uint8_t nextDigit{ candidate.nextDigit };
+                row_string rowString{};
+                int comparison{ haveBest ? 0 : -1 };
+                for (std::size_t position = 0; position != N*N; ++position)
+                {
+                    std::uint8_t value{ grid[row][candidate.columnOrder[position]] };
+                    std::uint8_t code{ emptyCode() };
+                    if (value != 0)
+                    {
+                        if (digitMap[value] == 0)
+                            digitMap[value] = nextDigit++;
+                        code = digitMap[value];
+                    }
+                    rowString[position] = code;
+                    if (comparison == 0)
+                    {
+                        if (code > best[position])
+                        {
+                            comparison = 1;
+                            break;
+                        }
+                        if (code < best[position])
+                            comparison = -1;
+                    }
+                }
+                if (comparison > 0)
+                    continue;
+                if (comparison < 0)
+                {
+                    best = rowString;
+                    haveBest = true;
+                    m_nextCandidates.clear();
+                }
+
+                Candidate next(candidate);
+                next.rowOrder[depth] = static_cast<std::uint8_t>(row);
+                next.rowUsed[row] = true;
+                next.digitMap = digitMap;
+                next.nextDigit = nextDigit;
+                m_nextCandidates.push_back(next);
+            }
+        }
+        std::swap(m_candidates, m_nextCandidates);
+
+        // Empty rows sort last, so if the best row is empty then so is every row still allowed
+        // here: at the start of a band that is every remaining row, otherwise it is the rest of
+        // this band. Their order makes no difference, so place them all at once.
+        if (std::find_if(best.cbegin(), best.cend(), [](std::uint8_t code) { return code != emptyCode(); }) != best.cend())
+            return depth + 1;
+
+        std::size_t const end{ bandStart ? N*N : (depth / N + 1) * N };
+        for (auto& candidate : m_candidates)
+        {
+            std::size_t const band{ candidate.rowOrder[depth] / N };
+            std::size_t fill{ depth + 1 };
+            for (std::size_t row = 0; row != N*N && fill != end; ++row)
+            {
+                if (!candidate.rowUsed[row] && (bandStart || row / N == band))
+                {
+                    candidate.rowOrder[fill++] = static_cast<std::uint8_t>(row);
+                    candidate.rowUsed[row] = true;
+                }
+            }
+        }
+        return end;
+    }
+
+    SudokuCanonicalForm<N> makeForm(Candidate const& candidate) const
+    {
+        typename SudokuSymmetry<N>::order_array rowOrder{};
+        typename SudokuSymmetry<N>::order_array columnOrder{};
+        typename SudokuSymmetry<N>::digit_array digitMap{};
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            rowOrder[index] = candidate.rowOrder[index];
+            columnOrder[index] = candidate.columnOrder[index];
+        }
+        // Digits that never appeared take the remaining labels in order
+        std::size_t nextDigit{ candidate.nextDigit };
+        for (std::size_t digit = 1; digit != N*N + 1; ++digit)
+            digitMap[digit] = (candidate.digitMap[digit] != 0 ? candidate.digitMap[digit] : nextDigit++);
+
+        SudokuSymmetry<N> symmetry(candidate.transposed != 0, rowOrder, columnOrder, digitMap);
+        value_array values{};
+        for (std::size_t row = 0; row != N*N; ++row)
+            for (std::size_t column = 0; column != N*N; ++column)
+                values[row * N*N + column] = digitMap[m_grids[candidate.transposed][candidate.rowOrder[row]][candidate.columnOrder[column]]];
+        return SudokuCanonicalForm<N>(values, symmetry);
+    }
+
+    // Data Members
+    //============================================================
+    std::array<byte_grid, 2> m_grids;
+    std::array<std::array<bool, N*N>, 2> m_columnEmpty;
+    std::size_t m_clueCount;
+    std::vector<Candidate> m_candidates;
+    std::vector<Candidate> m_nextCandidates;
+    std::vector<std::pair<std::size_t*, std::size_t*>> m_ranges;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUCANONICALFORM_H
@@ -0,0 +1,589 @@
+#include "sudokucommandline.h"
+
+#include "sudokubatchpipeline.h"
+#include "sudokubenchmark.h"
+#include "sudokucompletioncounter.h"
+#include "sudokucompressedinput.h"
+#include "sudokuperfcounters.h"
+#include "sudokupuzzletext.h"
+#include "sudokuruntimesolver.h"
+#include "sudokuserver.h"
+#include "sudokushardedbatch.h"
+#include "sudokusolutionstore.h"
+#include "sudokusolveservice.h"
+
+#include <QCoreApplication>
+#include <QLocalSocket>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // The options any mode might take; each mode uses the ones it needs
+    struct Settings
+    {
+        std::string socketName;
+        std::string inputName;
+        std::string outputName;
+        std::size_t workers;
+        std::chrono::milliseconds timeout;
+        std::size_t batchSize;
+        std::size_t cacheLimit;
+        std::string cacheFile;
+        puzzles::SudokuEngine engine;
+        std::string shardKey;
+        std::size_t shardIndex;
+        bool allEngines;
+    };
+
+    int usage()
+    {
+        std::cerr << "usage: sudoku_solver --serve [--socket <name>] [--workers <n>] [--timeout <ms>] [--batch <n>] [--cache-limit <n>] [--cache-file <file>]\n"
+                  << "       sudoku_solver --client <name> [file]\n"
+                  << "       sudoku_solver --batch [--input <file>] [--output <file>] [--workers <n>] [--batch-size <n>] [--timeout <ms>] [--cache-limit <n>] [--cache-file <file>] [--engine auto|propagation|sat|bitboard|local]\n"
+                  << "       sudoku_solver --shards --input <file> [--output <file>] [--workers <n>] [--batch-size <n>] [--timeout <ms>] [--cache-limit <n>] [--cache-file <file>] [--engine auto|propagation|sat|bitboard|local]\n"
+                  << "       sudoku_solver --benchmark [--input <file>] [--output <file>] [--timeout <ms>] [--engine auto|propagation|sat|bitboard|local|all]\n"
+                  << "       sudoku_solver --count [--input <file>] [--output <file>] [--workers <n>] [--timeout <ms>]\n";
+        return 2;
+    }
+
+    // Longer timeouts are cut to half the clock's range, around 146 years, so that adding one to
+    // now() can't overflow
+    std::chrono::milliseconds clampTimeout(unsigned long long milliseconds)
+    {
+        std::chrono::milliseconds const longest{ std::chrono::duration_cast<std::chrono::milliseconds>(clock_type::duration::max() / 2) };
+        return milliseconds > static_cast<unsigned long long>(longest.count()) ? longest : std::chrono::milliseconds{ milliseconds };
+    }
+
+    bool parseSettings(int argc, char* argv[], Settings& settings)
+    {
+        for (int index = 2; index < argc; index += 2)
+        {
+            if (index + 1 == argc)
+                return false;
+            std::string const name{ argv[index] };
+            std::string const value{ argv[index + 1] };
+            char* end{ nullptr };
+            unsigned long long const number{ std::strtoull(value.c_str(), &end, 10) };
+            bool const isNumber{ !value.empty() && *end == '\0' };
+
+            if (name == "--socket")
+                settings.socketName = value;
+            else if (name == "--input")
+                settings.inputName = value;
+            else if (name == "--output")
+                settings.outputName = value;
+            else if (name == "--workers" && isNumber)
+                settings.workers = static_cast<std::size_t>(number);
+            else if (name == "--timeout" && isNumber)
+                settings.timeout = clampTimeout(number);
+            else if ((name == "--batch" || name == "--batch-size") && isNumber && number != 0)
+                settings.batchSize = static_cast<std::size_t>(number);
+            else if (name == "--cache-limit" && isNumber)
+                settings.cacheLimit = static_cast<std::size_t>(number);
+            else if (name == "--cache-file")
+                settings.cacheFile = value;
+            else if (name == "--engine" && value == "auto")
+                settings.engine = puzzles::SudokuEngine::Automatic;
+            else if (name == "--engine" && value == "propagation")
+                settings.engine = puzzles::SudokuEngine::Propagation;
+            else if (name == "--engine" && value == "sat")
+                settings.engine = puzzles::SudokuEngine::Sat;
+            else if (name == "--engine" && value == "bitboard")
+                settings.engine = puzzles::SudokuEngine::Bitboard;
+            else if (name == "--engine" && value == "local")
+                settings.engine = puzzles::SudokuEngine::LocalSearch;
+            else if (name == "--engine" && value == "all")
+                settings.allEngines = true;
+            else if (name == "--shard-key")
+                settings.shardKey = value;
+            else if (name == "--shard-index" && isNumber)
+                settings.shardIndex = static_cast<std::size_t>(number);
+            else
+                return false;
+        }
+        return true;
+    }
+
+    // The shared caches load from and add to the store for as long as this lives. The file is
+    // optional: without it, or while another process has it, solving goes on without it.
+    class AttachedStore
+    {
+    public:
+        AttachedStore(std::string const& filePath, bool quiet) :
+            m_store()
+        {
+            if (filePath.empty())
+                return;
+            if (m_store.open(filePath))
+                puzzles::SudokuRuntimeSolver::attachStore(&m_store);
+            else if (!quiet)
+                std::cerr << "not keeping solutions in " << filePath << ": " << m_store.errorString() << '\n';
+        }
+        ~AttachedStore()
+        {
+            if (m_store.isOpen())
+                puzzles::SudokuRuntimeSolver::attachStore(nullptr);
+        }
+
+        AttachedStore(AttachedStore const& other) = delete;
+        AttachedStore& operator=(AttachedStore const& other) = delete;
+
+    private:
+        puzzles::SudokuSolutionStore m_store;
+    };
+
+    // The hardware counters per puzzle, or why there are none
+    std::string countersSummary(puzzles::SudokuPerfSample const& counters, std::size_t puzzles)
+    {
+        if (counters.counted != 0)
+            return puzzles::SudokuPerfCounters::format(counters, puzzles) + " per puzzle";
+        return "hardware counters unavailable: " + puzzles::SudokuPerfCounters{}.errorString();
+    }
+
+    void configure(puzzles::SudokuSolveService& service, Settings const& settings)
+    {
+        service.setDefaultTimeout(settings.timeout);
+        service.setBatchSize(settings.batchSize);
+        service.setCacheLimit(settings.cacheLimit);
+    }
+
+    // Requests from stdin, responses to stdout as they finish
+    int serveStandardStreams(Settings const& settings)
+    {
+        std::ios::sync_with_stdio(false);
+        std::mutex outputMutex{};
+        puzzles::SudokuSolveService service{ settings.workers, [&outputMutex](std::uint64_t, std::string const& response)
+        {
+            std::lock_guard<std::mutex> lock{ outputMutex };
+            std::cout << response << '\n' << std::flush;
+        }};
+        configure(service, settings);
+
+        std::string line{};
+        while (std::getline(std::cin, line))
+            service.submit(0, line);
+        service.waitUntilIdle();
+        return 0;
+    }
+
+    int serveSocket(int& argc, char* argv[], Settings const& settings)
+    {
+        QCoreApplication application(argc, argv);
+        puzzles::SudokuServer server{ settings.workers };
+        configure(server.service(), settings);
+        if (!server.listen(QString::fromStdString(settings.socketName)))
+        {
+            std::cerr << "cannot listen on " << settings.socketName << ": " << server.errorString().toStdString() << '\n';
+            return 1;
+        }
+        std::cerr << "listening on " << settings.socketName << " with " << server.service().workerCount() << " workers\n";
+        return application.exec();
+    }
+
+    // Puzzles from the input file or stdin through SudokuBatchPipeline, results to the output file or
+    // stdout, and a summary to stderr
+    int runBatch(Settings const& settings)
+    {
+        std::ifstream inputFile{};
+        std::ofstream outputFile{};
+        if (!settings.inputName.empty())
+        {
+            inputFile.open(settings.inputName, std::ios::binary);
+            if (!inputFile)
+            {
+                std::cerr << "cannot open " << settings.inputName << '\n';
+                return 1;
+            }
+        }
+        if (!settings.outputName.empty())
+        {
+            outputFile.open(settings.outputName, std::ios::binary);
+            if (!outputFile)
+            {
+                std::cerr << "cannot create " << settings.outputName << '\n';
+                return 1;
+            }
+        }
+        std::ios::sync_with_stdio(false);
+
+        puzzles::SudokuBatchPipeline pipeline{ settings.workers };
+        pipeline.setBatchSize(settings.batchSize);
+        pipeline.setTimeout(settings.timeout);
+        pipeline.setCacheLimit(settings.cacheLimit);
+        pipeline.setOptions(puzzles::SudokuSolveOptions{ settings.engine, 0 });
+
+        // Decompressed, if need be, on a thread of its own while the pipeline parses
+        puzzles::SudokuCompressedInput decompressor{ settings.inputName.empty() ? std::cin : static_cast<std::istream&>(inputFile) };
+        std::istream input{ &decompressor };
+        puzzles::SudokuBatchStatistics const statistics{ pipeline.run(
+            input, settings.outputName.empty() ? std::cout : static_cast<std::ostream&>(outputFile)) };
+
+        double const seconds{ std::chrono::duration<double>(statistics.wallTime).count() };
+        std::cerr << statistics.puzzles << " puzzles in " << statistics.batches << " batches on " << pipeline.solverCount()
+                  << " solvers: " << statistics.solved << " solved, " << statistics.unsolvable << " unsolvable, "
+                  << statistics.timedOut << " timed out, " << statistics.errors << " bad\n"
+                  << seconds << " s (" << (seconds > 0 ? static_cast<double>(statistics.puzzles) / seconds : 0.0)
+                  << " per second), " << std::chrono::duration<double>(statistics.solveTime).count() << " s solving, "
+                  << statistics.readerWaits << " reader waits, " << statistics.writerWaits << " writer waits\n"
+                  << countersSummary(statistics.counters, statistics.puzzles) << '\n';
+        if (decompressor.hasError())
+        {
+            std::cerr << "input ended early: " << decompressor.errorString() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+
+    // The same as runBatch, with the solving done by worker processes: this program again, run as
+    // --shard-worker
+    int runShards(int& argc, char* argv[], Settings const& settings)
+    {
+        std::ofstream outputFile{};
+        if (!settings.outputName.empty())
+        {
+            outputFile.open(settings.outputName, std::ios::binary);
+            if (!outputFile)
+            {
+                std::cerr << "cannot create " << settings.outputName << '\n';
+                return 1;
+            }
+        }
+        std::ios::sync_with_stdio(false);
+
+        QCoreApplication application(argc, argv);
+        puzzles::SudokuShardedBatch shards{ settings.workers };
+        shards.setWorkerCommand(QCoreApplication::applicationFilePath(),
+                                QStringList{ QStringLiteral("--shard-worker"),
+                                             QStringLiteral("--cache-file"), QString::fromStdString(settings.cacheFile) });
+        shards.setShardSize(settings.batchSize);
+        shards.setTimeout(settings.timeout);
+        shards.setCacheLimit(settings.cacheLimit);
+        shards.setOptions(puzzles::SudokuSolveOptions{ settings.engine, 0 });
+
+        puzzles::SudokuBatchStatistics statistics{};
+        if (!shards.run(QString::fromStdString(settings.inputName), settings.outputName.empty() ? std::cout : outputFile, statistics))
+        {
+            std::cerr << "cannot shard " << settings.inputName << ": " << shards.errorString().toStdString() << '\n';
+            return 1;
+        }
+
+        double const seconds{ std::chrono::duration<double>(statistics.wallTime).count() };
+        std::cerr << statistics.puzzles << " puzzles in " << statistics.batches << " shards on " << shards.workerCount()
+                  << " workers: " << statistics.solved << " solved, " << statistics.unsolvable << " unsolvable, "
+                  << statistics.timedOut << " timed out, " << statistics.errors << " bad\n"
+                  << seconds << " s (" << (seconds > 0 ? static_cast<double>(statistics.puzzles) / seconds : 0.0)
+                  << " per second), " << std::chrono::duration<double>(statistics.solveTime).count() << " s solving, "
+                  << statistics.readerWaits << " worker waits, " << statistics.writerWaits << " writer waits\n"
+                  << countersSummary(statistics.counters, statistics.puzzles) << '\n';
+        return 0;
+    }
+
+    // Puzzles from the input file or stdin through SudokuBenchmark, the report to the output file
+    // or stdout
+    int runBenchmark(Settings const& settings)
+    {
+        std::ifstream inputFile{};
+        std::ofstream outputFile{};
+        if (!settings.inputName.empty())
+        {
+            inputFile.open(settings.inputName, std::ios::binary);
+            if (!inputFile)
+            {
+                std::cerr << "cannot open " << settings.inputName << '\n';
+                return 1;
+            }
+        }
+        if (!settings.outputName.empty())
+        {
+            outputFile.open(settings.outputName, std::ios::binary);
+            if (!outputFile)
+            {
+                std::cerr << "cannot create " << settings.outputName << '\n';
+                return 1;
+            }
+        }
+
+        puzzles::SudokuBenchmark benchmark{};
+        benchmark.setTimeout(settings.timeout);
+        if (settings.allEngines)
+            benchmark.setEngines({ puzzles::SudokuEngine::Propagation, puzzles::SudokuEngine::Sat, puzzles::SudokuEngine::Bitboard });
+        else
+            benchmark.setEngines({ settings.engine });
+
+        puzzles::SudokuCompressedInput decompressor{ settings.inputName.empty() ? std::cin : static_cast<std::istream&>(inputFile) };
+        std::istream input{ &decompressor };
+        std::size_t const badLines{ benchmark.run(input, settings.outputName.empty() ? std::cout : static_cast<std::ostream&>(outputFile)) };
+        if (badLines != 0)
+            std::cerr << badLines << " lines were not puzzles\n";
+        if (decompressor.hasError())
+        {
+            std::cerr << "input ended early: " << decompressor.errorString() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+
+    // Count one puzzle's completions on a thread of its own, reporting progress to stderr each
+    // second while it runs, and write the count (- if it was cut short) and the puzzle. Counts
+    // that take under a second say nothing on stderr.
+    template <std::size_t N>
+    void countCompletions(std::vector<std::uint8_t> const& values, Settings const& settings, std::ostream& output)
+    {
+        puzzles::SudokuBoard<N> board{};
+        for (std::size_t tile = 0; tile != N*N*N*N; ++tile)
+        {
+            if (values[tile] != 0)
+                board.setTileSolution(tile / (N*N), tile % (N*N), values[tile]);
+        }
+        puzzles::SudokuCancellationToken const bounded{ settings.timeout.count() == 0 ? puzzles::SudokuCancellationToken{}
+                                                        : puzzles::SudokuCancellationToken::withDeadline(clock_type::now() + settings.timeout) };
+        puzzles::SudokuCompletionCounter<N> counter{};
+        counter.setThreadCount(settings.workers);
+
+        std::mutex doneMutex{};
+        std::condition_variable doneChanged{};
+        bool done{ false };
+        bool reported{ false };
+        std::thread counting{ [&]()
+        {
+            counter.count(board, bounded);
+            std::lock_guard<std::mutex> lock{ doneMutex };
+            done = true;
+            doneChanged.notify_one();
+        }};
+        {
+            std::unique_lock<std::mutex> lock{ doneMutex };
+            while (!doneChanged.wait_for(lock, std::chrono::seconds{ 1 }, [&done]() { return done; }))
+            {
+                typename puzzles::SudokuCompletionCounter<N>::Progress const progress{ counter.progress() };
+                std::cerr << "\r" << progress.partsDone << '/' << progress.parts << " parts, " << progress.nodes << " nodes, "
+                          << progress.memoHits << " memo hits, "
+                          << puzzles::SudokuCompletionCounter<N>::toString(progress.counted) << " so far" << std::flush;
+                reported = true;
+            }
+        }
+        counting.join();
+
+        if (counter.isFinished())
+            output << puzzles::SudokuCompletionCounter<N>::toString(counter.completions());
+        else
+            output << '-';
+        output << ' ' << puzzles::SudokuPuzzleText::format(values.data(), N) << '\n';
+        if (reported)
+            std::cerr << '\n';
+        if (!counter.isFinished())
+            std::cerr << "not counted: " << counter.errorString() << '\n';
+        else if (reported)
+            std::cerr << "counted in " << std::chrono::duration<double>(counter.elapsed()).count() << " s, "
+                      << counter.progress().nodes << " nodes, " << counter.progress().memoHits << " memo hits\n";
+    }
+
+    // Puzzles from the input file or stdin through SudokuCompletionCounter, the counts to the
+    // output file or stdout
+    int runCount(Settings const& settings)
+    {
+        std::ifstream inputFile{};
+        std::ofstream outputFile{};
+        if (!settings.inputName.empty())
+        {
+            inputFile.open(settings.inputName, std::ios::binary);
+            if (!inputFile)
+            {
+                std::cerr << "cannot open " << settings.inputName << '\n';
+                return 1;
+            }
+        }
+        if (!settings.outputName.empty())
+        {
+            outputFile.open(settings.outputName, std::ios::binary);
+            if (!outputFile)
+            {
+                std::cerr << "cannot create " << settings.outputName << '\n';
+                return 1;
+            }
+        }
+        std::ostream& output = settings.outputName.empty() ? std::cout : static_cast<std::ostream&>(outputFile);
+
+        puzzles::SudokuCompressedInput decompressor{ settings.inputName.empty() ? std::cin : static_cast<std::istream&>(inputFile) };
+        std::istream input{ &decompressor };
+        std::size_t badLines{ 0 };
+        std::string line{};
+        std::vector<std::uint8_t> values{};
+        while (std::getline(input, line))
+        {
+            std::size_t first{ 0 };
+            std::size_t length{ 0 };
+            if (!puzzles::SudokuPuzzleText::findPuzzle(line.data(), line.size(), first, length))
+                continue;
+            std::size_t boxSize{ 0 };
+            if (!puzzles::SudokuPuzzleText::parse(line.data() + first, length, values, boxSize))
+            {
+                ++badLines;
+                continue;
+            }
+
+            switch (boxSize)
+            {
+            case 2: countCompletions<2>(values, settings, output); break;
+            case 3: countCompletions<3>(values, settings, output); break;
+            case 4: countCompletions<4>(values, settings, output); break;
+            case 5: countCompletions<5>(values, settings, output); break;
+            case 6: countCompletions<6>(values, settings, output); break;
+            case 7: countCompletions<7>(values, settings, output); break;
+            case 8: countCompletions<8>(values, settings, output); break;
+            default: ++badLines; break;
+            }
+            output << std::flush;
+        }
+
+        if (badLines != 0)
+            std::cerr << badLines << " lines were not puzzles\n";
+        if (decompressor.hasError())
+        {
+            std::cerr << "input ended early: " << decompressor.errorString() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+
+    int runClient(std::string const& socketName, std::istream& input)
+    {
+        QLocalSocket socket{};
+        socket.connectToServer(QString::fromStdString(socketName));
+        if (!socket.waitForConnected(5000))
+        {
+            std::cerr << "cannot connect to " << socketName << ": " << socket.errorString().toStdString() << '\n';
+            return 1;
+        }
+
+        // Send everything up front so the server can batch it, remembering when each id went
+        clock_type::time_point const start{ clock_type::now() };
+        std::unordered_map<std::string, clock_type::time_point> sent{};
+        std::size_t duplicates{ 0 };
+        std::string line{};
+        while (std::getline(input, line))
+        {
+            std::size_t const idStart{ line.find_first_not_of(' ') };
+            if (idStart == std::string::npos || line[idStart] == '#')
+                continue;
+            // Responses are matched up by id, so a repeated one would be counted as answered twice
+            std::string const id{ line.substr(idStart, line.find(' ', idStart) - idStart) };
+            if (!sent.emplace(id, clock_type::now()).second)
+            {
+                std::cerr << "not sending " << id << " again: ids must be unique\n";
+                ++duplicates;
+                continue;
+            }
+            socket.write(line.data(), static_cast<qint64>(line.size()));
+            socket.write("\n", 1);
+        }
+        while (socket.bytesToWrite() > 0 && socket.waitForBytesWritten(-1)) {}
+
+        std::size_t received{ 0 };
+        std::size_t solved{ 0 };
+        while (received != sent.size())
+        {
+            if (!socket.canReadLine() && !socket.waitForReadyRead(-1))
+                break;
+            while (socket.canReadLine())
+            {
+                std::string const response{ socket.readLine().trimmed().toStdString() };
+                std::string const id{ response.substr(0, response.find(' ')) };
+                auto const found = sent.find(id);
+                auto const roundTrip = found == sent.end() ? clock_type::duration{ 0 } : clock_type::now() - found->second;
+                std::cout << response << " rtt_us="
+                          << std::chrono::duration_cast<std::chrono::microseconds>(roundTrip).count() << '\n';
+                ++received;
+                if (response.compare(id.size(), 8, " solved ") == 0)
+                    ++solved;
+            }
+        }
+
+        double const seconds{ std::chrono::duration<double>(clock_type::now() - start).count() };
+        std::cerr << received << " of " << sent.size() << " answered, " << solved << " solved in " << seconds << " s ("
+                  << (seconds > 0 ? static_cast<double>(received) / seconds : 0.0) << " per second)\n";
+        return received == sent.size() && duplicates == 0 ? 0 : 1;
+    }
+}
+
+// Interface
+//============================================================
+bool puzzles::SudokuCommandLine::handles(int argc, char* argv[])
+{
+    return argc > 1 && argv[1][0] == '-' && argv[1][1] == '-';
+}
+
+int puzzles::SudokuCommandLine::run(int& argc, char* argv[])
+{
+    std::string const mode{ argv[1] };
+    if (mode == "--serve")
+    {
+        Settings settings{ std::string{}, std::string{}, std::string{}, 0, std::chrono::milliseconds{ 10000 }, 16, 3, SudokuSolutionStore::defaultFilePath(), SudokuEngine::Automatic, std::string{}, 0, false };
+        if (!parseSettings(argc, argv, settings) || settings.allEngines)
+            return usage();
+        AttachedStore const store{ settings.cacheFile, false };
+        return settings.socketName.empty() ? serveStandardStreams(settings) : serveSocket(argc, argv, settings);
+    }
+    if (mode == "--batch")
+    {
+        Settings settings{ std::string{}, std::string{}, std::string{}, 0, std::chrono::milliseconds{ 0 }, 64, 3, SudokuSolutionStore::defaultFilePath(), SudokuEngine::Automatic, std::string{}, 0, false };
+        if (!parseSettings(argc, argv, settings) || settings.allEngines)
+            return usage();
+        AttachedStore const store{ settings.cacheFile, false };
+        return runBatch(settings);
+    }
+    if (mode == "--shards" || mode == "--shard-worker")
+    {
+        Settings settings{ std::string{}, std::string{}, std::string{}, 0, std::chrono::milliseconds{ 0 }, 256, 3, SudokuSolutionStore::defaultFilePath(), SudokuEngine::Automatic, std::string{}, 0, false };
+        if (!parseSettings(argc, argv, settings) || settings.inputName.empty() || settings.allEngines)
+            return usage();
+        // Only one worker at a time can have the store; the rest say nothing about it
+        if (mode == "--shard-worker")
+        {
+            AttachedStore const store{ settings.cacheFile, true };
+            return SudokuShardedBatch::runWorker(QString::fromStdString(settings.shardKey), settings.shardIndex,
+                                                 QString::fromStdString(settings.inputName));
+        }
+        return runShards(argc, argv, settings);
+    }
+    if (mode == "--benchmark")
+    {
+        Settings settings{ std::string{}, std::string{}, std::string{}, 0, std::chrono::milliseconds{ 0 }, 0, 0, std::string{}, SudokuEngine::Automatic, std::string{}, 0, false };
+        if (!parseSettings(argc, argv, settings))
+            return usage();
+        return runBenchmark(settings);
+    }
+    if (mode == "--count")
+    {
+        Settings settings{ std::string{}, std::string{}, std::string{}, 0, std::chrono::milliseconds{ 0 }, 0, 0, std::string{}, SudokuEngine::Automatic, std::string{}, 0, false };
+        if (!parseSettings(argc, argv, settings) || settings.allEngines)
+            return usage();
+        return runCount(settings);
+    }
+    if (mode == "--client" && (argc == 3 || argc == 4))
+    {
+        if (argc == 3)
+            return runClient(argv[2], std::cin);
+        std::ifstream file{ argv[3] };
+        if (!file)
+        {
+            std::cerr << "cannot open " << argv[3] << '\n';
+            return 1;
+        }
+        return runClient(argv[2], file);
+    }
+    return usage();
+}
@@ -0,0 +1,81 @@
+#ifndef SUDOKUCOMMANDLINE_H
+#define SUDOKUCOMMANDLINE_H
+/*
+class SudokuCommandLine
+====================================================================================================
+The modes that run without the dialog, picked by the first argument:
+
+--serve [options]           Solve request lines (see SudokuSolveService) from stdin, writing
+                            responses to stdout, until stdin ends.
+--serve --socket <name> [options]
+                            The same over a local socket, until killed.
+    --workers <n>           Solver threads, default one per hardware thread.
+    --timeout <ms>          Timeout for requests that don't give one, default 10000, 0 for no
+                            limit.
+    --batch <n>             Most requests a worker takes at once, default 16.
+    --cache-limit <n>       Largest box size to cache solutions for, default 3.
+    --cache-file <file>     SudokuSolutionStore to load cached solutions from and add new ones to,
+                            default solutions.store under sudoku_solver in the user's cache
+                            directory, as the dialog uses; "" for none. Only one process keeps
+                            it at a time.
+--batch [options]           Solve puzzles, one per line, from the input (default stdin) to the
+                            output (default stdout) through SudokuBatchPipeline, with a summary
+                            to stderr, with the solver threads' hardware counters per puzzle
+                            where they can be read.
+    --input <file>, --output <file>
+                            The input may be gzip or zstd compressed (see
+                            SudokuCompressedInput); it is decompressed on a thread of its own.
+    --workers <n>           Solver threads, default one per hardware thread less two.
+    --batch-size <n>        Puzzles per batch, default 64.
+    --timeout <ms>          Time allowed for each puzzle, default no limit.
+    --cache-limit <n>, --cache-file <file>
+                            As for --serve.
+    --engine auto|propagation|sat|bitboard|local
+--shards [options]          The same as --batch, solving in worker processes (see
+                            SudokuShardedBatch) rather than threads.
+    --input <file>          Required, since it is mapped into every worker, and uncompressed.
+    --output <file>
+    --workers <n>           Worker processes, default one per hardware thread.
+    --batch-size <n>        Lines per shard, default 256.
+    --timeout <ms>, --cache-limit <n>, --cache-file <file>, --engine auto|propagation|sat|bitboard|local
+                            As for --batch. The workers share the cache file, one at a time.
+--benchmark [options]       Solve puzzles one at a time on one thread through SudokuBenchmark and
+                            report the time and hardware counters per puzzle of each phase, by
+                            board size and engine.
+    --input <file>, --output <file>
+                            As for --batch.
+    --timeout <ms>          Time allowed for each solve, default no limit.
+    --engine auto|propagation|sat|bitboard|local|all
+                            all compares propagation, SAT and (for 9x9) bitboard.
+--count [options]           Count the full grids that complete each puzzle through
+                            SudokuCompletionCounter, writing each count and then the puzzle, with
+                            progress to stderr each second while a count runs.
+    --input <file>, --output <file>
+                            As for --batch.
+    --workers <n>           Counting threads, default one per hardware thread.
+    --timeout <ms>          Time allowed for each count, default no limit. A count cut short is
+                            written as -.
+--client <name> [file]      Send request lines from the file (or stdin) to a server on that socket,
+                            printing each response with its round trip time added as rtt_us=<n>
+                            and a summary to stderr. Ids must be unique; a line repeating one
+                            is not sent.
+*/
+
+namespace puzzles
+{
+
+class SudokuCommandLine
+{
+public:
+    // Interface
+    //============================================================
+    // Do these arguments ask for a command line mode rather than the dialog?
+    static bool handles(int argc, char* argv[]);
+
+    // Run the mode and return the exit code. argc is a reference because Qt keeps hold of it.
+    static int run(int& argc, char* argv[]);
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUCOMMANDLINE_H
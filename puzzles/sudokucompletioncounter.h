@@ -0,0 +1,571 @@
+#ifndef SUDOKUCOMPLETIONCOUNTER_H
+#define SUDOKUCOMPLETIONCOUNTER_H
+/*
+class SudokuCompletionCounter<N>
+====================================================================================================
+Counts exactly how many full grids complete a partial board, for boards with far too many
+completions to enumerate one at a time: a fixed first band of a 9x9 board has around seven billion.
+The grid is filled a row at a time, and what is left to fill after a row depends only on which
+values each column and each box of the current band already has, so the count for that state is
+worked out once and looked up whenever the same state is reached again. At the end of a band the
+box masks are empty and the state is just the columns, which is where most of the sharing is.
+
+Once every tile below a row is free (unsolved, with nothing eliminated beyond what its solved peers
+rule out), the columns of a stack can be swapped, and whole stacks swapped, without changing the
+count for the rest of the grid, so states are put in a canonical order first and all of those
+arrangements share one entry.
+
+The first rows are expanded breadth first, merging identical states and keeping how many ways
+each is reached, until there are enough states to spread over the threads; each thread then takes
+states from the list. The memo is shared, split into shards with a lock each, so a state one thread
+has counted is there for the others.
+
+Counts are unsigned 128-bit integers: every 9x9 grid there is comes to under 2^73, but a 16x16
+board with too few givens has more completions than 2^128 (and far more than could be counted
+this way anyway).
+
+Only the classic units are counted: boards played with other units give an error. Progress can be
+read from any thread while count() runs:
+
+    SudokuCompletionCounter<3> counter{};
+    std::thread thread{ [&]() { counter.count(board); } };
+    ... counter.progress().partsDone ...
+*/
+#include "sudokuboard.h"
+#include "sudokubits.h"
+#include "sudokucancellation.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace puzzles
+{
+
+template <std::size_t N>
+class SudokuCompletionCounter
+{
+public:
+    // Typedefs
+    //============================================================
+    using mask_type = typename SudokuBoard<N>::mask_type;
+    // A GCC and Clang extension; there is no standard 128-bit integer
+    __extension__ typedef unsigned __int128 count_type;
+
+    // How far a count has got
+    struct Progress
+    {
+        std::size_t partsDone;      // States from the breadth first expansion counted so far
+        std::size_t parts;          // All of them, 0 while still expanding
+        std::uint64_t nodes;        // Values tried
+        std::uint64_t memoHits;     // States whose count was looked up rather than worked out
+        count_type counted;         // Completions found by the parts done so far
+    };
+
+    // Special 6
+    //============================================================
+    SudokuCompletionCounter() :
+        m_threadCount(0),
+        m_memoLimit(c_defaultMemoLimit),
+        m_allowed(),
+        m_freeFrom(N*N),
+        m_completions(0),
+        m_finished(false),
+        m_errorString(),
+        m_partsDone(0),
+        m_parts(0),
+        m_nodes(0),
+        m_memoHits(0),
+        m_countedMutex(),
+        m_counted(0),
+        m_elapsed(0)
+    {}
+
+    // No copying: progress is read from other threads while counting
+    SudokuCompletionCounter(SudokuCompletionCounter const& other) = delete;
+    SudokuCompletionCounter& operator=(SudokuCompletionCounter const& other) = delete;
+
+    // Interface
+    //============================================================
+    // Threads to count on, 0 (the default) for one per hardware thread
+    std::size_t threadCount() const
+    {
+        return m_threadCount;
+    }
+    void setThreadCount(std::size_t threadCount)
+    {
+        m_threadCount = threadCount;
+    }
+
+    // Most states remembered at once; the memo is split into shards, and a shard that fills up
+    // forgets its states and starts again
+    std::size_t memoLimit() const
+    {
+        return m_memoLimit;
+    }
+    void setMemoLimit(std::size_t memoLimit)
+    {
+        m_memoLimit = memoLimit;
+    }
+
+    // Count the completions of the board: full grids that keep its solved tiles and give every
+    // other tile one of its candidates. A board with conflicts has none. Returns false, with
+    // completions() not to be used, if the board isn't played with classic units or the token
+    // stopped the count.
+    bool count(SudokuBoard<N> const& board, SudokuCancellationToken const& cancellation = SudokuCancellationToken{})
+    {
+        std::chrono::steady_clock::time_point const start{ std::chrono::steady_clock::now() };
+        m_completions = 0;
+        m_finished = false;
+        m_errorString.clear();
+        m_partsDone = 0;
+        m_parts = 0;
+        m_nodes = 0;
+        m_memoHits = 0;
+        {
+            std::lock_guard<std::mutex> lock{ m_countedMutex };
+            m_counted = 0;
+        }
+
+        if (!board.unitTable().isClassic())
+        {
+            m_errorString = "completions can only be counted with the classic units";
+            return false;
+        }
+        // Propagation only removes candidates no completion uses, and a board it shows has none
+        // needs no count
+        SudokuBoard<N> propagated{ board };
+        if (!propagated.propagateAll(cancellation))
+        {
+            if (cancellation.shouldStop())
+            {
+                m_errorString = "cancelled";
+                m_elapsed = std::chrono::steady_clock::now() - start;
+                return false;
+            }
+            m_elapsed = std::chrono::steady_clock::now() - start;
+            m_finished = true;
+            return true;
+        }
+        readBoard(propagated);
+
+        std::size_t threadCount{ m_threadCount };
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        // Several parts per thread so that threads given small parts pick up more
+        SudokuCancellationToken const stop{ SudokuCancellationToken::linkedTo(cancellation) };
+        std::vector<MemoShard> memo(c_memoShards);
+        std::size_t const shardLimit{ std::max<std::size_t>(1, m_memoLimit / c_memoShards) };
+        std::size_t row{ 0 };
+        std::vector<std::pair<state_type, count_type>> parts{};
+        {
+            Worker worker{ memo, shardLimit, 0, stop };
+            parts = expand(worker, row, threadCount * 16);
+            flush(worker);
+        }
+        if (stop.shouldStop())
+        {
+            m_errorString = "cancelled";
+            m_elapsed = std::chrono::steady_clock::now() - start;
+            return false;
+        }
+        m_parts = parts.size();
+
+        std::atomic<std::size_t> nextPart{ 0 };
+        auto const work = [this, &parts, row, &stop, &nextPart, &memo, shardLimit]()
+        {
+            Worker worker{ memo, shardLimit, row, stop };
+            for (std::size_t part = nextPart++; part < parts.size() && !stop.shouldStop(); part = nextPart++)
+            {
+                count_type const completions{ countFrom(worker, row, parts[part].first) };
+                flush(worker);
+                if (worker.stopped)
+                    break;
+                std::lock_guard<std::mutex> lock{ m_countedMutex };
+                m_counted += parts[part].second * completions;
+                ++m_partsDone;
+            }
+            flush(worker);
+        };
+
+        std::vector<std::thread> threads{};
+        for (std::size_t index = 1; index < std::min(threadCount, parts.size()); ++index)
+            threads.emplace_back(work);
+        work();
+        for (auto& thread : threads)
+            thread.join();
+
+        m_elapsed = std::chrono::steady_clock::now() - start;
+        if (m_partsDone != parts.size())
+        {
+            m_errorString = "cancelled";
+            return false;
+        }
+        std::lock_guard<std::mutex> lock{ m_countedMutex };
+        m_completions = m_counted;
+        m_finished = true;
+        return true;
+    }
+
+    // The count from the last call to count() that returned true
+    count_type completions() const
+    {
+        return m_completions;
+    }
+    bool isFinished() const
+    {
+        return m_finished;
+    }
+    std::string const& errorString() const
+    {
+        return m_errorString;
+    }
+    // How long the last count took, or ran for before it stopped
+    std::chrono::steady_clock::duration elapsed() const
+    {
+        return m_elapsed;
+    }
+
+    // Safe to call from any thread, including while count() runs
+    Progress progress() const
+    {
+        std::lock_guard<std::mutex> lock{ m_countedMutex };
+        return Progress{ m_partsDone, m_parts, m_nodes, m_memoHits, m_counted };
+    }
+
+    // The count in decimal
+    static std::string toString(count_type value)
+    {
+        std::string result{};
+        do
+        {
+            result.push_back(static_cast<char>('0' + static_cast<int>(value % 10)));
+            value /= 10;
+        }
+        while (value != 0);
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    enum : std::size_t
+    {
+        c_defaultMemoLimit = 1u << 22,
+        c_memoShards = 256,
+        // Nodes between checks of the token and updates of the shared counters
+        c_checkInterval = 1u << 12
+    };
+
+    // The values used in each column, then in each box of the current band
+    using state_type = std::array<mask_type, N*N + N>;
+
+    struct StateHash
+    {
+        std::size_t operator()(state_type const& state) const
+        {
+            std::uint64_t hash{ 0x9e3779b97f4a7c15ull };
+            for (mask_type const mask : state)
+            {
+                hash ^= static_cast<std::uint64_t>(mask);
+                hash *= 0xff51afd7ed558ccdull;
+                hash ^= hash >> 32;
+            }
+            return static_cast<std::size_t>(hash);
+        }
+    };
+    using memo_type = std::unordered_map<state_type, count_type, StateHash>;
+
+    // Part of the memo, for the states whose hash picks it
+    struct MemoShard
+    {
+        std::mutex mutex;
+        memo_type states;
+    };
+
+    // What one thread keeps while counting
+    struct Worker
+    {
+        Worker(std::vector<MemoShard>& sharedMemo, std::size_t memoShardLimit, std::size_t startRow,
+               SudokuCancellationToken const& token) :
+            memo(sharedMemo),
+            shardLimit(memoShardLimit),
+            firstRow(startRow),
+            stop(token),
+            nodes(0),
+            memoHits(0),
+            untilCheck(c_checkInterval),
+            stopped(false)
+        {}
+
+        std::vector<MemoShard>& memo;
+        std::size_t shardLimit;
+        std::size_t firstRow;
+        SudokuCancellationToken const& stop;
+        std::uint64_t nodes;
+        std::uint64_t memoHits;
+        std::size_t untilCheck;
+        bool stopped;
+    };
+
+    // Helpers
+    //============================================================
+    // The values each tile may take, and the first row from which every tile is free
+    void readBoard(SudokuBoard<N> const& board)
+    {
+        m_allowed.resize(N*N*N*N);
+        for (std::size_t row = 0; row != N*N; ++row)
+        {
+            for (std::size_t column = 0; column != N*N; ++column)
+                m_allowed[row * N*N + column] = board.getTileCandidates(row, column);
+        }
+        m_freeFrom = N*N;
+        while (m_freeFrom != 0 && isFreeRow(board, m_freeFrom - 1))
+            --m_freeFrom;
+
+        // A free tile's candidates only leave out values its peers above already hold, which the
+        // state rules out anyway, so it may as well take any value; that keeps the rows below
+        // m_freeFrom the same for every column and makes canonical states interchangeable
+        for (std::size_t tile = m_freeFrom * N*N; tile != N*N*N*N; ++tile)
+            m_allowed[tile] = SudokuMask<N*N>::full();
+    }
+
+    // Is every tile in the row unsolved, with nothing eliminated beyond its solved peers?
+    static bool isFreeRow(SudokuBoard<N> const& board, std::size_t row)
+    {
+        for (std::size_t column = 0; column != N*N; ++column)
+        {
+            mask_type const candidates{ board.getTileCandidates(row, column) };
+            mask_type const used{ static_cast<mask_type>(board.usedInRow(row) | board.usedInColumn(column)
+                                                         | board.usedInSquare(row, column)) };
+            if (board.getTileSolution(row, column) != 0 || static_cast<mask_type>(candidates | used) != SudokuMask<N*N>::full())
+                return false;
+        }
+        return true;
+    }
+
+    // Order the columns within each stack, then the stacks, where the rows left are free
+    state_type canonical(std::size_t row, state_type const& state) const
+    {
+        if (row < m_freeFrom)
+            return state;
+        std::array<std::array<mask_type, N + 1>, N> stacks{};
+        for (std::size_t stack = 0; stack != N; ++stack)
+        {
+            stacks[stack][0] = state[N*N + stack];
+            std::copy(state.begin() + stack * N, state.begin() + (stack + 1) * N, stacks[stack].begin() + 1);
+            std::sort(stacks[stack].begin() + 1, stacks[stack].end());
+        }
+        std::sort(stacks.begin(), stacks.end());
+
+        state_type result{};
+        for (std::size_t stack = 0; stack != N; ++stack)
+        {
+            std::copy(stacks[stack].begin() + 1, stacks[stack].end(), result.begin() + stack * N);
+            result[N*N + stack] = stacks[stack][0];
+        }
+        return result;
+    }
+
+    // The state after a row is filled in, with the boxes cleared at the end of a band
+    state_type afterRow(std::size_t row, state_type const& state) const
+    {
+        state_type result{ state };
+        if ((row + 1) % N == 0)
+            std::fill(result.begin() + N*N, result.end(), mask_type{ 0 });
+        return canonical(row + 1, result);
+    }
+
+    // Can every tile from this row on still take a value, and every value a column or box of the
+    // current band still needs still go somewhere? Free rows always can.
+    bool isViable(std::size_t row, state_type const& state) const
+    {
+        if (row >= m_freeFrom)
+            return true;
+        std::size_t const bandEnd{ (row / N + 1) * N };
+        std::array<mask_type, N> boxReachable{};
+        for (std::size_t column = 0; column != N*N; ++column)
+        {
+            mask_type const missing{ static_cast<mask_type>(SudokuMask<N*N>::full() & ~state[column]) };
+            mask_type const boxUsed{ state[N*N + column / N] };
+            mask_type reachable{ 0 };
+            for (std::size_t next = row; next != N*N; ++next)
+            {
+                mask_type options{ static_cast<mask_type>(m_allowed[next * N*N + column] & missing) };
+                if (next < bandEnd)
+                {
+                    options &= static_cast<mask_type>(~boxUsed);
+                    boxReachable[column / N] |= options;
+                }
+                if (options == 0)
+                    return false;
+                reachable |= options;
+            }
+            if (reachable != missing)
+                return false;
+        }
+        for (std::size_t stack = 0; stack != N; ++stack)
+        {
+            if (boxReachable[stack] != static_cast<mask_type>(SudokuMask<N*N>::full() & ~state[N*N + stack]))
+                return false;
+        }
+        return true;
+    }
+
+    // Fill rows breadth first from the empty state, merging identical states and adding up how
+    // many ways each is reached, until there are at least this many states or no rows are left.
+    // Sets row to the row the states are before.
+    std::vector<std::pair<state_type, count_type>> expand(Worker& worker, std::size_t& row, std::size_t parts) const
+    {
+        std::unordered_map<state_type, count_type, StateHash> states{};
+        states.emplace(state_type{}, count_type{ 1 });
+        for (row = 0; row != N*N && states.size() < parts && !worker.stopped; ++row)
+        {
+            std::unordered_map<state_type, count_type, StateHash> next{};
+            for (auto const& entry : states)
+            {
+                state_type state{ entry.first };
+                expandRow(worker, row, 0, 0, state, entry.second, next);
+            }
+            states.swap(next);
+        }
+        return std::vector<std::pair<state_type, count_type>>(states.begin(), states.end());
+    }
+
+    void expandRow(Worker& worker, std::size_t row, std::size_t column, mask_type rowUsed, state_type& state, count_type ways,
+                   std::unordered_map<state_type, count_type, StateHash>& next) const
+    {
+        if (column == N*N)
+        {
+            state_type const after{ afterRow(row, state) };
+            if (isViable(row + 1, after))
+                next[after] += ways;
+            return;
+        }
+        mask_type& columnUsed = state[column];
+        mask_type& boxUsed = state[N*N + column / N];
+        for (mask_type remaining = static_cast<mask_type>(m_allowed[row * N*N + column] & ~(rowUsed | columnUsed | boxUsed));
+             remaining != 0 && keepGoing(worker); remaining &= static_cast<mask_type>(remaining - 1))
+        {
+            mask_type const value{ static_cast<mask_type>(remaining & (~remaining + 1)) };
+            columnUsed |= value;
+            boxUsed |= value;
+            expandRow(worker, row, column + 1, static_cast<mask_type>(rowUsed | value), state, ways, next);
+            columnUsed &= static_cast<mask_type>(~value);
+            boxUsed &= static_cast<mask_type>(~value);
+        }
+    }
+
+    // The completions of the rows from this one on, given the state before it
+    count_type countFrom(Worker& worker, std::size_t row, state_type const& state) const
+    {
+        if (row == N*N)
+            return 1;
+
+        // The last row is forced, and the first is only reached once. A state holds as many values
+        // in each column as there are rows above it, so states from different rows never match.
+        bool const remember{ row != N*N - 1 && row != worker.firstRow };
+        MemoShard& shard = worker.memo[StateHash{}(state) % c_memoShards];
+        if (remember)
+        {
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+            auto const found = shard.states.find(state);
+            if (found != shard.states.end())
+            {
+                ++worker.memoHits;
+                return found->second;
+            }
+        }
+
+        state_type filling{ state };
+        count_type const result{ fillRow(worker, row, 0, 0, filling) };
+        if (remember && !worker.stopped)
+        {
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+            if (shard.states.size() >= worker.shardLimit)
+                shard.states.clear();
+            shard.states.emplace(state, result);
+        }
+        return result;
+    }
+
+    count_type fillRow(Worker& worker, std::size_t row, std::size_t column, mask_type rowUsed, state_type& state) const
+    {
+        if (column == N*N)
+        {
+            state_type const after{ afterRow(row, state) };
+            return isViable(row + 1, after) ? countFrom(worker, row + 1, after) : count_type{ 0 };
+        }
+
+        count_type result{ 0 };
+        mask_type& columnUsed = state[column];
+        mask_type& boxUsed = state[N*N + column / N];
+        for (mask_type remaining = static_cast<mask_type>(m_allowed[row * N*N + column] & ~(rowUsed | columnUsed | boxUsed));
+             remaining != 0 && keepGoing(worker); remaining &= static_cast<mask_type>(remaining - 1))
+        {
+            mask_type const value{ static_cast<mask_type>(remaining & (~remaining + 1)) };
+            columnUsed |= value;
+            boxUsed |= value;
+            result += fillRow(worker, row, column + 1, static_cast<mask_type>(rowUsed | value), state);
+            columnUsed &= static_cast<mask_type>(~value);
+            boxUsed &= static_cast<mask_type>(~value);
+        }
+        return result;
+    }
+
+    // Count a node about to be tried, every so often passing the counters on and looking at the
+    // token. Once it says stop the worker stays stopped.
+    bool keepGoing(Worker& worker) const
+    {
+        if (worker.stopped)
+            return false;
+        ++worker.nodes;
+        if (--worker.untilCheck == 0)
+        {
+            worker.untilCheck = c_checkInterval;
+            flush(worker);
+            worker.stopped = worker.stop.shouldStop();
+        }
+        return !worker.stopped;
+    }
+
+    // Add a worker's counters to the shared ones
+    void flush(Worker& worker) const
+    {
+        m_nodes += worker.nodes;
+        m_memoHits += worker.memoHits;
+        worker.nodes = 0;
+        worker.memoHits = 0;
+    }
+
+    // Data Members
+    //============================================================
+    std::size_t m_threadCount;
+    std::size_t m_memoLimit;
+    std::vector<mask_type> m_allowed;
+    std::size_t m_freeFrom;
+    count_type m_completions;
+    bool m_finished;
+    std::string m_errorString;
+    std::atomic<std::size_t> m_partsDone;
+    std::atomic<std::size_t> m_parts;
+    mutable std::atomic<std::uint64_t> m_nodes;
+    mutable std::atomic<std::uint64_t> m_memoHits;
+    mutable std::mutex m_countedMutex;
+    count_type m_counted;
+    std::chrono::steady_clock::duration m_elapsed;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUCOMPLETIONCOUNTER_H
@@ -0,0 +1,313 @@
+#include "sudokucompressedinput.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <zlib.h>
+#if defined(SUDOKU_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace
+{
+    unsigned char const c_gzipMagic[2]{ 0x1F, 0x8B };
+    unsigned char const c_zstdMagic[4]{ 0x28, 0xB5, 0x2F, 0xFD };
+
+    // zlib counts in uInt
+    std::size_t const c_largestBuffer{ std::numeric_limits<uInt>::max() };
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuCompressedInput::SudokuCompressedInput(std::istream& source, std::size_t bufferSize, std::size_t bufferCount) :
+    m_source(source),
+    m_buffers(std::max<std::size_t>(2, bufferCount)),
+    m_freeRing{ std::max<std::size_t>(2, bufferCount) },
+    m_fullRing{ std::max<std::size_t>(2, bufferCount) + 1 },
+    m_current{ nullptr },
+    m_finished{ false },
+    m_stopping{ false },
+    m_compression{ SudokuCompression::None },
+    m_errorString{},
+    m_thread{}
+{
+    std::size_t const size{ std::min(std::max<std::size_t>(4096, bufferSize), c_largestBuffer) };
+    for (auto& buffer : m_buffers)
+    {
+        buffer.data.resize(size);
+        buffer.size = 0;
+        m_freeRing.push(&buffer);
+    }
+    m_thread = std::thread{ [this]() { decompress(); } };
+}
+
+puzzles::SudokuCompressedInput::~SudokuCompressedInput()
+{
+    // Hand back everything the thread sends until it sees m_stopping and ends the stream
+    m_stopping.store(true, std::memory_order_relaxed);
+    while (!m_finished)
+    {
+        Buffer* buffer{ nullptr };
+        m_fullRing.pop(buffer);
+        if (buffer == nullptr)
+            m_finished = true;
+        else
+            m_freeRing.push(buffer);
+    }
+    m_thread.join();
+}
+
+// Interface
+//============================================================
+puzzles::SudokuCompression puzzles::SudokuCompressedInput::compression() const
+{
+    return m_compression;
+}
+
+bool puzzles::SudokuCompressedInput::hasError() const
+{
+    return !m_errorString.empty();
+}
+
+std::string const& puzzles::SudokuCompressedInput::errorString() const
+{
+    return m_errorString;
+}
+
+puzzles::SudokuCompression puzzles::SudokuCompressedInput::detect(char const* data, std::size_t size)
+{
+    if (size >= sizeof(c_zstdMagic) && std::memcmp(data, c_zstdMagic, sizeof(c_zstdMagic)) == 0)
+        return SudokuCompression::Zstd;
+    if (size >= sizeof(c_gzipMagic) && std::memcmp(data, c_gzipMagic, sizeof(c_gzipMagic)) == 0)
+        return SudokuCompression::Gzip;
+    return SudokuCompression::None;
+}
+
+bool puzzles::SudokuCompressedInput::isSupported(SudokuCompression compression)
+{
+#if defined(SUDOKU_WITH_ZSTD)
+    static_cast<void>(compression);
+    return true;
+#else
+    return compression != SudokuCompression::Zstd;
+#endif
+}
+
+char const* puzzles::SudokuCompressedInput::name(SudokuCompression compression)
+{
+    switch (compression)
+    {
+    case SudokuCompression::None:   return "plain";
+    case SudokuCompression::Gzip:   return "gzip";
+    case SudokuCompression::Zstd:   return "zstd";
+    default:                        return "unknown";
+    }
+}
+
+std::streambuf::int_type puzzles::SudokuCompressedInput::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    if (m_current != nullptr)
+    {
+        m_freeRing.push(m_current);
+        m_current = nullptr;
+    }
+    setg(nullptr, nullptr, nullptr);
+    if (m_finished)
+        return traits_type::eof();
+
+    Buffer* buffer{ nullptr };
+    m_fullRing.pop(buffer);
+    if (buffer == nullptr)
+    {
+        m_finished = true;
+        return traits_type::eof();
+    }
+    m_current = buffer;
+    setg(buffer->data.data(), buffer->data.data(), buffer->data.data() + buffer->size);
+    return traits_type::to_int_type(*gptr());
+}
+
+// Helpers
+//============================================================
+void puzzles::SudokuCompressedInput::decompress()
+{
+    std::vector<char> raw(m_buffers.front().data.size());
+    std::size_t const rawSize{ readSource(raw) };
+    m_compression = detect(raw.data(), rawSize);
+    switch (m_compression)
+    {
+    case SudokuCompression::None:   copyPlain(raw, rawSize); break;
+    case SudokuCompression::Gzip:   inflateGzip(raw, rawSize); break;
+    case SudokuCompression::Zstd:   decompressZstd(raw, rawSize); break;
+    }
+    m_fullRing.push(nullptr);
+}
+
+void puzzles::SudokuCompressedInput::copyPlain(std::vector<char>& raw, std::size_t rawSize)
+{
+    // The first read is already in raw; after that the source is read straight into the buffers
+    if (rawSize == 0)
+        return;
+    Buffer* buffer{ takeBuffer() };
+    std::copy(raw.cbegin(), raw.cbegin() + static_cast<std::ptrdiff_t>(rawSize), buffer->data.begin());
+    buffer->size = rawSize;
+    while (handOver(buffer))
+    {
+        buffer = takeBuffer();
+        buffer->size = readSource(buffer->data);
+        if (buffer->size == 0)
+        {
+            m_freeRing.push(buffer);
+            return;
+        }
+    }
+}
+
+void puzzles::SudokuCompressedInput::inflateGzip(std::vector<char>& raw, std::size_t rawSize)
+{
+    z_stream stream{};
+    if (inflateInit2(&stream, 15 + 16) != Z_OK)
+    {
+        m_errorString = "cannot start zlib";
+        return;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(raw.data());
+    stream.avail_in = static_cast<uInt>(rawSize);
+
+    Buffer* buffer{ takeBuffer() };
+    buffer->size = 0;
+    bool ended{ false };        // at the end of a member
+    bool going{ true };
+    while (going)
+    {
+        if (stream.avail_in == 0)
+        {
+            std::size_t const size{ readSource(raw) };
+            if (size == 0)
+            {
+                if (!ended && m_errorString.empty())
+                    m_errorString = "gzip stream is truncated";
+                break;
+            }
+            stream.next_in = reinterpret_cast<Bytef*>(raw.data());
+            stream.avail_in = static_cast<uInt>(size);
+        }
+        // Another member follows the one that ended
+        if (ended)
+        {
+            inflateReset(&stream);
+            ended = false;
+        }
+
+        stream.next_out = reinterpret_cast<Bytef*>(buffer->data.data() + buffer->size);
+        stream.avail_out = static_cast<uInt>(buffer->data.size() - buffer->size);
+        int const result{ inflate(&stream, Z_NO_FLUSH) };
+        buffer->size = buffer->data.size() - stream.avail_out;
+        if (result == Z_STREAM_END)
+            ended = true;
+        else if (result != Z_OK && result != Z_BUF_ERROR)
+        {
+            m_errorString = std::string{ "gzip stream is corrupt: " } + (stream.msg != nullptr ? stream.msg : "unknown error");
+            break;
+        }
+
+        if (buffer->size == buffer->data.size())
+        {
+            going = handOver(buffer);
+            buffer = takeBuffer();
+            buffer->size = 0;
+        }
+    }
+    inflateEnd(&stream);
+
+    if (buffer->size != 0 && going)
+        handOver(buffer);
+    else
+        m_freeRing.push(buffer);
+}
+
+void puzzles::SudokuCompressedInput::decompressZstd(std::vector<char>& raw, std::size_t rawSize)
+{
+#if defined(SUDOKU_WITH_ZSTD)
+    ZSTD_DStream* const stream{ ZSTD_createDStream() };
+    if (stream == nullptr || ZSTD_isError(ZSTD_initDStream(stream)))
+    {
+        ZSTD_freeDStream(stream);
+        m_errorString = "cannot start zstd";
+        return;
+    }
+    ZSTD_inBuffer input{ raw.data(), rawSize, 0 };
+
+    Buffer* buffer{ takeBuffer() };
+    buffer->size = 0;
+    std::size_t remaining{ 0 };     // 0 at the end of a frame
+    bool going{ true };
+    while (going)
+    {
+        if (input.pos == input.size)
+        {
+            std::size_t const size{ readSource(raw) };
+            if (size == 0)
+            {
+                if (remaining != 0 && m_errorString.empty())
+                    m_errorString = "zstd stream is truncated";
+                break;
+            }
+            input = ZSTD_inBuffer{ raw.data(), size, 0 };
+        }
+
+        ZSTD_outBuffer output{ buffer->data.data(), buffer->data.size(), buffer->size };
+        remaining = ZSTD_decompressStream(stream, &output, &input);
+        buffer->size = output.pos;
+        if (ZSTD_isError(remaining))
+        {
+            m_errorString = std::string{ "zstd stream is corrupt: " } + ZSTD_getErrorName(remaining);
+            break;
+        }
+
+        if (buffer->size == buffer->data.size())
+        {
+            going = handOver(buffer);
+            buffer = takeBuffer();
+            buffer->size = 0;
+        }
+    }
+    ZSTD_freeDStream(stream);
+
+    if (buffer->size != 0 && going)
+        handOver(buffer);
+    else
+        m_freeRing.push(buffer);
+#else
+    static_cast<void>(raw);
+    static_cast<void>(rawSize);
+    m_errorString = "zstd input is not supported by this build (qmake CONFIG+=zstd)";
+#endif
+}
+
+std::size_t puzzles::SudokuCompressedInput::readSource(std::vector<char>& raw)
+{
+    if (!m_source.good() || m_stopping.load(std::memory_order_relaxed))
+        return 0;
+    m_source.read(raw.data(), static_cast<std::streamsize>(raw.size()));
+    if (m_source.bad())
+        m_errorString = "cannot read the input";
+    return static_cast<std::size_t>(m_source.gcount());
+}
+
+puzzles::SudokuCompressedInput::Buffer* puzzles::SudokuCompressedInput::takeBuffer()
+{
+    Buffer* buffer{ nullptr };
+    m_freeRing.pop(buffer);
+    return buffer;
+}
+
+bool puzzles::SudokuCompressedInput::handOver(Buffer* buffer)
+{
+    m_fullRing.push(buffer);
+    return !m_stopping.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,118 @@
+#ifndef SUDOKUCOMPRESSEDINPUT_H
+#define SUDOKUCOMPRESSEDINPUT_H
+/*
+enum class SudokuCompression
+====================================================================================================
+How a corpus is stored: plain text, gzip (any number of members, as gzip and pigz write them) or
+zstd (any number of frames).
+
+class SudokuCompressedInput
+====================================================================================================
+A std::streambuf that reads a corpus from another stream, decompressing it if need be, so the
+batch reader can be handed a gzip or zstd file as it is: wrap the source in one and read the text
+through a std::istream on it. The compression is recognised from the first bytes; anything else
+is passed through as plain text.
+
+Reading and decompressing happen on a thread of their own, so the reader parses one buffer while
+the next is being decompressed. The thread fills buffers from a pool allocated up front and passes
+them to the reading side through a SudokuRingBuffer; the reading side hands each one back once it
+has been read. The pool, one buffer for the compressed bytes and the decompressor's own state are
+all the memory used, however large the input, and nothing is written to disk.
+
+gzip is read through zlib. zstd needs libzstd and is only built in with SUDOKU_WITH_ZSTD defined
+(qmake CONFIG+=zstd); without it a zstd stream ends straight away with an error.
+
+A stream that is corrupt, truncated or can't be read ends early, at the last good byte, and
+hasError() and errorString() then say why; both are only meaningful once the stream has ended.
+The destructor stops the thread, so a stream can be dropped part way through, though not while
+the thread is waiting on a source that never delivers.
+*/
+#include "sudokuringbuffer.h"
+#include <atomic>
+#include <cstddef>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace puzzles
+{
+
+enum class SudokuCompression
+{
+    None,
+    Gzip,
+    Zstd
+};
+
+class SudokuCompressedInput : public std::streambuf
+{
+public:
+    // Special 6
+    //============================================================
+    // Starts reading straight away; source has to outlive the object
+    explicit SudokuCompressedInput(std::istream& source, std::size_t bufferSize = 1 << 20, std::size_t bufferCount = 4);
+    ~SudokuCompressedInput() override;
+
+    // No copying
+    SudokuCompressedInput(SudokuCompressedInput const& other) = delete;
+    SudokuCompressedInput& operator=(SudokuCompressedInput const& other) = delete;
+
+    // Interface
+    //============================================================
+    // What the source turned out to be, once the first character has been read
+    SudokuCompression compression() const;
+    bool hasError() const;
+    std::string const& errorString() const;
+
+    // What the bytes at the start of a stream say it is
+    static SudokuCompression detect(char const* data, std::size_t size);
+    static bool isSupported(SudokuCompression compression);
+    static char const* name(SudokuCompression compression);
+
+protected:
+    int_type underflow() override;
+
+private:
+    // Typedefs
+    //============================================================
+    struct Buffer
+    {
+        std::vector<char> data;
+        std::size_t size;
+    };
+
+    using Ring = SudokuRingBuffer<Buffer*>;
+
+    // Helpers
+    //============================================================
+    // The thread
+    void decompress();
+    void copyPlain(std::vector<char>& raw, std::size_t rawSize);
+    void inflateGzip(std::vector<char>& raw, std::size_t rawSize);
+    void decompressZstd(std::vector<char>& raw, std::size_t rawSize);
+    // Fill raw from the source, 0 at its end
+    std::size_t readSource(std::vector<char>& raw);
+    // A free buffer, waiting for the reading side to hand one back if need be
+    Buffer* takeBuffer();
+    // Pass a filled buffer on; false once the reading side is going away
+    bool handOver(Buffer* buffer);
+
+    // Data Members
+    //============================================================
+    std::istream& m_source;
+    std::vector<Buffer> m_buffers;
+    Ring m_freeRing;
+    Ring m_fullRing;                        // a nullptr after the last buffer
+    Buffer* m_current;                      // being read, nullptr if none
+    bool m_finished;                        // the nullptr has been seen
+    std::atomic<bool> m_stopping;
+    SudokuCompression m_compression;        // written by the thread before its first buffer
+    std::string m_errorString;              // written by the thread before the nullptr
+    std::thread m_thread;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUCOMPRESSEDINPUT_H
@@ -0,0 +1,630 @@
+#ifndef SUDOKUHINTENGINE_H
+#define SUDOKUHINTENGINE_H
+/*
+enum class SudokuHintKind
+====================================================================================================
+What a hint is:
+
+None            Nothing to suggest: the board is solved, or the strategies can't take it further
+                without a guess.
+Contradiction   The board can't be finished as it stands: a tile clashes with another, a tile has
+                no candidates left or a value has nowhere left to go in a unit.
+NakedSingle     A tile that can only be one value.
+HiddenSingle    A value that can only go in one tile of a unit.
+Elimination     Candidates one of the strategies removes.
+
+struct SudokuHint
+====================================================================================================
+One step, what it rests on, and a sentence saying so for showing to the player. Tiles are numbered
+x * N*N + y and values are masks with bit (value - 1) set, as on the board; units are numbered as
+in SudokuUnitTable<N>.
+
+class SudokuHintEngine<N>
+====================================================================================================
+Finds the simplest next step on a SudokuBoard<N> without changing the board: a naked single, then a
+hidden single, then the first elimination of the strategies in its SudokuStrategyPipeline (every
+one by default, cheapest first), stopping at the first thing found. It works on the candidates as
+getTileCandidates() gives them, so eliminations already made on the board count.
+
+Between calls the engine remembers how far down that list it has looked in each unit, and in each
+pair of units the intersection strategies work on, without finding anything. Each call compares
+every tile's candidates with the ones it saw last time, a pass of bit operations, and forgets what
+it knew only about the units holding a tile that changed. Those units, and the intersections they
+are in, are looked at again; the rest are skipped. So after an edit the strategies only run where
+the edit reached, and a player asking for hint after hint pays for their edits rather than for a
+full pass of every strategy each time. Any board can be passed in; one the engine hasn't seen just
+looks like a large edit.
+*/
+#include "sudokuboard.h"
+#include "sudokubits.h"
+#include "sudokustrategypipeline.h"
+#include "sudokuunittable.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace puzzles
+{
+
+enum class SudokuHintKind
+{
+    None,
+    Contradiction,
+    NakedSingle,
+    HiddenSingle,
+    Elimination
+};
+
+struct SudokuHint
+{
+    // Typedefs
+    //============================================================
+    struct Elimination
+    {
+        std::size_t tile;
+        std::uint64_t values;
+    };
+
+    // Data Members
+    //============================================================
+    SudokuHintKind kind;
+    SudokuStrategy strategy;                // for an Elimination
+    std::size_t tile;                       // a single, a clash or a tile with no candidates
+    std::size_t value;                      // a single, a clash or a value with nowhere to go
+    std::size_t unit;                       // where a hidden single, a value with nowhere to go or an elimination was found
+    std::size_t otherUnit;                  // for the intersection strategies, the unit candidates are removed from
+    std::vector<std::size_t> tiles;         // the tiles an elimination rests on
+    std::uint64_t values;                   // the values an elimination rests on
+    std::vector<Elimination> eliminations;
+    std::string text;
+};
+
+template <std::size_t N>
+class SudokuHintEngine
+{
+public:
+    // Typedefs
+    //============================================================
+    using mask_type = typename SudokuBoard<N>::mask_type;
+    using unit_table = SudokuUnitTable<N>;
+
+    // Special 6
+    //============================================================
+    // Every strategy, cheapest first
+    SudokuHintEngine() :
+        SudokuHintEngine(SudokuStrategyPipeline::all())
+    {}
+    explicit SudokuHintEngine(SudokuStrategyPipeline const& pipeline) :
+        m_pipeline(pipeline),
+        m_units(),
+        m_candidates{},
+        m_solved{},
+        m_unitLevels{},
+        m_unitChanges{},
+        m_intersectionLevels(),
+        m_intersectionChecks(),
+        m_generation{ 0 },
+        m_examined{ 0 }
+    {}
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // The simplest step from this board
+    SudokuHint next(SudokuBoard<N> const& board)
+    {
+        m_examined = 0;
+        SudokuHint hint{};
+        if (board.isSolved())
+        {
+            hint.text = "The board is solved.";
+            return hint;
+        }
+        // Nothing else means much while the board breaks the rules
+        for (std::size_t tile = 0; tile != N*N*N*N; ++tile)
+        {
+            if (board.isTileConflicting(tile / (N*N), tile % (N*N)))
+            {
+                hint.kind = SudokuHintKind::Contradiction;
+                hint.tile = tile;
+                hint.value = board.getTileSolution(tile / (N*N), tile % (N*N));
+                hint.text = tileName(tile) + " is " + std::to_string(hint.value) + ", which is already in one of its units.";
+                return hint;
+            }
+        }
+
+        update(board);
+        auto const& steps = m_pipeline.steps();
+        for (std::size_t level = 0; level != c_firstStrategyLevel + steps.size(); ++level)
+        {
+            if (level >= c_firstStrategyLevel && !steps[level - c_firstStrategyLevel].enabled)
+                continue;
+            bool const found{ level >= c_firstStrategyLevel && isIntersectionStrategy(steps[level - c_firstStrategyLevel].strategy)
+                              ? searchIntersections(board, level, hint)
+                              : searchUnits(board, level, hint) };
+            if (found)
+                return hint;
+        }
+        hint.text = "No hint: the strategies can't take this board any further without a guess.";
+        return hint;
+    }
+
+    // The strategies tried after the singles. Changing them forgets what was remembered.
+    SudokuStrategyPipeline const& strategyPipeline() const
+    {
+        return m_pipeline;
+    }
+    void setStrategyPipeline(SudokuStrategyPipeline const& pipeline)
+    {
+        m_pipeline = pipeline;
+        forget();
+    }
+
+    // Forget everything, so the next hint looks at the whole board
+    void forget()
+    {
+        m_units.reset();
+    }
+
+    // How many units and intersections the last next() looked at; the rest were remembered
+    std::size_t examined() const
+    {
+        return m_examined;
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    // Levels: naked singles, hidden singles, then the pipeline's steps in order
+    enum : std::size_t { c_firstStrategyLevel = 2 };
+
+    // Helpers
+    //============================================================
+    // Take in the board's candidates, forgetting what was known about units where they changed
+    void update(SudokuBoard<N> const& board)
+    {
+        ++m_generation;
+        bool const newTable{ m_units != board.sharedUnitTable() };
+        if (newTable)
+        {
+            m_units = board.sharedUnitTable();
+            m_intersectionLevels.assign(m_units->intersections().size(), 0);
+            m_intersectionChecks.assign(m_units->intersections().size(), 0);
+        }
+
+        for (std::size_t tile = 0; tile != N*N*N*N; ++tile)
+        {
+            bool const solved{ board.getTileSolution(tile / (N*N), tile % (N*N)) != 0 };
+            mask_type const candidates{ board.getTileCandidates(tile / (N*N), tile % (N*N)) };
+            if (!newTable && candidates == m_candidates[tile] && solved == m_solved[tile])
+                continue;
+            m_candidates[tile] = candidates;
+            m_solved[tile] = solved;
+            std::uint16_t const* const units = m_units->tileUnits(tile);
+            for (std::size_t index = 0, end = m_units->tileUnitCount(tile); index != end; ++index)
+            {
+                m_unitLevels[units[index]] = 0;
+                m_unitChanges[units[index]] = m_generation;
+            }
+        }
+    }
+
+    // Look at this level in every unit not already known to have nothing there
+    bool searchUnits(SudokuBoard<N> const& board, std::size_t level, SudokuHint& hint)
+    {
+        for (std::size_t unit = 0, units = m_units->unitCount(); unit != units; ++unit)
+        {
+            if (m_unitLevels[unit] > level)
+                continue;
+            ++m_examined;
+            if (searchUnit(board, level, unit, hint))
+                return true;
+            m_unitLevels[unit] = static_cast<std::uint8_t>(level + 1);
+        }
+        return false;
+    }
+
+    bool searchUnit(SudokuBoard<N> const& board, std::size_t level, std::size_t unit, SudokuHint& hint) const
+    {
+        if (level == 0)
+            return findNakedSingle(unit, hint);
+        if (level == 1)
+            return findHiddenSingle(board, unit, hint);
+
+        SudokuStrategy const strategy{ m_pipeline.steps()[level - c_firstStrategyLevel].strategy };
+        switch (strategy)
+        {
+        case SudokuStrategy::NakedPairs:    return findNakedSubset(strategy, unit, 2, hint);
+        case SudokuStrategy::NakedTriples:  return findNakedSubset(strategy, unit, 3, hint);
+        case SudokuStrategy::HiddenPairs:   return findHiddenSubset(board, strategy, unit, 2, hint);
+        case SudokuStrategy::HiddenTriples: return findHiddenSubset(board, strategy, unit, 3, hint);
+        default:                            return false;
+        }
+    }
+
+    // Look at this level in every intersection not already known to have nothing there. One that
+    // was looked at before either of its units last changed is forgotten first.
+    bool searchIntersections(SudokuBoard<N> const& board, std::size_t level, SudokuHint& hint)
+    {
+        SudokuStrategy const strategy{ m_pipeline.steps()[level - c_firstStrategyLevel].strategy };
+        bool const fromLines{ strategy == SudokuStrategy::BoxLineReduction };
+        auto const& intersections = m_units->intersections();
+        for (std::size_t index = 0, end = intersections.size(); index != end; ++index)
+        {
+            auto const& intersection = intersections[index];
+            if (m_intersectionChecks[index] < std::max(m_unitChanges[intersection.first], m_unitChanges[intersection.second]))
+                m_intersectionLevels[index] = 0;
+            if (m_intersectionLevels[index] > level)
+                continue;
+
+            ++m_examined;
+            if ((isLine(intersection.first) == fromLines
+                 && findLockedCandidates(board, strategy, intersection.first, intersection.inFirst, intersection.second, intersection.inSecond, hint))
+                || (isLine(intersection.second) == fromLines
+                    && findLockedCandidates(board, strategy, intersection.second, intersection.inSecond, intersection.first, intersection.inFirst, hint)))
+                return true;
+            m_intersectionLevels[index] = static_cast<std::uint8_t>(level + 1);
+            m_intersectionChecks[index] = m_generation;
+        }
+        return false;
+    }
+
+    // An unsolved tile of the unit with one candidate, or none
+    bool findNakedSingle(std::size_t unit, SudokuHint& hint) const
+    {
+        std::uint16_t const* const tiles = m_units->unitTiles(unit);
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            std::size_t const tile{ tiles[index] };
+            if (m_solved[tile])
+                continue;
+            if (m_candidates[tile] == 0)
+            {
+                hint.kind = SudokuHintKind::Contradiction;
+                hint.tile = tile;
+                hint.text = tileName(tile) + " has no candidates left.";
+                return true;
+            }
+            if (isSingleBit(m_candidates[tile]))
+            {
+                hint.kind = SudokuHintKind::NakedSingle;
+                hint.tile = tile;
+                hint.value = lowestBitIndex(m_candidates[tile]) + 1;
+                hint.text = "Naked single: " + tileName(tile) + " can only be " + std::to_string(hint.value) + ".";
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A value missing from the unit with one tile to go in, or none
+    bool findHiddenSingle(SudokuBoard<N> const& board, std::size_t unit, SudokuHint& hint) const
+    {
+        std::uint16_t const* const tiles = m_units->unitTiles(unit);
+        mask_type once{ 0 }, twice{ 0 };
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            if (m_solved[tiles[index]])
+                continue;
+            twice |= static_cast<mask_type>(once & m_candidates[tiles[index]]);
+            once |= m_candidates[tiles[index]];
+        }
+
+        mask_type const missing{ static_cast<mask_type>(~board.usedInUnit(unit) & allValues()) };
+        if ((missing & ~once) != 0)
+        {
+            hint.kind = SudokuHintKind::Contradiction;
+            hint.unit = unit;
+            hint.value = lowestBitIndex(missing & ~once) + 1;
+            hint.text = std::to_string(hint.value) + " has nowhere left to go in " + unitName(unit) + ".";
+            return true;
+        }
+        mask_type const singles{ static_cast<mask_type>(missing & once & ~twice) };
+        if (singles == 0)
+            return false;
+
+        mask_type const value{ static_cast<mask_type>(singles & (~singles + 1)) };
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            if (!m_solved[tiles[index]] && (m_candidates[tiles[index]] & value) != 0)
+            {
+                hint.kind = SudokuHintKind::HiddenSingle;
+                hint.tile = tiles[index];
+                hint.unit = unit;
+                hint.value = lowestBitIndex(value) + 1;
+                hint.text = "Hidden single: in " + unitName(unit) + ", " + std::to_string(hint.value) + " can only go in " + tileName(tiles[index]) + ".";
+                break;
+            }
+        }
+        return true;
+    }
+
+    // size tiles of the unit with size candidates between them, which some other tile there has
+    bool findNakedSubset(SudokuStrategy strategy, std::size_t unit, std::size_t size, SudokuHint& hint) const
+    {
+        std::uint16_t const* const tiles = m_units->unitTiles(unit);
+        std::array<std::size_t, N*N> items{};
+        std::size_t itemCount{ 0 };
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            std::size_t const count{ popCount(m_candidates[tiles[index]]) };
+            if (!m_solved[tiles[index]] && count >= 2 && count <= size)
+                items[itemCount++] = index;
+        }
+        return itemCount >= size && nakedCombination(strategy, unit, items, itemCount, size, 0, 0, 0, 0, hint);
+    }
+
+    bool nakedCombination(SudokuStrategy strategy, std::size_t unit, std::array<std::size_t, N*N> const& items, std::size_t itemCount,
+                          std::size_t size, std::size_t start, std::size_t chosenCount, std::uint64_t chosenIndexes, mask_type values, SudokuHint& hint) const
+    {
+        if (popCount(values) > size)
+            return false;
+
+        std::uint16_t const* const tiles = m_units->unitTiles(unit);
+        if (chosenCount == size)
+        {
+            std::vector<SudokuHint::Elimination> eliminations{};
+            for (std::size_t index = 0; index != N*N; ++index)
+            {
+                mask_type const removed{ static_cast<mask_type>(m_candidates[tiles[index]] & values) };
+                if (((chosenIndexes >> index) & 1) == 0 && !m_solved[tiles[index]] && removed != 0)
+                    eliminations.push_back(SudokuHint::Elimination{ tiles[index], removed });
+            }
+            if (eliminations.empty())
+                return false;
+
+            hint.kind = SudokuHintKind::Elimination;
+            hint.strategy = strategy;
+            hint.unit = unit;
+            hint.values = values;
+            for (std::uint64_t remaining = chosenIndexes; remaining != 0; remaining &= remaining - 1)
+                hint.tiles.push_back(tiles[lowestBitIndex(remaining)]);
+            hint.eliminations = eliminations;
+            hint.text = std::string{ SudokuStrategyPipeline::name(strategy) } + ": " + tileList(hint.tiles) + " can only be " + valueList(values)
+                        + " between them, so no other tile in " + unitName(unit) + " can be " + valueList(values, " or ") + ". " + eliminationList(eliminations);
+            return true;
+        }
+
+        for (std::size_t item = start; item != itemCount; ++item)
+        {
+            if (nakedCombination(strategy, unit, items, itemCount, size, item + 1, chosenCount + 1,
+                                 chosenIndexes | (std::uint64_t{ 1 } << items[item]),
+                                 static_cast<mask_type>(values | m_candidates[tiles[items[item]]]), hint))
+                return true;
+        }
+        return false;
+    }
+
+    // size values missing from the unit that can only go in size of its tiles, which could be
+    // something else as well
+    bool findHiddenSubset(SudokuBoard<N> const& board, SudokuStrategy strategy, std::size_t unit, std::size_t size, SudokuHint& hint) const
+    {
+        std::uint16_t const* const tiles = m_units->unitTiles(unit);
+        std::array<std::uint64_t, N*N> places{};
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            if (m_solved[tiles[index]])
+                continue;
+            for (mask_type remaining = m_candidates[tiles[index]]; remaining != 0; remaining &= remaining - 1)
+                places[lowestBitIndex(remaining)] |= std::uint64_t{ 1 } << index;
+        }
+
+        std::array<std::size_t, N*N> items{};
+        std::size_t itemCount{ 0 };
+        mask_type const used{ board.usedInUnit(unit) };
+        for (std::size_t valueIndex = 0; valueIndex != N*N; ++valueIndex)
+        {
+            std::size_t const count{ popCount(places[valueIndex]) };
+            if (((used >> valueIndex) & 1) == 0 && count >= 2 && count <= size)
+                items[itemCount++] = valueIndex;
+        }
+        return itemCount >= size && hiddenCombination(strategy, unit, places, items, itemCount, size, 0, 0, 0, 0, hint);
+    }
+
+    bool hiddenCombination(SudokuStrategy strategy, std::size_t unit, std::array<std::uint64_t, N*N> const& places, std::array<std::size_t, N*N> const& items,
+                           std::size_t itemCount, std::size_t size, std::size_t start, std::size_t chosenCount, mask_type values, std::uint64_t indexes, SudokuHint& hint) const
+    {
+        if (popCount(indexes) > size)
+            return false;
+
+        std::uint16_t const* const tiles = m_units->unitTiles(unit);
+        if (chosenCount == size)
+        {
+            std::vector<SudokuHint::Elimination> eliminations{};
+            for (std::uint64_t remaining = indexes; remaining != 0; remaining &= remaining - 1)
+            {
+                std::size_t const tile{ tiles[lowestBitIndex(remaining)] };
+                mask_type const removed{ static_cast<mask_type>(m_candidates[tile] & ~values) };
+                hint.tiles.push_back(tile);
+                if (removed != 0)
+                    eliminations.push_back(SudokuHint::Elimination{ tile, removed });
+            }
+            if (popCount(indexes) != size || eliminations.empty())
+            {
+                hint.tiles.clear();
+                return false;
+            }
+
+            hint.kind = SudokuHintKind::Elimination;
+            hint.strategy = strategy;
+            hint.unit = unit;
+            hint.values = values;
+            hint.eliminations = eliminations;
+            hint.text = std::string{ SudokuStrategyPipeline::name(strategy) } + ": in " + unitName(unit) + ", " + valueList(values) + " can only go in "
+                        + tileList(hint.tiles) + ", so those tiles can't be anything else. " + eliminationList(eliminations);
+            return true;
+        }
+
+        for (std::size_t item = start; item != itemCount; ++item)
+        {
+            if (hiddenCombination(strategy, unit, places, items, itemCount, size, item + 1, chosenCount + 1,
+                                  static_cast<mask_type>(values | (mask_type{ 1 } << items[item])), indexes | places[items[item]], hint))
+                return true;
+        }
+        return false;
+    }
+
+    // Values missing from source that can only go in its tiles inSource, which target has
+    // outside its tiles inTarget
+    bool findLockedCandidates(SudokuBoard<N> const& board, SudokuStrategy strategy, std::size_t source, std::uint64_t inSource,
+                              std::size_t target, std::uint64_t inTarget, SudokuHint& hint) const
+    {
+        std::uint16_t const* const sourceTiles = m_units->unitTiles(source);
+        mask_type inside{ 0 }, outside{ 0 };
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            if (m_solved[sourceTiles[index]])
+                continue;
+            if (((inSource >> index) & 1) != 0)
+                inside |= m_candidates[sourceTiles[index]];
+            else
+                outside |= m_candidates[sourceTiles[index]];
+        }
+        mask_type const locked{ static_cast<mask_type>(inside & ~outside & ~board.usedInUnit(source)) };
+        if (locked == 0)
+            return false;
+
+        std::vector<SudokuHint::Elimination> eliminations{};
+        mask_type values{ 0 };
+        std::uint16_t const* const targetTiles = m_units->unitTiles(target);
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            mask_type const removed{ static_cast<mask_type>(m_candidates[targetTiles[index]] & locked) };
+            if (((inTarget >> index) & 1) == 0 && !m_solved[targetTiles[index]] && removed != 0)
+            {
+                eliminations.push_back(SudokuHint::Elimination{ targetTiles[index], removed });
+                values |= removed;
+            }
+        }
+        if (eliminations.empty())
+            return false;
+
+        hint.kind = SudokuHintKind::Elimination;
+        hint.strategy = strategy;
+        hint.unit = source;
+        hint.otherUnit = target;
+        hint.values = values;
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            if (((inSource >> index) & 1) != 0 && !m_solved[sourceTiles[index]] && (m_candidates[sourceTiles[index]] & values) != 0)
+                hint.tiles.push_back(sourceTiles[index]);
+        }
+        hint.eliminations = eliminations;
+        hint.text = std::string{ SudokuStrategyPipeline::name(strategy) } + ": in " + unitName(source) + ", " + valueList(values) + " can only go in the tiles it shares with "
+                    + unitName(target) + ", so no other tile in " + unitName(target) + " can be " + valueList(values, " or ") + ". " + eliminationList(eliminations);
+        return true;
+    }
+
+    static bool isIntersectionStrategy(SudokuStrategy strategy)
+    {
+        return strategy == SudokuStrategy::PointingPairs || strategy == SudokuStrategy::BoxLineReduction;
+    }
+    static bool isLine(std::size_t unit)
+    {
+        return unit_table::unitKind(unit) == unit_table::UnitKind::Row || unit_table::unitKind(unit) == unit_table::UnitKind::Column;
+    }
+    static mask_type allValues()
+    {
+        return static_cast<mask_type>(N*N == 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << (N*N)) - 1);
+    }
+
+    // Text
+    //============================================================
+    static std::string tileName(std::size_t tile)
+    {
+        return "r" + std::to_string(tile / (N*N) + 1) + "c" + std::to_string(tile % (N*N) + 1);
+    }
+
+    std::string unitName(std::size_t unit) const
+    {
+        switch (unit_table::unitKind(unit))
+        {
+        case unit_table::UnitKind::Row:     return "row " + std::to_string(unit + 1);
+        case unit_table::UnitKind::Column:  return "column " + std::to_string(unit - N*N + 1);
+        case unit_table::UnitKind::Region:  return (m_units->hasSquareRegions() ? "box " : "region ") + std::to_string(unit - 2*N*N + 1);
+        default:                            return "extra unit " + std::to_string(unit - 3*N*N + 1);
+        }
+    }
+
+    // "a", "a and b", "a, b and c"
+    static std::string joinList(std::vector<std::string> const& items, char const* last = " and ")
+    {
+        std::string result{};
+        for (std::size_t index = 0; index != items.size(); ++index)
+        {
+            if (index != 0)
+                result += index + 1 == items.size() ? last : ", ";
+            result += items[index];
+        }
+        return result;
+    }
+
+    static std::string valueList(std::uint64_t values, char const* last = " and ")
+    {
+        std::vector<std::string> items{};
+        for (std::uint64_t remaining = values; remaining != 0; remaining &= remaining - 1)
+            items.push_back(std::to_string(lowestBitIndex(remaining) + 1));
+        return joinList(items, last);
+    }
+
+    static std::string tileList(std::vector<std::size_t> const& tiles)
+    {
+        std::vector<std::string> items{};
+        for (std::size_t const tile : tiles)
+            items.push_back(tileName(tile));
+        return joinList(items);
+    }
+
+    // "Remove 3 from r1c2 and r1c7; 3 and 8 from r1c9.", tiles losing the same values together
+    static std::string eliminationList(std::vector<SudokuHint::Elimination> const& eliminations)
+    {
+        std::vector<bool> listed(eliminations.size(), false);
+        std::string result{ "Remove " };
+        for (std::size_t index = 0; index != eliminations.size(); ++index)
+        {
+            if (listed[index])
+                continue;
+            std::vector<std::size_t> tiles{};
+            for (std::size_t other = index; other != eliminations.size(); ++other)
+            {
+                if (eliminations[other].values == eliminations[index].values)
+                {
+                    tiles.push_back(eliminations[other].tile);
+                    listed[other] = true;
+                }
+            }
+            if (index != 0)
+                result += "; ";
+            result += valueList(eliminations[index].values) + " from " + tileList(tiles);
+        }
+        return result + ".";
+    }
+
+    // Data Members
+    //============================================================
+    SudokuStrategyPipeline m_pipeline;
+    std::shared_ptr<unit_table const> m_units;              // the table last seen, null to start again
+
+    // Each tile's candidates and whether it was solved, when last seen
+    std::array<mask_type, N*N*N*N> m_candidates;
+    std::array<bool, N*N*N*N> m_solved;
+
+    // How many levels each unit and intersection is known to have nothing at, and the generation
+    // each unit last changed in and each intersection was last looked at in
+    std::array<std::uint8_t, 4*N*N> m_unitLevels;           // unit_table::maxUnitCount()
+    std::array<std::uint64_t, 4*N*N> m_unitChanges;
+    std::vector<std::uint8_t> m_intersectionLevels;
+    std::vector<std::uint64_t> m_intersectionChecks;
+    std::uint64_t m_generation;                             // one per next()
+
+    std::size_t m_examined;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUHINTENGINE_H
@@ -0,0 +1,428 @@
+#ifndef SUDOKULOCALSEARCH_H
+#define SUDOKULOCALSEARCH_H
+/*
+struct SudokuLocalSearchStatistics
+====================================================================================================
+Counters filled in by SudokuLocalSearch<N>::solve(). Everything starts at 0.
+
+restarts        Number of annealing runs started, over all threads.
+moves           Number of swaps tried.
+acceptedMoves   Number of those swaps kept.
+bestCost        Fewest conflicts any run got down to; 0 if one found a solution.
+exact           Set if the exact solver had to finish the board.
+
+class SudokuLocalSearch<N>
+====================================================================================================
+Solves a SudokuBoard<N> by simulated annealing, for boards of 36x36 and up where the exact engines
+can take unbounded time on a puzzle that a heuristic would fill quickly. The board is propagated
+first, and every tile left unsolved is filled so that each square holds every digit once. From
+then on the only move is to swap two unsolved tiles of one square, so squares stay right and the
+cost is the number of repeated digits in rows and columns. Counts of each digit per row and column
+make a swap's change in cost a few lookups. A swap is only tried if each digit is still a candidate
+of the tile it moves to, which propagation usually leaves few of.
+
+Each run starts from a fresh random fill at a temperature taken from the spread of a sample of
+moves, and cools geometrically; a run that goes too long without improving is dropped and a new
+one started. Runs go on a thread per hardware thread by default, each with its own random
+stream, and the first to reach no conflicts stops the others.
+
+Annealing can't show a puzzle has no solution, so after a set number of runs without one the board
+is handed back to the exact solver. From 25x25 up that is SudokuSatEngine<N>, given the best run's
+filling as the value to try first for each tile, so it starts its search next to a state with only
+a few conflicts; below that it is SudokuBoard<N>::solveAll(). A solution found by annealing is
+checked through the board before it is accepted.
+
+Annealing is not picked automatically: it pays off on large sparse puzzles where the exact engines
+wander, and loses to them on most others.
+*/
+#include "sudokuboard.h"
+#include "sudokubits.h"
+#include "sudokucancellation.h"
+#include "sudokusatengine.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace puzzles
+{
+
+struct SudokuLocalSearchStatistics
+{
+    std::size_t restarts;
+    std::size_t moves;
+    std::size_t acceptedMoves;
+    std::size_t bestCost;
+    bool exact;
+};
+
+template <std::size_t N>
+class SudokuLocalSearch
+{
+public:
+    // Typedefs
+    //============================================================
+    using mask_type = typename SudokuBoard<N>::mask_type;
+
+    // Special 6
+    //============================================================
+    // threadCount 0 means one per hardware thread
+    explicit SudokuLocalSearch(std::size_t threadCount = 0) :
+        m_threadCount{ threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()) },
+        m_restarts{ 0 },
+        m_seed{ 0 },
+        m_statistics{}
+    {}
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // Solve the board. Returns true if it ends up solved; if there is no solution the board is
+    // left as propagation left it.
+    bool solve(SudokuBoard<N>& board)
+    {
+        return solve(board, SudokuCancellationToken{});
+    }
+    // Stopping early if the token is cancelled
+    bool solve(SudokuBoard<N>& board, SudokuCancellationToken const& cancellation)
+    {
+        m_statistics = SudokuLocalSearchStatistics{};
+        if (!board.propagateAll(cancellation))
+            return false;
+        if (board.isSolved())
+            return true;
+
+        Problem const problem{ board };
+        Run best{ anneal(problem, cancellation) };
+        if (best.cost == 0)
+        {
+            for (std::size_t tile : problem.freeTiles)
+                board.setTileSolution(tile / (N*N), tile % (N*N), best.values[tile]);
+            if (board.isSolved() && board.isConsistent())
+                return true;
+        }
+
+        // Hand over to the exact solver, starting from the best run's filling
+        m_statistics.exact = true;
+        if (N >= 5)
+        {
+            SudokuSatEngine<N> engine{};
+            engine.setPhaseHints(best.values);
+            return engine.solve(board, cancellation);
+        }
+        board.solveAll(cancellation);
+        return board.isSolved();
+    }
+
+    std::size_t threadCount() const
+    {
+        return m_threadCount;
+    }
+
+    // Annealing runs to try before handing over to the exact solver; 0, the default, for two
+    // per thread
+    void setRestarts(std::size_t restarts)
+    {
+        m_restarts = restarts;
+    }
+    // 0 and any other seed both give a fixed sequence of runs, different for each seed
+    void setSeed(std::uint64_t seed)
+    {
+        m_seed = seed;
+    }
+
+    // Counters from the last solve()
+    SudokuLocalSearchStatistics const& statistics() const
+    {
+        return m_statistics;
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    // What every run shares: the propagated board's values and candidates, and the unsolved
+    // tiles of each square
+    struct Problem
+    {
+        explicit Problem(SudokuBoard<N> const& board) :
+            values(N*N*N*N, 0),
+            candidates(N*N*N*N, 0),
+            freeTiles(),
+            squareTiles(N*N)
+        {
+            for (std::size_t tile = 0; tile != N*N*N*N; ++tile)
+            {
+                std::size_t const xPosition{ tile / (N*N) };
+                std::size_t const yPosition{ tile % (N*N) };
+                values[tile] = static_cast<std::uint8_t>(board.getTileSolution(xPosition, yPosition));
+                candidates[tile] = board.getTileCandidates(xPosition, yPosition);
+                if (values[tile] == 0)
+                {
+                    freeTiles.push_back(tile);
+                    squareTiles[xPosition / N * N + yPosition / N].push_back(tile);
+                }
+            }
+        }
+
+        std::vector<std::uint8_t> values;
+        std::vector<mask_type> candidates;
+        std::vector<std::size_t> freeTiles;
+        std::vector<std::vector<std::size_t>> squareTiles;
+    };
+
+    // One run's state: every tile's value, and how often each digit is in each row and column
+    struct Run
+    {
+        std::vector<std::uint8_t> values;
+        std::vector<std::uint16_t> rowCounts;       // row * (N*N+1) + digit
+        std::vector<std::uint16_t> columnCounts;
+        std::size_t cost;
+    };
+
+    // Helpers
+    //============================================================
+    // Run the restarts over the threads and return the best state any of them reached
+    Run anneal(Problem const& problem, SudokuCancellationToken const& cancellation)
+    {
+        std::size_t const restarts{ m_restarts != 0 ? m_restarts : 2 * m_threadCount };
+        SudokuCancellationToken const found{ SudokuCancellationToken::linkedTo(cancellation) };
+        std::atomic<std::size_t> nextRestart{ 0 };
+        std::mutex bestMutex{};
+        Run best{ {}, {}, {}, static_cast<std::size_t>(-1) };
+
+        auto const work = [this, &problem, &found, &nextRestart, &bestMutex, &best, restarts]()
+        {
+            SudokuLocalSearchStatistics statistics{};
+            for (std::size_t restart = nextRestart++; restart < restarts && !found.shouldStop(); restart = nextRestart++)
+            {
+                std::mt19937_64 random{ m_seed * 0x9E3779B97F4A7C15 + restart };
+                Run run{ annealOnce(problem, random, found, statistics) };
+                ++statistics.restarts;
+
+                std::lock_guard<std::mutex> lock{ bestMutex };
+                if (run.cost < best.cost)
+                    best = std::move(run);
+                if (best.cost == 0)
+                    found.cancel();
+            }
+
+            std::lock_guard<std::mutex> lock{ bestMutex };
+            m_statistics.restarts += statistics.restarts;
+            m_statistics.moves += statistics.moves;
+            m_statistics.acceptedMoves += statistics.acceptedMoves;
+        };
+
+        std::vector<std::thread> threads{};
+        for (std::size_t index = 1; index < std::min(m_threadCount, restarts); ++index)
+            threads.emplace_back(work);
+        work();
+        for (auto& thread : threads)
+            thread.join();
+
+        m_statistics.bestCost = best.cost;
+        return best;
+    }
+
+    // One run from a fresh fill, until it has no conflicts, stalls, or is stopped. Returns the
+    // lowest cost state it reached.
+    static Run annealOnce(Problem const& problem, std::mt19937_64& random, SudokuCancellationToken const& stop,
+                          SudokuLocalSearchStatistics& statistics)
+    {
+        Run run{ fill(problem, random) };
+        Run best{ run };
+        std::vector<std::size_t> squares{};
+        for (std::size_t square = 0; square != N*N; ++square)
+        {
+            if (problem.squareTiles[square].size() >= 2)
+                squares.push_back(square);
+        }
+        // With at most one unsolved tile per square the fill is the only state there is
+        if (run.cost == 0 || squares.empty())
+            return best;
+
+        // Start hot enough to accept a typical uphill move about as often as not
+        double temperature{ 0.0 };
+        {
+            double sum{ 0.0 }, sumOfSquares{ 0.0 };
+            std::size_t const samples{ 200 };
+            for (std::size_t sample = 0; sample != samples; ++sample)
+            {
+                std::size_t first{ 0 }, second{ 0 };
+                pickMove(problem, squares, random, first, second);
+                double const delta{ static_cast<double>(swapDelta(run, first, second)) };
+                sum += delta;
+                sumOfSquares += delta * delta;
+            }
+            double const mean{ sum / samples };
+            temperature = std::max(0.5, std::sqrt(std::max(0.0, sumOfSquares / samples - mean * mean)));
+        }
+
+        std::size_t const chainLength{ std::max<std::size_t>(100, problem.freeTiles.size() * 4) };
+        std::size_t const stallLimit{ 300 };
+        double const cooling{ 0.999 };
+        std::uniform_real_distribution<double> uniform{ 0.0, 1.0 };
+        std::size_t stalled{ 0 };
+        while (run.cost != 0 && stalled < stallLimit && !stop.shouldStop())
+        {
+            for (std::size_t step = 0; step != chainLength && run.cost != 0; ++step)
+            {
+                std::size_t first{ 0 }, second{ 0 };
+                pickMove(problem, squares, random, first, second);
+                if (!canSwap(problem, run, first, second))
+                    continue;
+                ++statistics.moves;
+                long const delta{ swapDelta(run, first, second) };
+                if (delta <= 0 || uniform(random) < std::exp(-static_cast<double>(delta) / temperature))
+                {
+                    applySwap(run, first, second, delta);
+                    ++statistics.acceptedMoves;
+                }
+            }
+
+            if (run.cost < best.cost)
+            {
+                best = run;
+                stalled = 0;
+            }
+            else
+            {
+                ++stalled;
+            }
+            temperature *= cooling;
+        }
+        return run.cost < best.cost ? run : best;
+    }
+
+    // Every square's missing digits, spread over its unsolved tiles: the tiles with fewest
+    // candidates first, each taking a random one of the missing digits it can be, or any left if
+    // none fit
+    static Run fill(Problem const& problem, std::mt19937_64& random)
+    {
+        Run run{ problem.values, std::vector<std::uint16_t>(N*N * (N*N+1), 0), std::vector<std::uint16_t>(N*N * (N*N+1), 0), 0 };
+        for (std::size_t square = 0; square != N*N; ++square)
+        {
+            std::vector<std::size_t> tiles{ problem.squareTiles[square] };
+            if (tiles.empty())
+                continue;
+            mask_type missing{ SudokuMask<N*N>::full() };
+            for (std::size_t index = 0; index != N*N; ++index)
+            {
+                std::size_t const tile{ (square / N * N + index / N) * N*N + square % N * N + index % N };
+                if (problem.values[tile] != 0)
+                    missing &= static_cast<mask_type>(~(mask_type{ 1 } << (problem.values[tile] - 1)));
+            }
+
+            std::shuffle(tiles.begin(), tiles.end(), random);
+            std::stable_sort(tiles.begin(), tiles.end(), [&problem](std::size_t lhs, std::size_t rhs)
+            {
+                return popCount(problem.candidates[lhs]) < popCount(problem.candidates[rhs]);
+            });
+            for (std::size_t tile : tiles)
+            {
+                mask_type const fitting{ static_cast<mask_type>(missing & problem.candidates[tile]) };
+                mask_type const choices{ fitting != 0 ? fitting : missing };
+                std::size_t pick{ static_cast<std::size_t>(random() % popCount(choices)) };
+                mask_type remaining{ choices };
+                while (pick-- != 0)
+                    remaining &= static_cast<mask_type>(remaining - 1);
+                std::size_t const value{ lowestBitIndex(remaining) + 1 };
+                run.values[tile] = static_cast<std::uint8_t>(value);
+                missing &= static_cast<mask_type>(~(mask_type{ 1 } << (value - 1)));
+            }
+        }
+
+        for (std::size_t tile = 0; tile != N*N*N*N; ++tile)
+        {
+            std::size_t const value{ run.values[tile] };
+            if (run.rowCounts[tile / (N*N) * (N*N+1) + value]++ != 0)
+                ++run.cost;
+            if (run.columnCounts[tile % (N*N) * (N*N+1) + value]++ != 0)
+                ++run.cost;
+        }
+        return run;
+    }
+
+    // Two different unsolved tiles of one square
+    static void pickMove(Problem const& problem, std::vector<std::size_t> const& squares, std::mt19937_64& random,
+                         std::size_t& first, std::size_t& second)
+    {
+        std::vector<std::size_t> const& tiles = problem.squareTiles[squares[random() % squares.size()]];
+        std::size_t const firstIndex{ static_cast<std::size_t>(random() % tiles.size()) };
+        std::size_t secondIndex{ static_cast<std::size_t>(random() % (tiles.size() - 1)) };
+        if (secondIndex >= firstIndex)
+            ++secondIndex;
+        first = tiles[firstIndex];
+        second = tiles[secondIndex];
+    }
+
+    // Is each tile's value a candidate of the other tile?
+    static bool canSwap(Problem const& problem, Run const& run, std::size_t first, std::size_t second)
+    {
+        return (problem.candidates[first] & (mask_type{ 1 } << (run.values[second] - 1))) != 0
+            && (problem.candidates[second] & (mask_type{ 1 } << (run.values[first] - 1))) != 0;
+    }
+
+    // The change in cost from swapping two tiles of a square
+    static long swapDelta(Run const& run, std::size_t first, std::size_t second)
+    {
+        std::size_t const firstValue{ run.values[first] };
+        std::size_t const secondValue{ run.values[second] };
+        if (firstValue == secondValue)
+            return 0;
+
+        long delta{ 0 };
+        std::size_t const firstRow{ first / (N*N) }, secondRow{ second / (N*N) };
+        if (firstRow != secondRow)
+        {
+            delta += lineDelta(run.rowCounts.data() + firstRow * (N*N+1), firstValue, secondValue);
+            delta += lineDelta(run.rowCounts.data() + secondRow * (N*N+1), secondValue, firstValue);
+        }
+        std::size_t const firstColumn{ first % (N*N) }, secondColumn{ second % (N*N) };
+        if (firstColumn != secondColumn)
+        {
+            delta += lineDelta(run.columnCounts.data() + firstColumn * (N*N+1), firstValue, secondValue);
+            delta += lineDelta(run.columnCounts.data() + secondColumn * (N*N+1), secondValue, firstValue);
+        }
+        return delta;
+    }
+
+    // The change in a row or column's repeats from one of its tiles going from one value to another
+    static long lineDelta(std::uint16_t const* counts, std::size_t from, std::size_t to)
+    {
+        return (counts[to] >= 1 ? 1 : 0) - (counts[from] >= 2 ? 1 : 0);
+    }
+
+    static void applySwap(Run& run, std::size_t first, std::size_t second, long delta)
+    {
+        std::size_t const firstValue{ run.values[first] };
+        std::size_t const secondValue{ run.values[second] };
+        --run.rowCounts[first / (N*N) * (N*N+1) + firstValue];
+        --run.columnCounts[first % (N*N) * (N*N+1) + firstValue];
+        --run.rowCounts[second / (N*N) * (N*N+1) + secondValue];
+        --run.columnCounts[second % (N*N) * (N*N+1) + secondValue];
+        ++run.rowCounts[first / (N*N) * (N*N+1) + secondValue];
+        ++run.columnCounts[first % (N*N) * (N*N+1) + secondValue];
+        ++run.rowCounts[second / (N*N) * (N*N+1) + firstValue];
+        ++run.columnCounts[second % (N*N) * (N*N+1) + firstValue];
+        run.values[first] = static_cast<std::uint8_t>(secondValue);
+        run.values[second] = static_cast<std::uint8_t>(firstValue);
+        run.cost = static_cast<std::size_t>(static_cast<long>(run.cost) + delta);
+    }
+
+    // Data Members
+    //============================================================
+    std::size_t m_threadCount;
+    std::size_t m_restarts;
+    std::uint64_t m_seed;
+    SudokuLocalSearchStatistics m_statistics;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKULOCALSEARCH_H
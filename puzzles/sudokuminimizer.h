@@ -0,0 +1,294 @@
+#ifndef SUDOKUMINIMIZER_H
+#define SUDOKUMINIMIZER_H
+/*
+struct SudokuMinimizeReport<N>
+====================================================================================================
+The result of minimizing one puzzle: the minimal puzzle, how many clues it started with and how many
+were removed, how many uniqueness checks were run and the time they took between them, and the
+total time. A puzzle that didn't have exactly one solution to begin with is handed back unchanged
+with unique set to false.
+
+class SudokuMinimizer<N>
+====================================================================================================
+Removes clues from a puzzle with a unique solution until every clue left is needed for it to stay
+unique.
+
+Removing a clue keeps the puzzle unique exactly when the puzzle without it, and with that tile made
+anything but the clue's value, has no solution; so each check is one solve that usually fails
+quickly rather than a count of solutions. Clues are tried most crowded first: a clue with many
+other clues in its row, column and square is the most likely to be implied by them.
+
+Checks are run a batch at a time. The clues outside the batch are placed and propagated once, and
+each check starts from a copy of that board, so the work of propagating most of the puzzle is
+shared by the whole batch. With more than one thread the checks of a batch run in parallel. A clue
+found to be needed stays needed however many other clues are removed later, so those results are
+always kept; a clue found removable is removed, and any later removable clues in the batch are
+checked again against the smaller puzzle.
+
+minimizeAll() minimizes many puzzles at once, one per thread, which is the faster way to work
+through a corpus.
+*/
+#include "sudokuboard.h"
+#include "sudokubits.h"
+#include "sudokusolutionenumerator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace puzzles
+{
+
+template <std::size_t N>
+struct SudokuMinimizeReport
+{
+    SudokuBoard<N> board;
+    bool unique;
+    std::size_t cluesBefore;
+    std::size_t cluesRemoved;
+    std::size_t checks;
+    std::chrono::nanoseconds checkTime;
+    std::chrono::nanoseconds time;
+};
+
+template <std::size_t N>
+class SudokuMinimizer
+{
+public:
+    // Typedefs
+    //============================================================
+    using mask_type = typename SudokuBoard<N>::mask_type;
+
+    // Special 6
+    //============================================================
+    // threadCount 0 means one per hardware thread
+    explicit SudokuMinimizer(std::size_t threadCount = 1) :
+        m_threadCount{ threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()) },
+        m_batchSize{ 4 }
+    {}
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    SudokuMinimizeReport<N> minimize(SudokuBoard<N> const& puzzle) const
+    {
+        return minimize(puzzle, m_threadCount);
+    }
+
+    // Minimize every puzzle, spreading the puzzles over the threads
+    std::vector<SudokuMinimizeReport<N>> minimizeAll(std::vector<SudokuBoard<N>> const& puzzles) const
+    {
+        std::vector<SudokuMinimizeReport<N>> result(puzzles.size());
+        std::atomic<std::size_t> next{ 0 };
+        auto const work = [this, &puzzles, &result, &next]()
+        {
+            for (std::size_t index = next++; index < puzzles.size(); index = next++)
+                result[index] = minimize(puzzles[index], 1);
+        };
+
+        std::vector<std::thread> threads{};
+        for (std::size_t index = 1; index < std::min(m_threadCount, puzzles.size()); ++index)
+            threads.emplace_back(work);
+        work();
+        for (auto& thread : threads)
+            thread.join();
+        return result;
+    }
+
+    std::size_t threadCount() const
+    {
+        return m_threadCount;
+    }
+
+    // Clues checked against one propagated board; at least the thread count is used
+    std::size_t batchSize() const
+    {
+        return m_batchSize;
+    }
+    void setBatchSize(std::size_t batchSize)
+    {
+        m_batchSize = std::max<std::size_t>(1, batchSize);
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    using clock_type = std::chrono::steady_clock;
+
+    struct Clue
+    {
+        std::size_t xPosition;
+        std::size_t yPosition;
+        std::size_t value;
+    };
+
+    // Helpers
+    //============================================================
+    SudokuMinimizeReport<N> minimize(SudokuBoard<N> const& puzzle, std::size_t threadCount) const
+    {
+        clock_type::time_point const start{ clock_type::now() };
+        SudokuMinimizeReport<N> report{ puzzle, false, 0, 0, 0, std::chrono::nanoseconds{ 0 }, std::chrono::nanoseconds{ 0 } };
+
+        std::vector<Clue> pending{ cluesOf(puzzle) };
+        report.cluesBefore = pending.size();
+
+        // Make sure there is exactly one solution to keep
+        {
+            clock_type::time_point const checkStart{ clock_type::now() };
+            SudokuSolutionEnumerator<N> solutions{ puzzle };
+            report.unique = solutions.next() && !solutions.next();
+            report.checkTime += clock_type::now() - checkStart;
+            ++report.checks;
+        }
+        if (!report.unique)
+        {
+            report.time = clock_type::now() - start;
+            return report;
+        }
+
+        // Most crowded first, so the likeliest removals come early
+        std::vector<std::size_t> crowding(N*N*N*N, 0);
+        for (auto const& clue : pending)
+            crowding[clue.xPosition * N*N + clue.yPosition] = cluePeers(pending, clue);
+        std::stable_sort(pending.begin(), pending.end(), [&crowding](Clue const& lhs, Clue const& rhs)
+        {
+            return crowding[lhs.xPosition * N*N + lhs.yPosition] > crowding[rhs.xPosition * N*N + rhs.yPosition];
+        });
+
+        std::vector<Clue> kept{};
+        std::size_t const batchSize{ std::max(m_batchSize, threadCount) };
+        std::vector<char> removable{};
+        std::vector<std::chrono::nanoseconds> checkTimes{};
+        while (!pending.empty())
+        {
+            std::size_t const count{ std::min(batchSize, pending.size()) };
+
+            // Everything but the batch, placed and propagated once for the batch's checks
+            SudokuBoard<N> base{};
+            for (auto const& clue : kept)
+                base.setTileSolution(clue.xPosition, clue.yPosition, clue.value);
+            for (std::size_t index = count; index != pending.size(); ++index)
+                base.setTileSolution(pending[index].xPosition, pending[index].yPosition, pending[index].value);
+            base.propagateAll();
+
+            removable.assign(count, 0);
+            checkTimes.assign(count, std::chrono::nanoseconds{ 0 });
+            if (threadCount > 1 && count > 1)
+            {
+                // Check the whole batch at once
+                std::atomic<std::size_t> next{ 0 };
+                auto const work = [&base, &pending, &removable, &checkTimes, &next, count]()
+                {
+                    for (std::size_t index = next++; index < count; index = next++)
+                        removable[index] = isRemovable(base, pending, count, index, checkTimes[index]);
+                };
+                std::vector<std::thread> threads{};
+                for (std::size_t index = 1; index < std::min(threadCount, count); ++index)
+                    threads.emplace_back(work);
+                work();
+                for (auto& thread : threads)
+                    thread.join();
+                report.checks += count;
+            }
+            else
+            {
+                // One at a time, stopping at the first removal since the rest need checking again
+                for (std::size_t index = 0; index != count; ++index)
+                {
+                    removable[index] = isRemovable(base, pending, count, index, checkTimes[index]);
+                    ++report.checks;
+                    if (removable[index])
+                        break;
+                }
+            }
+            for (auto const& time : checkTimes)
+                report.checkTime += time;
+
+            // Keep the needed clues, remove the first removable one, and check the rest again
+            std::vector<Clue> retry{};
+            bool removed{ false };
+            for (std::size_t index = 0; index != count; ++index)
+            {
+                if (!removable[index] && checkTimes[index].count() != 0)
+                    kept.push_back(pending[index]);
+                else if (removable[index] && !removed)
+                    removed = true;
+                else
+                    retry.push_back(pending[index]);
+            }
+            if (removed)
+                ++report.cluesRemoved;
+            pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(count));
+            pending.insert(pending.begin(), retry.begin(), retry.end());
+        }
+
+        report.board = SudokuBoard<N>{};
+        for (auto const& clue : kept)
+            report.board.setTileSolution(clue.xPosition, clue.yPosition, clue.value);
+        report.time = clock_type::now() - start;
+        return report;
+    }
+
+    // Could the index-th clue of the batch go? Only if the puzzle without it has no solution where
+    // its tile is anything else.
+    static bool isRemovable(SudokuBoard<N> const& base, std::vector<Clue> const& batch, std::size_t count, std::size_t index,
+                            std::chrono::nanoseconds& time)
+    {
+        clock_type::time_point const start{ clock_type::now() };
+        SudokuBoard<N> board{ base };
+        for (std::size_t other = 0; other != count; ++other)
+        {
+            if (other != index)
+                board.setTileSolution(batch[other].xPosition, batch[other].yPosition, batch[other].value);
+        }
+        Clue const& clue = batch[index];
+        board.eliminateTileCandidates(clue.xPosition, clue.yPosition, static_cast<mask_type>(mask_type{ 1 } << (clue.value - 1)));
+        board.solveAll();
+        bool const result{ !board.isSolved() };
+
+        // Never 0, so a check that ran can be told from one that didn't
+        time = std::max(std::chrono::nanoseconds{ 1 }, std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start));
+        return result;
+    }
+
+    static std::vector<Clue> cluesOf(SudokuBoard<N> const& puzzle)
+    {
+        std::vector<Clue> result{};
+        for (std::size_t xPosition = 0; xPosition != N*N; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != N*N; ++yPosition)
+            {
+                std::size_t const value{ puzzle.getTileSolution(xPosition, yPosition) };
+                if (value != 0)
+                    result.push_back(Clue{ xPosition, yPosition, value });
+            }
+        }
+        return result;
+    }
+
+    // How many other clues share a row, column or square with this one
+    static std::size_t cluePeers(std::vector<Clue> const& clues, Clue const& clue)
+    {
+        std::size_t result{ 0 };
+        for (auto const& other : clues)
+        {
+            bool const sameTile{ other.xPosition == clue.xPosition && other.yPosition == clue.yPosition };
+            if (!sameTile && (other.xPosition == clue.xPosition || other.yPosition == clue.yPosition
+                              || (other.xPosition / N == clue.xPosition / N && other.yPosition / N == clue.yPosition / N)))
+                ++result;
+        }
+        return result;
+    }
+
+    // Data Members
+    //============================================================
+    std::size_t m_threadCount;
+    std::size_t m_batchSize;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUMINIMIZER_H
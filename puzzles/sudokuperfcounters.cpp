@@ -0,0 +1,226 @@
+#include "sudokuperfcounters.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    char const* const c_names[4]{ "cycles", "instructions", "cache misses", "branch misses" };
+
+#if defined(__linux__)
+    std::uint64_t const c_configs[4]{ PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+    // What a group read returns with PERF_FORMAT_GROUP and both times
+    struct GroupRead
+    {
+        std::uint64_t count;
+        std::uint64_t timeEnabled;
+        std::uint64_t timeRunning;
+        std::uint64_t values[4];
+    };
+
+    int openCounter(std::uint64_t config, int groupFile)
+    {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = config;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attributes.disabled = groupFile == -1 ? 1 : 0;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupFile, 0));
+    }
+
+    std::string reason(int error)
+    {
+        switch (error)
+        {
+        case EACCES:
+        case EPERM:         return "not permitted (see /proc/sys/kernel/perf_event_paranoid)";
+        case ENOENT:
+        case EOPNOTSUPP:    return "not supported by this CPU or virtual machine";
+        case ENOSYS:        return "not supported by this kernel";
+        default:            return std::strerror(error);
+        }
+    }
+#endif
+
+    std::uint64_t* field(puzzles::SudokuPerfSample& sample, std::size_t index)
+    {
+        std::uint64_t* const fields[4]{ &sample.cycles, &sample.instructions, &sample.cacheMisses, &sample.branchMisses };
+        return fields[index];
+    }
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuPerfCounters::SudokuPerfCounters() :
+    m_groupFile{ -1 },
+    m_files{ -1, -1, -1, -1 },
+    m_order{ 0, 0, 0, 0 },
+    m_openCount{ 0 },
+    m_errorString{}
+{
+#if defined(__linux__)
+    std::string firstReason{};
+    bool sameReason{ true };
+    for (std::size_t index = 0; index != 4; ++index)
+    {
+        int const file{ openCounter(c_configs[index], m_groupFile) };
+        if (file == -1)
+        {
+            std::string const why{ reason(errno) };
+            sameReason &= firstReason.empty() || why == firstReason;
+            if (firstReason.empty())
+                firstReason = why;
+            m_errorString += (m_errorString.empty() ? "" : "; ") + std::string{ c_names[index] } + ": " + why;
+            continue;
+        }
+        if (m_groupFile == -1)
+            m_groupFile = file;
+        m_files[index] = file;
+        m_order[m_openCount++] = std::uint32_t{ 1 } << index;
+    }
+    // None open for the same reason: say it once
+    if (m_groupFile == -1 && sameReason)
+        m_errorString = firstReason;
+    if (m_groupFile != -1)
+    {
+        ioctl(m_groupFile, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_groupFile, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    m_errorString = "hardware counters are only read on Linux";
+#endif
+}
+
+puzzles::SudokuPerfCounters::~SudokuPerfCounters()
+{
+#if defined(__linux__)
+    for (int file : m_files)
+    {
+        if (file != -1)
+            close(file);
+    }
+#endif
+}
+
+// Interface
+//============================================================
+bool puzzles::SudokuPerfCounters::isAvailable() const
+{
+    return m_groupFile != -1;
+}
+
+std::uint32_t puzzles::SudokuPerfCounters::counters() const
+{
+    std::uint32_t result{ 0 };
+    for (std::size_t index = 0; index != m_openCount; ++index)
+        result |= m_order[index];
+    return result;
+}
+
+std::string const& puzzles::SudokuPerfCounters::errorString() const
+{
+    return m_errorString;
+}
+
+puzzles::SudokuPerfSample puzzles::SudokuPerfCounters::read() const
+{
+    SudokuPerfSample result{};
+#if defined(__linux__)
+    GroupRead group{};
+    if (m_groupFile == -1 || ::read(m_groupFile, &group, sizeof(group)) < static_cast<ssize_t>(3 * sizeof(std::uint64_t)))
+        return result;
+
+    // Scaled up for any time the group wasn't on the hardware
+    double const scale{ group.timeRunning != 0 && group.timeRunning < group.timeEnabled
+                        ? static_cast<double>(group.timeEnabled) / static_cast<double>(group.timeRunning) : 1.0 };
+    for (std::size_t index = 0; index != group.count && index != m_openCount; ++index)
+    {
+        std::uint32_t const counter{ m_order[index] };
+        std::uint64_t const value{ scale == 1.0 ? group.values[index]
+                                   : static_cast<std::uint64_t>(std::llround(static_cast<double>(group.values[index]) * scale)) };
+        for (std::size_t bit = 0; bit != 4; ++bit)
+        {
+            if (counter == std::uint32_t{ 1 } << bit)
+                *field(result, bit) = value;
+        }
+        result.counted |= counter;
+    }
+#endif
+    return result;
+}
+
+void puzzles::SudokuPerfCounters::addSince(SudokuPerfSample const& start, SudokuPerfSample& total) const
+{
+    SudokuPerfSample now{ read() };
+    now.cycles -= start.cycles;
+    now.instructions -= start.instructions;
+    now.cacheMisses -= start.cacheMisses;
+    now.branchMisses -= start.branchMisses;
+    add(total, now);
+}
+
+void puzzles::SudokuPerfCounters::add(SudokuPerfSample& total, SudokuPerfSample const& part)
+{
+    total.cycles += part.cycles;
+    total.instructions += part.instructions;
+    total.cacheMisses += part.cacheMisses;
+    total.branchMisses += part.branchMisses;
+    total.counted |= part.counted;
+}
+
+double puzzles::SudokuPerfCounters::instructionsPerCycle(SudokuPerfSample const& sample)
+{
+    if ((sample.counted & (Cycles | Instructions)) != (Cycles | Instructions) || sample.cycles == 0)
+        return 0.0;
+    return static_cast<double>(sample.instructions) / static_cast<double>(sample.cycles);
+}
+
+std::string puzzles::SudokuPerfCounters::format(SudokuPerfSample const& sample, std::size_t puzzles)
+{
+    if (sample.counted == 0)
+        return "counters=none";
+
+    double const divisor{ static_cast<double>(puzzles != 0 ? puzzles : 1) };
+    std::ostringstream text{};
+    text.setf(std::ios::fixed);
+    text.precision(0);
+    char const* separator{ "" };
+    if ((sample.counted & Cycles) != 0)
+    {
+        text << separator << "cycles=" << static_cast<double>(sample.cycles) / divisor;
+        separator = " ";
+    }
+    if ((sample.counted & Instructions) != 0)
+    {
+        text << separator << "instructions=" << static_cast<double>(sample.instructions) / divisor;
+        separator = " ";
+    }
+    if ((sample.counted & (Cycles | Instructions)) == (Cycles | Instructions))
+    {
+        text.precision(2);
+        text << separator << "ipc=" << instructionsPerCycle(sample);
+        text.precision(0);
+    }
+    if ((sample.counted & CacheMisses) != 0)
+    {
+        text << separator << "cache_misses=" << static_cast<double>(sample.cacheMisses) / divisor;
+        separator = " ";
+    }
+    if ((sample.counted & BranchMisses) != 0)
+        text << separator << "branch_misses=" << static_cast<double>(sample.branchMisses) / divisor;
+    return text.str();
+}
@@ -0,0 +1,100 @@
+#ifndef SUDOKUPERFCOUNTERS_H
+#define SUDOKUPERFCOUNTERS_H
+/*
+struct SudokuPerfSample
+====================================================================================================
+Hardware counter totals: CPU cycles, instructions retired, last level cache misses and mispredicted
+branches, all in user space only. counted has a SudokuPerfCounters::Counter bit for each count that
+was actually read; the others are 0. Samples from several threads or processes add up with
+SudokuPerfCounters::add().
+
+class SudokuPerfCounters
+====================================================================================================
+The hardware counters of the calling thread, through Linux perf_event_open(). The four counters
+are opened as one group, so a read is a single system call that gives them all at the same moment,
+and they are counted for user space only, which the default perf_event_paranoid setting of 2
+allows.
+
+Counters are often not there: the kernel may forbid them, a virtual machine may not pass them
+through, and other systems don't have perf_event_open() at all. Any counter that can't be opened
+is left out and errorString() says why; with none open, isAvailable() is false and read() returns
+an empty sample, so callers can always read and report, and only the report changes.
+
+If the kernel has to share the hardware between more counters than it has, each count is scaled
+up from the time it was actually counting.
+
+The object belongs to the thread that made it: it counts that thread and no other.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace puzzles
+{
+
+struct SudokuPerfSample
+{
+    std::uint64_t cycles;
+    std::uint64_t instructions;
+    std::uint64_t cacheMisses;
+    std::uint64_t branchMisses;
+    std::uint32_t counted;
+};
+
+class SudokuPerfCounters
+{
+public:
+    // Typedefs
+    //============================================================
+    enum Counter : std::uint32_t
+    {
+        Cycles = 1,
+        Instructions = 2,
+        CacheMisses = 4,
+        BranchMisses = 8
+    };
+
+    // Special 6
+    //============================================================
+    // Open the counters for the calling thread
+    SudokuPerfCounters();
+    ~SudokuPerfCounters();
+
+    // No copying
+    SudokuPerfCounters(SudokuPerfCounters const& other) = delete;
+    SudokuPerfCounters& operator=(SudokuPerfCounters const& other) = delete;
+
+    // Interface
+    //============================================================
+    // Is at least one counter open?
+    bool isAvailable() const;
+    // The Counter bits of the counters that are open
+    std::uint32_t counters() const;
+    // Why some or all of the counters couldn't be opened, empty if they all were
+    std::string const& errorString() const;
+
+    // The totals since the counters were opened
+    SudokuPerfSample read() const;
+    // Add what was counted since start to total
+    void addSince(SudokuPerfSample const& start, SudokuPerfSample& total) const;
+
+    static void add(SudokuPerfSample& total, SudokuPerfSample const& part);
+    // Instructions per cycle, 0 without both counts
+    static double instructionsPerCycle(SudokuPerfSample const& sample);
+    // The counts divided by puzzles, as cycles=<n> instructions=<n> ipc=<x> cache_misses=<n>
+    // branch_misses=<n>, leaving out the ones not counted; "counters=none" if none were
+    static std::string format(SudokuPerfSample const& sample, std::size_t puzzles);
+
+private:
+    // Data Members
+    //============================================================
+    int m_groupFile;                // the group leader, -1 if nothing is open
+    int m_files[4];                 // per Counter bit, -1 if not open
+    std::uint32_t m_order[4];       // the Counter of each value a group read returns
+    std::size_t m_openCount;
+    std::string m_errorString;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUPERFCOUNTERS_H
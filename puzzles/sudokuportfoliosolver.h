@@ -0,0 +1,182 @@
+#ifndef SUDOKUPORTFOLIOSOLVER_H
+#define SUDOKUPORTFOLIOSOLVER_H
+/*
+struct SudokuPortfolioStatistics
+====================================================================================================
+What happened in the last SudokuPortfolioSolver<N>::solve(), and how often each entry has won.
+
+winner              Index of the entry whose answer was used, or entries().size() if none finished.
+winnerOptions       That entry's options.
+winnerEngine        The engine it ran, never Automatic.
+searchStatistics    Its statistics, if it ran propagation.
+satStatistics       Its statistics, if it ran the SAT engine.
+time                Wall time from starting the threads to having an answer.
+wins                Per entry, how many solves it has won since the statistics were reset.
+
+class SudokuPortfolioSolver<N>
+====================================================================================================
+Runs several SudokuSolver<N> configurations at once, each on its own thread with its own copy of the
+board, and takes the answer of whichever finishes first: a solved board, or proof that there is no
+solution. The rest are cancelled through a shared SudokuCancellationToken and joined before
+solve() returns.
+
+A puzzle that is pathological for one engine or branching order is rarely so for all of them, so
+the portfolio's time is close to the best entry's rather than the average. The default mix covers
+both engines with two seeds each; the win counts show which entries are worth keeping.
+*/
+#include "sudokuboard.h"
+#include "sudokucancellation.h"
+#include "sudokusolver.h"
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace puzzles
+{
+
+struct SudokuPortfolioStatistics
+{
+    std::size_t winner;
+    SudokuSolveOptions winnerOptions;
+    SudokuEngine winnerEngine;
+    SudokuSearchStatistics searchStatistics;
+    SudokuSatStatistics satStatistics;
+    std::chrono::nanoseconds time;
+    std::vector<std::size_t> wins;
+};
+
+template <std::size_t N>
+class SudokuPortfolioSolver
+{
+public:
+    // Special 6
+    //============================================================
+    SudokuPortfolioSolver() :
+        SudokuPortfolioSolver(defaultEntries())
+    {}
+    explicit SudokuPortfolioSolver(std::vector<SudokuSolveOptions> const& entries) :
+        m_entries(entries),
+        m_statistics{}
+    {
+        resetStatistics();
+    }
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // Solve the board with every entry at once, keeping the first answer. Returns true if the
+    // board ends up solved. With no entries this is a plain SudokuSolver<N> solve.
+    bool solve(SudokuBoard<N>& board)
+    {
+        return solve(board, SudokuCancellationToken{});
+    }
+    // Cancelling the token stops every entry
+    bool solve(SudokuBoard<N>& board, SudokuCancellationToken const& cancellation)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        m_statistics.winner = m_entries.size();
+        m_statistics.searchStatistics = SudokuSearchStatistics{};
+        m_statistics.satStatistics = SudokuSatStatistics{};
+
+        if (m_entries.empty())
+        {
+            SudokuSolver<N> solver{};
+            solver.solve(board, cancellation);
+            m_statistics.time = std::chrono::steady_clock::now() - start;
+            return board.isSolved();
+        }
+
+        // The losers are stopped through a token of their own, linked to the caller's. Every
+        // copy is made before any thread starts so the winner can't change what a slow starter
+        // copies.
+        SudokuCancellationToken const losers{ SudokuCancellationToken::linkedTo(cancellation) };
+        std::vector<SudokuBoard<N>> copies(m_entries.size(), board);
+        std::mutex mutex{};
+
+        std::vector<std::thread> threads{};
+        threads.reserve(m_entries.size());
+        for (std::size_t index = 0; index != m_entries.size(); ++index)
+        {
+            threads.emplace_back([this, index, &copies, &losers, &mutex]()
+            {
+                SudokuSolver<N> solver{ m_entries[index] };
+                bool const solved{ solver.solve(copies[index], losers) };
+
+                // Cancelled entries have no answer; the others either solved it or proved it
+                // can't be
+                if (!solved && losers.shouldStop())
+                    return;
+
+                std::lock_guard<std::mutex> lock{ mutex };
+                if (m_statistics.winner != m_entries.size())
+                    return;
+                losers.cancel();
+
+                m_statistics.winner = index;
+                m_statistics.winnerOptions = m_entries[index];
+                m_statistics.winnerEngine = solver.engine();
+                m_statistics.searchStatistics = solver.searchStatistics();
+                m_statistics.satStatistics = solver.satStatistics();
+                ++m_statistics.wins[index];
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        if (m_statistics.winner != m_entries.size())
+            board = copies[m_statistics.winner];
+        m_statistics.time = std::chrono::steady_clock::now() - start;
+        return board.isSolved();
+    }
+
+    std::vector<SudokuSolveOptions> const& entries() const
+    {
+        return m_entries;
+    }
+    // Replaces the entries and resets the statistics
+    void setEntries(std::vector<SudokuSolveOptions> const& entries)
+    {
+        m_entries = entries;
+        resetStatistics();
+    }
+
+    SudokuPortfolioStatistics const& statistics() const
+    {
+        return m_statistics;
+    }
+    void resetStatistics()
+    {
+        m_statistics = SudokuPortfolioStatistics{};
+        m_statistics.winner = m_entries.size();
+        m_statistics.wins.assign(m_entries.size(), 0);
+    }
+
+    // Both engines, each with its default order and one seeded order, limited to the number of
+    // hardware threads (but at least 2)
+    static std::vector<SudokuSolveOptions> defaultEntries()
+    {
+        std::vector<SudokuSolveOptions> result{ SudokuSolveOptions{ SudokuEngine::Propagation, 0 },
+                                                SudokuSolveOptions{ SudokuEngine::Sat, 0 },
+                                                SudokuSolveOptions{ SudokuEngine::Propagation, 0x9E3779B97F4A7C15 },
+                                                SudokuSolveOptions{ SudokuEngine::Sat, 0x9E3779B97F4A7C15 } };
+        std::size_t const threads{ std::thread::hardware_concurrency() };
+        if (threads >= 2 && threads < result.size())
+            result.resize(threads);
+        else if (threads < 2)
+            result.resize(2);
+        return result;
+    }
+
+private:
+    // Data Members
+    //============================================================
+    std::vector<SudokuSolveOptions> m_entries;
+    SudokuPortfolioStatistics m_statistics;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUPORTFOLIOSOLVER_H
@@ -0,0 +1,146 @@
+#include "sudokupuzzletext.h"
+
+#include <array>
+
+namespace
+{
+    // Symbol table
+    //============================================================
+    char const c_symbols[]{ "123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz@%$" };
+    std::uint8_t const c_invalid{ 0xFF };
+    char const c_comment{ '#' };
+
+    bool isWhitespace(char character)
+    {
+        return character == ' ' || character == '\t' || character == '\r';
+    }
+
+    // Value of each character, c_invalid for characters that aren't tiles
+    std::array<std::uint8_t, 256> makeValueTable()
+    {
+        std::array<std::uint8_t, 256> result{};
+        result.fill(c_invalid);
+        result['.'] = 0;
+        result['0'] = 0;
+        for (std::size_t index = 0; index != 64; ++index)
+            result[static_cast<unsigned char>(c_symbols[index])] = static_cast<std::uint8_t>(index + 1);
+        return result;
+    }
+
+    std::array<std::uint8_t, 256> const& valueTable()
+    {
+        static std::array<std::uint8_t, 256> const s_table{ makeValueTable() };
+        return s_table;
+    }
+}
+
+// Interface
+//============================================================
+char const* puzzles::SudokuPuzzleText::symbols()
+{
+    return c_symbols;
+}
+
+std::size_t puzzles::SudokuPuzzleText::boxSizeForTileCount(std::size_t tileCount)
+{
+    for (std::size_t boxSize = 2; boxSize <= 8; ++boxSize)
+    {
+        if (boxSize * boxSize * boxSize * boxSize == tileCount)
+            return boxSize;
+    }
+    return 0;
+}
+
+bool puzzles::SudokuPuzzleText::findPuzzle(char const* line, std::size_t lineLength, std::size_t& first, std::size_t& length)
+{
+    first = 0;
+    while (first != lineLength && isWhitespace(line[first]))
+        ++first;
+    std::size_t last{ lineLength };
+    while (last != first && isWhitespace(line[last - 1]))
+        --last;
+    length = last - first;
+    return length != 0 && line[first] != c_comment;
+}
+
+bool puzzles::SudokuPuzzleText::parse(std::string const& text, std::vector<std::uint8_t>& values, std::size_t& boxSize)
+{
+    return parse(text.data(), text.size(), values, boxSize);
+}
+
+bool puzzles::SudokuPuzzleText::parse(char const* text, std::size_t length, std::vector<std::uint8_t>& values, std::size_t& boxSize)
+{
+    values.clear();
+    bool listed{ false };
+    for (std::size_t index = 0; index != length && !listed; ++index)
+        listed = text[index] == ',';
+
+    if (!listed)
+    {
+        boxSize = boxSizeForTileCount(length);
+        if (boxSize == 0)
+            return false;
+        std::size_t const maxValue{ boxSize * boxSize };
+        values.resize(length);
+        for (std::size_t index = 0; index != length; ++index)
+        {
+            std::uint8_t const value{ valueTable()[static_cast<unsigned char>(text[index])] };
+            if (value == c_invalid || value > maxValue)
+                return false;
+            values[index] = value;
+        }
+        return true;
+    }
+
+    // Comma separated numbers, spaces allowed around them
+    std::size_t value{ 0 };
+    bool hasDigits{ false };
+    for (std::size_t index = 0; index <= length; ++index)
+    {
+        char const character{ index == length ? ',' : text[index] };
+        if (character >= '0' && character <= '9')
+        {
+            value = value * 10 + static_cast<std::size_t>(character - '0');
+            hasDigits = true;
+            if (value > 64)
+                return false;
+        }
+        else if (character == ',')
+        {
+            if (!hasDigits)
+                return false;
+            values.push_back(static_cast<std::uint8_t>(value));
+            value = 0;
+            hasDigits = false;
+        }
+        else if (character != ' ')
+        {
+            return false;
+        }
+    }
+
+    boxSize = boxSizeForTileCount(values.size());
+    if (boxSize == 0)
+        return false;
+    for (auto tileValue : values)
+    {
+        if (tileValue > boxSize * boxSize)
+            return false;
+    }
+    return true;
+}
+
+void puzzles::SudokuPuzzleText::append(std::uint8_t const* values, std::size_t boxSize, std::string& text)
+{
+    std::size_t const tileCount{ boxSize * boxSize * boxSize * boxSize };
+    for (std::size_t index = 0; index != tileCount; ++index)
+        text.push_back(values[index] == 0 ? '.' : c_symbols[values[index] - 1]);
+}
+
+std::string puzzles::SudokuPuzzleText::format(std::uint8_t const* values, std::size_t boxSize)
+{
+    std::string result{};
+    result.reserve(boxSize * boxSize * boxSize * boxSize);
+    append(values, boxSize, result);
+    return result;
+}
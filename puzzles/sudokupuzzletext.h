@@ -0,0 +1,52 @@
+#ifndef SUDOKUPUZZLETEXT_H
+#define SUDOKUPUZZLETEXT_H
+/*
+class SudokuPuzzleText
+====================================================================================================
+Reading and writing puzzles as single lines of text, for the command line modes and anything else
+that moves puzzles around as text. Values are bytes, one per tile in row-major order, 0 for empty.
+
+Two forms are read:
+- compact: one character per tile, N^4 characters in all, which also gives the box size. Empty
+  tiles are '.' or '0', values 1 to 64 are the characters of symbols() in order, so a 9x9 puzzle is
+  the usual 81 digits and a 16x16 one uses 1-9 then A-G. The last three, for 62 to 64, are '@',
+  '%' and '$'; '#' is never a tile, so it can start a comment.
+- listed: the values as decimal numbers separated by commas, N^4 of them.
+Puzzles are always written compact, with '.' for empty tiles.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace puzzles
+{
+
+class SudokuPuzzleText
+{
+public:
+    // Interface
+    //============================================================
+    // The characters for values 1 to 64
+    static char const* symbols();
+
+    // The box size a puzzle of this many tiles has, or 0 if there isn't one from 2 to 8
+    static std::size_t boxSizeForTileCount(std::size_t tileCount);
+
+    // Find the puzzle on a line of input, setting first and length to the line without the
+    // whitespace around it. Returns false for blank lines and comments, which start with '#'.
+    static bool findPuzzle(char const* line, std::size_t lineLength, std::size_t& first, std::size_t& length);
+
+    // Read a puzzle, replacing values and setting boxSize. Returns false, leaving them in an
+    // unspecified state, if the text isn't a puzzle.
+    static bool parse(std::string const& text, std::vector<std::uint8_t>& values, std::size_t& boxSize);
+    static bool parse(char const* text, std::size_t length, std::vector<std::uint8_t>& values, std::size_t& boxSize);
+
+    // Append the compact form of these N^4 values to text
+    static void append(std::uint8_t const* values, std::size_t boxSize, std::string& text);
+    static std::string format(std::uint8_t const* values, std::size_t boxSize);
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUPUZZLETEXT_H
@@ -0,0 +1,158 @@
+#ifndef SUDOKURINGBUFFER_H
+#define SUDOKURINGBUFFER_H
+/*
+class SudokuRingBuffer<T>
+====================================================================================================
+A bounded lock-free queue of small copyable values (pointers, in the batch pipeline), for handing
+work between threads without a mutex. The capacity is fixed up front and rounded up to a power of
+two. Each slot carries a sequence number saying whether it is ready to be written or read for the
+current lap of the ring, so a producer or consumer claims a slot with one compare-exchange on the
+shared position and then only touches that slot. That makes it safe with any number of producers
+and consumers; the pipeline uses it one reader to many solvers and many solvers to one writer.
+
+tryPush() and tryPop() fail straight away when the ring is full or empty. push() and pop() spin for
+a while, then yield, then sleep in short steps until they succeed, and return how many times they had to wait, which is how
+the pipeline measures backpressure.
+*/
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+namespace puzzles
+{
+
+template <typename T>
+class SudokuRingBuffer
+{
+public:
+    // Special 6
+    //============================================================
+    explicit SudokuRingBuffer(std::size_t capacity) :
+        m_slots(),
+        m_mask(),
+        m_pushPosition(0),
+        m_popPosition(0)
+    {
+        std::size_t size{ 2 };
+        while (size < capacity)
+            size *= 2;
+        m_slots.reset(new Slot[size]);
+        m_mask = size - 1;
+        for (std::size_t index = 0; index != size; ++index)
+            m_slots[index].sequence.store(index, std::memory_order_relaxed);
+    }
+
+    // No copying
+    SudokuRingBuffer(SudokuRingBuffer const& other) = delete;
+    SudokuRingBuffer& operator=(SudokuRingBuffer const& other) = delete;
+
+    // Interface
+    //============================================================
+    std::size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    bool tryPush(T const& value)
+    {
+        std::size_t position{ m_pushPosition.load(std::memory_order_relaxed) };
+        while (true)
+        {
+            Slot& slot{ m_slots[position & m_mask] };
+            std::size_t const sequence{ slot.sequence.load(std::memory_order_acquire) };
+            // The slot is free for this lap; claim it
+            if (sequence == position)
+            {
+                if (m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            // Still holding last lap's value: full
+            else if (sequence < position)
+                return false;
+            // Another producer got here first
+            else
+                position = m_pushPosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPop(T& value)
+    {
+        std::size_t position{ m_popPosition.load(std::memory_order_relaxed) };
+        while (true)
+        {
+            Slot& slot{ m_slots[position & m_mask] };
+            std::size_t const sequence{ slot.sequence.load(std::memory_order_acquire) };
+            // Written this lap; claim it
+            if (sequence == position + 1)
+            {
+                if (m_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    value = slot.value;
+                    slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            // Not written yet: empty
+            else if (sequence < position + 1)
+                return false;
+            // Another consumer got here first
+            else
+                position = m_popPosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t push(T const& value)
+    {
+        std::size_t waits{ 0 };
+        while (!tryPush(value))
+            pause(waits++);
+        return waits;
+    }
+
+    std::size_t pop(T& value)
+    {
+        std::size_t waits{ 0 };
+        while (!tryPop(value))
+            pause(waits++);
+        return waits;
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    // Helpers
+    //============================================================
+    // Spin briefly, since the other side is usually about to move, then give up the core, then
+    // sleep so a stage waiting on a long solve doesn't hold a core of its own
+    static void pause(std::size_t waits)
+    {
+        if (waits >= 1024)
+            std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+        else if (waits >= 64)
+            std::this_thread::yield();
+    }
+
+    // Data Members
+    //============================================================
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_mask;
+    // Kept on separate cache lines so producers and consumers don't contend
+    alignas(64) std::atomic<std::size_t> m_pushPosition;
+    alignas(64) std::atomic<std::size_t> m_popPosition;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKURINGBUFFER_H
@@ -0,0 +1,89 @@
+#include "sudokuruntimesolver.h"
+
+#include "sudokuboard.h"
+#include "sudokusolutioncache.h"
+
+namespace
+{
+    template <std::size_t N>
+    puzzles::SudokuRuntimeReport solveBoxSize(std::uint8_t const* puzzleValues, std::uint8_t* solutionValues,
+                                              puzzles::SudokuSolveOptions const& options,
+                                              puzzles::SudokuCancellationToken::clock_type::time_point deadline,
+                                              puzzles::SudokuCancellationToken const& cancellation,
+                                              bool useCache)
+    {
+        puzzles::SudokuBoard<N> puzzle{};
+        for (std::size_t index = 0; index != N*N*N*N; ++index)
+        {
+            if (puzzleValues[index] != 0)
+                puzzle.setTileSolution(index / (N*N), index % (N*N), puzzleValues[index]);
+        }
+
+        puzzles::SudokuSolveReport<N> const report{ useCache
+            ? puzzles::SudokuSolutionCache<N>::shared().solveWithin(puzzle, options, deadline, cancellation)
+            : puzzles::SudokuSolver<N>{ options }.solveWithin(puzzle, deadline, cancellation) };
+
+        for (std::size_t index = 0; index != N*N*N*N; ++index)
+            solutionValues[index] = static_cast<std::uint8_t>(report.board.getTileSolution(index / (N*N), index % (N*N)));
+
+        return puzzles::SudokuRuntimeReport{ report.status, report.engine, report.cached,
+                                             report.searchStatistics, report.satStatistics, report.localSearchStatistics,
+                                             report.time };
+    }
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuRuntimeSolver::SudokuRuntimeSolver() :
+    m_cacheLimit{ 3 }
+{}
+
+// Interface
+//============================================================
+bool puzzles::SudokuRuntimeSolver::isSupportedBoxSize(std::size_t boxSize)
+{
+    return boxSize >= minBoxSize() && boxSize <= maxBoxSize();
+}
+
+puzzles::SudokuRuntimeReport puzzles::SudokuRuntimeSolver::solve(std::size_t boxSize, std::uint8_t const* puzzle, std::uint8_t* solution,
+                                                                SudokuSolveOptions const& options,
+                                                                SudokuCancellationToken::clock_type::time_point deadline,
+                                                                SudokuCancellationToken const& cancellation) const
+{
+    bool const useCache{ boxSize <= m_cacheLimit };
+    switch (boxSize)
+    {
+    case 2: return solveBoxSize<2>(puzzle, solution, options, deadline, cancellation, useCache);
+    case 3: return solveBoxSize<3>(puzzle, solution, options, deadline, cancellation, useCache);
+    case 4: return solveBoxSize<4>(puzzle, solution, options, deadline, cancellation, useCache);
+    case 5: return solveBoxSize<5>(puzzle, solution, options, deadline, cancellation, useCache);
+    case 6: return solveBoxSize<6>(puzzle, solution, options, deadline, cancellation, useCache);
+    case 7: return solveBoxSize<7>(puzzle, solution, options, deadline, cancellation, useCache);
+    case 8: return solveBoxSize<8>(puzzle, solution, options, deadline, cancellation, useCache);
+    default:
+        return SudokuRuntimeReport{ SudokuSolveStatus::Unsolvable, options.engine, false,
+                                    SudokuSearchStatistics{}, SudokuSatStatistics{}, SudokuLocalSearchStatistics{},
+                                    std::chrono::nanoseconds{ 0 } };
+    }
+}
+
+std::size_t puzzles::SudokuRuntimeSolver::cacheLimit() const
+{
+    return m_cacheLimit;
+}
+
+void puzzles::SudokuRuntimeSolver::setCacheLimit(std::size_t boxSize)
+{
+    m_cacheLimit = boxSize;
+}
+
+void puzzles::SudokuRuntimeSolver::attachStore(SudokuSolutionStore* store)
+{
+    SudokuSolutionCache<2>::shared().attachStore(store);
+    SudokuSolutionCache<3>::shared().attachStore(store);
+    SudokuSolutionCache<4>::shared().attachStore(store);
+    SudokuSolutionCache<5>::shared().attachStore(store);
+    SudokuSolutionCache<6>::shared().attachStore(store);
+    SudokuSolutionCache<7>::shared().attachStore(store);
+    SudokuSolutionCache<8>::shared().attachStore(store);
+}
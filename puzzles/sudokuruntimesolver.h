@@ -0,0 +1,84 @@
+#ifndef SUDOKURUNTIMESOLVER_H
+#define SUDOKURUNTIMESOLVER_H
+/*
+struct SudokuRuntimeReport
+====================================================================================================
+SudokuSolveReport<N> without the board, for solves whose box size is only known at runtime.
+
+class SudokuRuntimeSolver
+====================================================================================================
+Solves puzzles given as N^4 bytes (row-major, 0 for empty) where N is picked at runtime, by
+dispatching to SudokuSolver<N> for box sizes 2 to 8. Everything that reads puzzles from outside -
+the command line modes, the server - goes through here so they all use the same SudokuBoard<N>
+core as the dialog.
+
+Puzzles up to the cache limit go through SudokuSolutionCache<N>::shared(), so repeated puzzles and
+their symmetric variants are answered straight away. Canonicalising costs more than solving for
+larger boards, so by default only 9x9 and smaller are cached. attachStore() gives the shared
+caches of every box size a SudokuSolutionStore to load from and add to.
+*/
+#include "sudokucancellation.h"
+#include "sudokulocalsearch.h"
+#include "sudokusatsolver.h"
+#include "sudokusearchstatistics.h"
+#include "sudokusolver.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace puzzles
+{
+// Forward Declarations
+class SudokuSolutionStore;
+
+struct SudokuRuntimeReport
+{
+    SudokuSolveStatus status;
+    SudokuEngine engine;
+    bool cached;
+    SudokuSearchStatistics searchStatistics;
+    SudokuSatStatistics satStatistics;
+    SudokuLocalSearchStatistics localSearchStatistics;
+    std::chrono::nanoseconds time;
+};
+
+class SudokuRuntimeSolver
+{
+public:
+    // Special 6
+    //============================================================
+    SudokuRuntimeSolver();
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    static std::size_t minBoxSize() { return 2; }
+    static std::size_t maxBoxSize() { return 8; }
+    static bool isSupportedBoxSize(std::size_t boxSize);
+
+    // Solve the boxSize^4 values in puzzle, writing the board as far as the solve got to solution.
+    // The two may be the same buffer. An unsupported box size is reported as Unsolvable and
+    // leaves solution alone.
+    SudokuRuntimeReport solve(std::size_t boxSize, std::uint8_t const* puzzle, std::uint8_t* solution,
+                              SudokuSolveOptions const& options,
+                              SudokuCancellationToken::clock_type::time_point deadline,
+                              SudokuCancellationToken const& cancellation) const;
+
+    // Puzzles with a box size up to this go through the shared cache; 0 turns it off
+    std::size_t cacheLimit() const;
+    void setCacheLimit(std::size_t boxSize);
+
+    // Attach the store to the shared cache of every supported box size, or detach it with nullptr.
+    // The store must stay open until it is detached.
+    static void attachStore(SudokuSolutionStore* store);
+
+private:
+    // Data Members
+    //============================================================
+    std::size_t m_cacheLimit;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKURUNTIMESOLVER_H
@@ -0,0 +1,229 @@
+#ifndef SUDOKUSATENGINE_H
+#define SUDOKUSATENGINE_H
+/*
+class SudokuSatEngine<N>
+====================================================================================================
+Solves a SudokuBoard<N> by handing it to SudokuSatSolver. The board is propagated first, then there
+is one variable per remaining candidate of each unsolved tile and the clauses say:
+- every tile is at least one of its candidates, and at most one
+- every digit still missing from a unit (a row, column or square, or whatever the board's
+  SudokuUnitTable<N> has) goes in at least one of the tiles there that can hold it, and at most one
+"At most one" over a few literals is written as every pair, and over more as a sequential counter
+so a 64 tile unit costs about 3 * 64 clauses instead of 2016. The model is read back through
+setTileSolution().
+
+Propagation and backtracking is quick while guesses are rare, but on 25x25 and larger boards the
+search tree gets wide and deep; clause learning cuts it down by never making the same mistake twice.
+*/
+#include "sudokuboard.h"
+#include "sudokusatsolver.h"
+#include <cstdint>
+#include <vector>
+
+namespace puzzles
+{
+
+template <std::size_t N>
+class SudokuSatEngine
+{
+public:
+    // Special 6
+    //============================================================
+    SudokuSatEngine() :
+        m_variables(),
+        m_phaseHints(),
+        m_seed{ 0 },
+        m_statistics{}
+    {}
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // Solve the board. Returns true if it ends up solved; if there is no solution the board is
+    // left as propagation left it.
+    bool solve(SudokuBoard<N>& board)
+    {
+        return run(board, nullptr);
+    }
+    // Stopping early if the token is cancelled
+    bool solve(SudokuBoard<N>& board, SudokuCancellationToken const& cancellation)
+    {
+        return run(board, &cancellation);
+    }
+
+    // Passed on to SudokuSatSolver::setSeed()
+    void setSeed(std::uint64_t seed)
+    {
+        m_seed = seed;
+    }
+    // A value per tile, tile x * N*N + y, to try first for that tile; 0 for no preference. For
+    // starting the search near a nearly right filling, such as SudokuLocalSearch<N>'s best one.
+    // Only used with a seed of 0.
+    void setPhaseHints(std::vector<std::uint8_t> const& values)
+    {
+        m_phaseHints = values;
+    }
+
+    // Counters from the last solve()
+    SudokuSatStatistics const& statistics() const
+    {
+        return m_statistics;
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    using Literal = SudokuSatSolver::Literal;
+    using mask_type = typename SudokuBoard<N>::mask_type;
+
+    // Helpers
+    //============================================================
+    bool run(SudokuBoard<N>& board, SudokuCancellationToken const* cancellation)
+    {
+        m_statistics = SudokuSatStatistics{};
+        if (!(cancellation ? board.propagateAll(*cancellation) : board.propagateAll()))
+            return false;
+        if (board.isSolved())
+            return true;
+
+        SudokuSatSolver solver{};
+        solver.setCancellationToken(cancellation);
+        solver.setSeed(m_seed);
+        if (!encode(board, solver))
+        {
+            m_statistics = solver.statistics();
+            return false;
+        }
+        for (std::size_t tile = 0; tile != m_phaseHints.size() && tile != N*N*N*N; ++tile)
+        {
+            std::size_t const value{ m_phaseHints[tile] };
+            std::size_t const variable{ value != 0 && value <= N*N ? m_variables[tile * N*N + (value - 1)] : noVariable() };
+            if (variable != noVariable())
+                solver.setPhase(variable, true);
+        }
+        if (solver.solve() != SudokuSatSolver::Result::Satisfiable)
+        {
+            m_statistics = solver.statistics();
+            return false;
+        }
+        m_statistics = solver.statistics();
+
+        // Read the model back onto the board
+        for (std::size_t xPosition = 0; xPosition != N*N; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != N*N; ++yPosition)
+            {
+                for (std::size_t value = 1; value <= N*N; ++value)
+                {
+                    std::size_t const variable{ m_variables[variableIndex(xPosition, yPosition, value)] };
+                    if (variable != noVariable() && solver.modelValue(variable))
+                    {
+                        board.setTileSolution(xPosition, yPosition, value);
+                        break;
+                    }
+                }
+            }
+        }
+        return board.isSolved();
+    }
+
+    static std::size_t noVariable()       { return static_cast<std::size_t>(-1); }
+    static std::size_t pairwiseLimit()    { return 6; }
+
+    static std::size_t variableIndex(std::size_t xPosition, std::size_t yPosition, std::size_t value)
+    {
+        return (xPosition * N*N + yPosition) * N*N + (value - 1);
+    }
+
+    bool encode(SudokuBoard<N> const& board, SudokuSatSolver& solver)
+    {
+        m_variables.assign(N*N*N*N*N*N, noVariable());
+        std::vector<Literal> literals{};
+
+        // Tiles
+        for (std::size_t xPosition = 0; xPosition != N*N; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != N*N; ++yPosition)
+            {
+                if (board.getTileSolution(xPosition, yPosition) != 0)
+                    continue;
+                literals.clear();
+                for (mask_type remaining = board.getTileCandidates(xPosition, yPosition); remaining != 0; remaining &= remaining - 1)
+                {
+                    std::size_t const value{ lowestBitIndex(remaining) + 1 };
+                    std::size_t const variable{ solver.addVariable() };
+                    m_variables[variableIndex(xPosition, yPosition, value)] = variable;
+                    literals.push_back(SudokuSatSolver::positive(variable));
+                }
+                if (!exactlyOne(literals, solver))
+                    return false;
+            }
+        }
+
+        // Units
+        SudokuUnitTable<N> const& units = board.unitTable();
+        for (std::size_t unit = 0; unit != units.unitCount(); ++unit)
+        {
+            std::uint16_t const* const tiles = units.unitTiles(unit);
+            for (std::size_t value = 1; value <= N*N; ++value)
+            {
+                literals.clear();
+                bool placed{ false };
+                for (std::size_t index = 0; index != N*N && !placed; ++index)
+                {
+                    std::size_t const xPosition{ tiles[index] / (N*N) };
+                    std::size_t const yPosition{ tiles[index] % (N*N) };
+                    placed = board.getTileSolution(xPosition, yPosition) == value;
+                    std::size_t const variable{ m_variables[variableIndex(xPosition, yPosition, value)] };
+                    if (variable != noVariable())
+                        literals.push_back(SudokuSatSolver::positive(variable));
+                }
+                if (!placed && !exactlyOne(literals, solver))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Exactly one of these literals is true
+    static bool exactlyOne(std::vector<Literal> const& literals, SudokuSatSolver& solver)
+    {
+        if (!solver.addClause(literals))
+            return false;
+
+        if (literals.size() <= pairwiseLimit())
+        {
+            for (std::size_t first = 0; first != literals.size(); ++first)
+                for (std::size_t second = first + 1; second != literals.size(); ++second)
+                    if (!solver.addClause({ SudokuSatSolver::negate(literals[first]), SudokuSatSolver::negate(literals[second]) }))
+                        return false;
+            return true;
+        }
+
+        // Sequential counter: counter i is true once one of the first i + 1 literals is
+        std::size_t previous{ solver.addVariable(false) };
+        bool result{ solver.addClause({ SudokuSatSolver::negate(literals[0]), SudokuSatSolver::positive(previous) }) };
+        for (std::size_t index = 1; result && index + 1 != literals.size(); ++index)
+        {
+            std::size_t const counter{ solver.addVariable(false) };
+            Literal const literal{ literals[index] };
+            result = solver.addClause({ SudokuSatSolver::negate(literal), SudokuSatSolver::positive(counter) })
+                  && solver.addClause({ SudokuSatSolver::negative(previous), SudokuSatSolver::positive(counter) })
+                  && solver.addClause({ SudokuSatSolver::negate(literal), SudokuSatSolver::negative(previous) });
+            previous = counter;
+        }
+        return result && solver.addClause({ SudokuSatSolver::negate(literals.back()), SudokuSatSolver::negative(previous) });
+    }
+
+    // Data Members
+    //============================================================
+    std::vector<std::size_t> m_variables; // per tile and value, noVariable() if not a candidate
+    std::vector<std::uint8_t> m_phaseHints;
+    std::uint64_t m_seed;
+    SudokuSatStatistics m_statistics;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSATENGINE_H
@@ -0,0 +1,671 @@
+#include "sudokusatsolver.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Tuning constants
+    //============================================================
+    double const c_activityDecay{ 0.95 };
+    double const c_activityLimit{ 1e100 };
+    std::size_t const c_restartUnit{ 100 };         // conflicts per Luby step
+    std::size_t const c_firstReduce{ 2000 };        // learned clauses kept before the first reduce
+    std::size_t const c_reduceIncrement{ 300 };
+    std::uint32_t const c_keptLbd{ 2 };             // "glue" clauses are never thrown away
+    std::size_t const c_notInHeap{ static_cast<std::size_t>(-1) };
+
+    std::uint32_t const c_learnedFlag{ 0x80000000u };
+    std::uint32_t const c_deletedFlag{ 0x40000000u };
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuSatSolver::SudokuSatSolver() :
+    m_arena(),
+    m_learned(),
+    m_wastedWords{ 0 },
+    m_watches(),
+    m_values(),
+    m_levels(),
+    m_reasons(),
+    m_savedPhases(),
+    m_model(),
+    m_trail(),
+    m_trailLimits(),
+    m_propagateHead{ 0 },
+    m_activities(),
+    m_activityIncrement{ 1.0 },
+    m_heap(),
+    m_heapPositions(),
+    m_decisions(),
+    m_seen(),
+    m_analyseStack(),
+    m_analyseClear(),
+    m_levelStamps(),
+    m_levelStamp{ 0 },
+    m_unsatisfiable{ false },
+    m_cancellation{ nullptr },
+    m_seed{ 0 },
+    m_statistics{}
+{}
+
+// Interface
+//============================================================
+std::size_t puzzles::SudokuSatSolver::addVariable(bool isDecision)
+{
+    std::size_t const variable{ m_levels.size() };
+    m_watches.resize(m_watches.size() + 2);
+    m_values.push_back(c_unassigned);
+    m_values.push_back(c_unassigned);
+    m_levels.push_back(0);
+    m_reasons.push_back(noClause());
+    m_savedPhases.push_back(false);
+    m_model.push_back(false);
+    m_activities.push_back(0.0);
+    m_heapPositions.push_back(c_notInHeap);
+    m_decisions.push_back(isDecision);
+    m_seen.push_back(0);
+    if (isDecision)
+        heapInsert(variable);
+    return variable;
+}
+
+std::size_t puzzles::SudokuSatSolver::variableCount() const
+{
+    return m_levels.size();
+}
+
+bool puzzles::SudokuSatSolver::addClause(std::vector<Literal> literals)
+{
+    if (m_unsatisfiable)
+        return false;
+
+    // Clauses are only added at the top level, so drop false literals and skip clauses that are
+    // already satisfied or contain a literal and its negation.
+    std::sort(literals.begin(), literals.end());
+    std::vector<Literal> kept{};
+    for (std::size_t index = 0; index != literals.size(); ++index)
+    {
+        Literal const literal{ literals[index] };
+        if (literalValue(literal) == c_true || (index != 0 && literals[index - 1] == negate(literal)))
+            return true;
+        if (literalValue(literal) == c_false || (index != 0 && literals[index - 1] == literal))
+            continue;
+        kept.push_back(literal);
+    }
+
+    if (kept.empty())
+    {
+        m_unsatisfiable = true;
+        return false;
+    }
+    if (kept.size() == 1)
+    {
+        assign(kept.front(), noClause());
+        if (propagate() != noClause())
+            m_unsatisfiable = true;
+        return !m_unsatisfiable;
+    }
+    watchClause(storeClause(kept, false, 0));
+    return true;
+}
+
+puzzles::SudokuSatSolver::Result puzzles::SudokuSatSolver::solve()
+{
+    m_statistics = SudokuSatStatistics{};
+    if (m_unsatisfiable || propagate() != noClause())
+    {
+        m_unsatisfiable = true;
+        return Result::Unsatisfiable;
+    }
+
+    if (m_seed != 0)
+        randomiseBranching();
+
+    std::vector<Literal> learned{};
+    std::size_t nextReduce{ c_firstReduce };
+    std::size_t restartIndex{ 0 };
+    std::size_t restartLimit{ luby(restartIndex) * c_restartUnit };
+    std::size_t conflictsSinceRestart{ 0 };
+
+    while (true)
+    {
+        if (m_cancellation != nullptr && m_cancellation->shouldStop())
+        {
+            backtrack(0);
+            return Result::Cancelled;
+        }
+
+        ClauseReference const conflict{ propagate() };
+        if (conflict != noClause())
+        {
+            ++m_statistics.conflicts;
+            ++conflictsSinceRestart;
+            if (decisionLevel() == 0)
+            {
+                m_unsatisfiable = true;
+                return Result::Unsatisfiable;
+            }
+
+            std::uint32_t lbd{ 0 };
+            std::size_t const level{ analyse(conflict, learned, lbd) };
+            backtrack(level);
+            if (learned.size() == 1)
+            {
+                assign(learned.front(), noClause());
+            }
+            else
+            {
+                ClauseReference const clause{ storeClause(learned, true, lbd) };
+                watchClause(clause);
+                m_learned.push_back(clause);
+                assign(learned.front(), clause);
+            }
+            ++m_statistics.learnedClauses;
+            decayActivities();
+            continue;
+        }
+
+        if (conflictsSinceRestart >= restartLimit)
+        {
+            ++m_statistics.restarts;
+            conflictsSinceRestart = 0;
+            restartLimit = luby(++restartIndex) * c_restartUnit;
+            backtrack(0);
+            if (m_learned.size() >= nextReduce)
+            {
+                reduceLearned();
+                nextReduce += c_reduceIncrement;
+            }
+            continue;
+        }
+
+        Literal const decision{ pickBranchLiteral() };
+        if (decision == noClause())
+        {
+            // Everything is assigned without a conflict
+            for (std::size_t variable = 0; variable != variableCount(); ++variable)
+                m_model[variable] = literalValue(positive(variable)) == c_true;
+            backtrack(0);
+            return Result::Satisfiable;
+        }
+        ++m_statistics.decisions;
+        newDecisionLevel();
+        assign(decision, noClause());
+    }
+}
+
+void puzzles::SudokuSatSolver::setCancellationToken(SudokuCancellationToken const* cancellation)
+{
+    m_cancellation = cancellation;
+}
+
+void puzzles::SudokuSatSolver::setSeed(std::uint64_t seed)
+{
+    m_seed = seed;
+}
+
+void puzzles::SudokuSatSolver::setPhase(std::size_t variable, bool value)
+{
+    m_savedPhases[variable] = value;
+}
+
+bool puzzles::SudokuSatSolver::modelValue(std::size_t variable) const
+{
+    return m_model[variable];
+}
+
+puzzles::SudokuSatStatistics const& puzzles::SudokuSatSolver::statistics() const
+{
+    return m_statistics;
+}
+
+// Helpers
+//============================================================
+puzzles::SudokuSatSolver::ClauseReference puzzles::SudokuSatSolver::storeClause(std::vector<Literal> const& literals, bool learned, std::uint32_t lbd)
+{
+    ClauseReference const clause{ static_cast<ClauseReference>(m_arena.size()) };
+    m_arena.push_back(static_cast<std::uint32_t>(literals.size()));
+    m_arena.push_back((learned ? c_learnedFlag : 0) | std::min<std::uint32_t>(lbd, 0x3FFFFFFFu));
+    m_arena.insert(m_arena.end(), literals.cbegin(), literals.cend());
+    return clause;
+}
+
+void puzzles::SudokuSatSolver::watchClause(ClauseReference clause)
+{
+    Literal const* literals{ clauseLiterals(clause) };
+    m_watches[negate(literals[0])].push_back(Watcher{ clause, literals[1] });
+    m_watches[negate(literals[1])].push_back(Watcher{ clause, literals[0] });
+}
+
+std::uint8_t puzzles::SudokuSatSolver::literalValue(Literal literal) const
+{
+    return m_values[literal];
+}
+
+std::size_t puzzles::SudokuSatSolver::decisionLevel() const
+{
+    return m_trailLimits.size();
+}
+
+void puzzles::SudokuSatSolver::assign(Literal literal, ClauseReference reason)
+{
+    std::size_t const variable{ variableOf(literal) };
+    m_values[literal] = c_true;
+    m_values[negate(literal)] = c_false;
+    m_levels[variable] = decisionLevel();
+    m_reasons[variable] = reason;
+    m_trail.push_back(literal);
+}
+
+void puzzles::SudokuSatSolver::newDecisionLevel()
+{
+    m_trailLimits.push_back(m_trail.size());
+}
+
+void puzzles::SudokuSatSolver::backtrack(std::size_t level)
+{
+    if (decisionLevel() <= level)
+        return;
+
+    std::size_t const limit{ m_trailLimits[level] };
+    for (std::size_t index = m_trail.size(); index-- != limit;)
+    {
+        Literal const literal{ m_trail[index] };
+        std::size_t const variable{ variableOf(literal) };
+        m_values[literal] = c_unassigned;
+        m_values[negate(literal)] = c_unassigned;
+        m_savedPhases[variable] = (literal & 1) == 0;
+        if (m_heapPositions[variable] == c_notInHeap && m_decisions[variable])
+            heapInsert(variable);
+    }
+    m_trail.resize(limit);
+    m_trailLimits.resize(level);
+    m_propagateHead = limit;
+}
+
+// Watches for a literal hold the clauses that contain its negation, so they are visited when
+// it becomes true.
+puzzles::SudokuSatSolver::ClauseReference puzzles::SudokuSatSolver::propagate()
+{
+    while (m_propagateHead != m_trail.size())
+    {
+        Literal const assigned{ m_trail[m_propagateHead++] };
+        Literal const falseLiteral{ negate(assigned) };
+        std::vector<Watcher>& watches{ m_watches[assigned] };
+        ++m_statistics.propagations;
+
+        std::size_t read{ 0 };
+        std::size_t write{ 0 };
+        std::size_t const end{ watches.size() };
+        while (read != end)
+        {
+            Watcher const watcher{ watches[read++] };
+            if (literalValue(watcher.blocker) == c_true)
+            {
+                watches[write++] = watcher;
+                continue;
+            }
+            if (clauseDeleted(watcher.clause))
+                continue;
+
+            // Keep the false literal in the second slot
+            Literal* literals{ clauseLiterals(watcher.clause) };
+            if (literals[0] == falseLiteral)
+                std::swap(literals[0], literals[1]);
+
+            Literal const first{ literals[0] };
+            if (first != watcher.blocker && literalValue(first) == c_true)
+            {
+                watches[write++] = Watcher{ watcher.clause, first };
+                continue;
+            }
+
+            // Look for another literal to watch
+            std::uint32_t const size{ clauseSize(watcher.clause) };
+            bool moved{ false };
+            for (std::uint32_t index = 2; index != size; ++index)
+            {
+                if (literalValue(literals[index]) != c_false)
+                {
+                    std::swap(literals[1], literals[index]);
+                    m_watches[negate(literals[1])].push_back(Watcher{ watcher.clause, first });
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved)
+                continue;
+
+            // The clause is unit or conflicting
+            watches[write++] = Watcher{ watcher.clause, first };
+            if (literalValue(first) == c_false)
+            {
+                while (read != end)
+                    watches[write++] = watches[read++];
+                watches.resize(write);
+                m_propagateHead = m_trail.size();
+                return watcher.clause;
+            }
+            assign(first, watcher.clause);
+        }
+        watches.resize(write);
+    }
+    return noClause();
+}
+
+// Walk back along the trail from the conflict until only one literal from the current level is
+// left, giving a clause with that literal first and the literal with the next highest level second.
+std::size_t puzzles::SudokuSatSolver::analyse(ClauseReference conflict, std::vector<Literal>& learned, std::uint32_t& lbd)
+{
+    learned.clear();
+    learned.push_back(0); // room for the asserting literal
+
+    std::size_t pathCount{ 0 };
+    bool isConflict{ true };
+    Literal asserting{ 0 };
+    std::size_t trailIndex{ m_trail.size() };
+    ClauseReference reason{ conflict };
+
+    do
+    {
+        Literal const* literals{ clauseLiterals(reason) };
+        std::uint32_t const size{ clauseSize(reason) };
+        for (std::uint32_t index = (isConflict ? 0 : 1); index != size; ++index)
+        {
+            Literal const literal{ literals[index] };
+            std::size_t const variable{ variableOf(literal) };
+            if (m_seen[variable] != 0 || m_levels[variable] == 0)
+                continue;
+
+            m_seen[variable] = 1;
+            bumpVariable(variable);
+            if (m_levels[variable] == decisionLevel())
+                ++pathCount;
+            else
+                learned.push_back(literal);
+        }
+
+        // Next seen literal on the trail
+        while (m_seen[variableOf(m_trail[--trailIndex])] == 0) {}
+        asserting = m_trail[trailIndex];
+        isConflict = false;
+        reason = m_reasons[variableOf(asserting)];
+        m_seen[variableOf(asserting)] = 0;
+        --pathCount;
+    }
+    while (pathCount != 0);
+    learned[0] = negate(asserting);
+
+    // Drop literals implied by the rest of the clause. The levels in the clause are summarised as
+    // a bit per level (mod 32) so a reason chain that leaves them is abandoned quickly.
+    m_analyseClear.assign(learned.cbegin(), learned.cend());
+    std::uint32_t levels{ 0 };
+    for (std::size_t index = 1; index != learned.size(); ++index)
+        levels |= levelBit(variableOf(learned[index]));
+    std::size_t kept{ 1 };
+    for (std::size_t index = 1; index != learned.size(); ++index)
+    {
+        if (m_reasons[variableOf(learned[index])] == noClause() || !literalRedundant(learned[index], levels))
+            learned[kept++] = learned[index];
+    }
+    learned.resize(kept);
+    for (Literal literal : m_analyseClear)
+        m_seen[variableOf(literal)] = 0;
+
+    // Put the literal with the highest remaining level second, that is where we go back to
+    std::size_t level{ 0 };
+    if (learned.size() > 1)
+    {
+        std::size_t highest{ 1 };
+        for (std::size_t index = 2; index != learned.size(); ++index)
+        {
+            if (m_levels[variableOf(learned[index])] > m_levels[variableOf(learned[highest])])
+                highest = index;
+        }
+        std::swap(learned[1], learned[highest]);
+        level = m_levels[variableOf(learned[1])];
+    }
+
+    // Literal block distance: how many decision levels the clause spans
+    if (m_levelStamps.size() <= decisionLevel())
+        m_levelStamps.resize(decisionLevel() + 1, 0);
+    ++m_levelStamp;
+    lbd = 0;
+    for (Literal literal : learned)
+    {
+        std::size_t const literalLevel{ m_levels[variableOf(literal)] };
+        if (m_levelStamps[literalLevel] != m_levelStamp)
+        {
+            m_levelStamps[literalLevel] = m_levelStamp;
+            ++lbd;
+        }
+    }
+    return level;
+}
+
+// A literal is redundant if following reasons back from it only ever reaches literals already in the
+// clause (or at the top level). Literals shown to be implied are marked seen, so later checks can
+// stop at them too.
+bool puzzles::SudokuSatSolver::literalRedundant(Literal literal, std::uint32_t levels)
+{
+    m_analyseStack.clear();
+    m_analyseStack.push_back(literal);
+    std::size_t const clearTop{ m_analyseClear.size() };
+    while (!m_analyseStack.empty())
+    {
+        ClauseReference const reason{ m_reasons[variableOf(m_analyseStack.back())] };
+        m_analyseStack.pop_back();
+
+        Literal const* literals{ clauseLiterals(reason) };
+        std::uint32_t const size{ clauseSize(reason) };
+        for (std::uint32_t index = 1; index != size; ++index)
+        {
+            Literal const next{ literals[index] };
+            std::size_t const variable{ variableOf(next) };
+            if (m_seen[variable] != 0 || m_levels[variable] == 0)
+                continue;
+
+            if (m_reasons[variable] == noClause() || (levelBit(variable) & levels) == 0)
+            {
+                // a decision, or a level not in the clause: undo what this check marked
+                for (std::size_t cleared = clearTop; cleared != m_analyseClear.size(); ++cleared)
+                    m_seen[variableOf(m_analyseClear[cleared])] = 0;
+                m_analyseClear.resize(clearTop);
+                return false;
+            }
+            m_seen[variable] = 1;
+            m_analyseStack.push_back(next);
+            m_analyseClear.push_back(next);
+        }
+    }
+    return true;
+}
+
+std::uint32_t puzzles::SudokuSatSolver::levelBit(std::size_t variable) const
+{
+    return std::uint32_t{ 1 } << (m_levels[variable] & 31);
+}
+
+puzzles::SudokuSatSolver::Literal puzzles::SudokuSatSolver::pickBranchLiteral()
+{
+    while (!m_heap.empty())
+    {
+        std::size_t const variable{ heapPop() };
+        if (literalValue(positive(variable)) == c_unassigned)
+            return m_savedPhases[variable] ? positive(variable) : negative(variable);
+    }
+    return static_cast<Literal>(noClause());
+}
+
+void puzzles::SudokuSatSolver::bumpVariable(std::size_t variable)
+{
+    m_activities[variable] += m_activityIncrement;
+    if (m_activities[variable] > c_activityLimit)
+    {
+        for (auto& activity : m_activities)
+            activity /= c_activityLimit;
+        m_activityIncrement /= c_activityLimit;
+    }
+    if (m_heapPositions[variable] != c_notInHeap)
+        heapUp(m_heapPositions[variable]);
+}
+
+void puzzles::SudokuSatSolver::decayActivities()
+{
+    m_activityIncrement /= c_activityDecay;
+}
+
+bool puzzles::SudokuSatSolver::heapLess(std::size_t lhs, std::size_t rhs) const
+{
+    return m_activities[lhs] < m_activities[rhs];
+}
+
+void puzzles::SudokuSatSolver::heapInsert(std::size_t variable)
+{
+    m_heapPositions[variable] = m_heap.size();
+    m_heap.push_back(variable);
+    heapUp(m_heap.size() - 1);
+}
+
+std::size_t puzzles::SudokuSatSolver::heapPop()
+{
+    std::size_t const top{ m_heap.front() };
+    m_heapPositions[top] = c_notInHeap;
+    m_heap.front() = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty())
+    {
+        m_heapPositions[m_heap.front()] = 0;
+        heapDown(0);
+    }
+    return top;
+}
+
+void puzzles::SudokuSatSolver::heapUp(std::size_t position)
+{
+    std::size_t const variable{ m_heap[position] };
+    while (position != 0)
+    {
+        std::size_t const parent{ (position - 1) / 2 };
+        if (!heapLess(m_heap[parent], variable))
+            break;
+        m_heap[position] = m_heap[parent];
+        m_heapPositions[m_heap[position]] = position;
+        position = parent;
+    }
+    m_heap[position] = variable;
+    m_heapPositions[variable] = position;
+}
+
+void puzzles::SudokuSatSolver::heapDown(std::size_t position)
+{
+    std::size_t const variable{ m_heap[position] };
+    while (true)
+    {
+        std::size_t child{ position * 2 + 1 };
+        if (child >= m_heap.size())
+            break;
+        if (child + 1 < m_heap.size() && heapLess(m_heap[child], m_heap[child + 1]))
+            ++child;
+        if (!heapLess(variable, m_heap[child]))
+            break;
+        m_heap[position] = m_heap[child];
+        m_heapPositions[m_heap[position]] = position;
+        position = child;
+    }
+    m_heap[position] = variable;
+    m_heapPositions[variable] = position;
+}
+
+// Throw away the worse half of the learned clauses, judged by literal block distance. Only called
+// at the top level, where no learned clause can be the reason for an assignment that matters.
+void puzzles::SudokuSatSolver::reduceLearned()
+{
+    std::stable_sort(m_learned.begin(), m_learned.end(),
+                     [this](ClauseReference lhs, ClauseReference rhs) { return clauseLbd(lhs) < clauseLbd(rhs); });
+
+    std::size_t const keep{ m_learned.size() / 2 };
+    std::size_t kept{ 0 };
+    for (std::size_t index = 0; index != m_learned.size(); ++index)
+    {
+        ClauseReference const clause{ m_learned[index] };
+        if (index < keep || clauseLbd(clause) <= c_keptLbd)
+        {
+            m_learned[kept++] = clause;
+            continue;
+        }
+        m_arena[clause + 1] |= c_deletedFlag;
+        m_wastedWords += clauseSize(clause) + 2;
+        ++m_statistics.deletedClauses;
+    }
+    m_learned.resize(kept);
+
+    if (m_wastedWords * 2 > m_arena.size())
+        collectGarbage();
+}
+
+// Copy the live clauses into a fresh arena and rebuild the watches
+void puzzles::SudokuSatSolver::collectGarbage()
+{
+    std::vector<std::uint32_t> arena{};
+    arena.reserve(m_arena.size() - m_wastedWords);
+    m_learned.clear();
+    for (auto& watches : m_watches)
+        watches.clear();
+
+    for (ClauseReference clause = 0; clause < m_arena.size(); clause += clauseSize(clause) + 2)
+    {
+        if (clauseDeleted(clause))
+            continue;
+        ClauseReference const moved{ static_cast<ClauseReference>(arena.size()) };
+        arena.insert(arena.end(), m_arena.cbegin() + clause, m_arena.cbegin() + clause + clauseSize(clause) + 2);
+        if (clauseLearned(clause))
+            m_learned.push_back(moved);
+    }
+    m_arena.swap(arena);
+    m_wastedWords = 0;
+
+    for (ClauseReference clause = 0; clause < m_arena.size(); clause += clauseSize(clause) + 2)
+        watchClause(clause);
+
+    // Top level assignments never need their reasons again
+    for (auto& reason : m_reasons)
+        reason = noClause();
+}
+
+// Small random activities give a random starting order without swamping the first conflicts
+void puzzles::SudokuSatSolver::randomiseBranching()
+{
+    std::uint64_t random{ m_seed };
+    for (std::size_t variable = 0; variable != variableCount(); ++variable)
+    {
+        // xorshift64
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        m_activities[variable] += static_cast<double>(random % 1024) * 1e-6 * m_activityIncrement;
+        m_savedPhases[variable] = (random & (std::uint64_t{ 1 } << 32)) != 0;
+        if (m_heapPositions[variable] != c_notInHeap)
+            heapUp(m_heapPositions[variable]);
+    }
+}
+
+// 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+std::size_t puzzles::SudokuSatSolver::luby(std::size_t index)
+{
+    std::size_t size{ 1 };
+    std::size_t power{ 0 };
+    while (size < index + 1)
+    {
+        size = size * 2 + 1;
+        ++power;
+    }
+    while (size - 1 != index)
+    {
+        size = (size - 1) / 2;
+        --power;
+        index %= size;
+    }
+    return std::size_t{ 1 } << power;
+}
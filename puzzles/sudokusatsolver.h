@@ -0,0 +1,192 @@
+#ifndef SUDOKUSATSOLVER_H
+#define SUDOKUSATSOLVER_H
+/*
+struct SudokuSatStatistics
+====================================================================================================
+Counters from the last SudokuSatSolver::solve().
+
+class SudokuSatSolver
+====================================================================================================
+A small conflict driven clause learning SAT solver, used as an alternative to propagation and
+backtracking for large boards. It knows nothing about Sudoku; SudokuSatEngine<N> does the encoding.
+
+Variables are numbered from 0 and a literal is 2 * variable, plus 1 if it is negated. Clauses are
+stored end to end in one array of 32 bit words (a header then the literals) and referred to by
+their offset, with two watched literals each. Conflicts are analysed to the first unique
+implication point, the learned clause is minimised and kept, branching uses VSIDS activity with
+saved phases, restarts follow the Luby sequence, and learned clauses with a poor literal block
+distance are thrown away as the database grows. A solve can be cancelled through a
+SudokuCancellationToken, and seeding it changes the branching so that several copies of one problem
+search differently.
+*/
+#include "sudokucancellation.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace puzzles
+{
+
+struct SudokuSatStatistics
+{
+    std::size_t decisions;
+    std::size_t propagations;
+    std::size_t conflicts;
+    std::size_t restarts;
+    std::size_t learnedClauses;
+    std::size_t deletedClauses;
+};
+
+class SudokuSatSolver
+{
+public:
+    // Typedefs
+    //============================================================
+    using Literal = std::uint32_t;
+
+    enum class Result
+    {
+        Satisfiable,
+        Unsatisfiable,
+        Cancelled
+    };
+
+    // Special 6
+    //============================================================
+    SudokuSatSolver();
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    static Literal positive(std::size_t variable)  { return static_cast<Literal>(variable * 2); }
+    static Literal negative(std::size_t variable)  { return static_cast<Literal>(variable * 2 + 1); }
+    static Literal negate(Literal literal)         { return literal ^ 1; }
+    static std::size_t variableOf(Literal literal) { return literal >> 1; }
+
+    // Add a variable, returning its number. Variables that aren't decisions are never branched
+    // on, which is only right if any assignment of the decision variables that propagates without
+    // a conflict can be completed (auxiliary variables of an encoding, say). Their model values
+    // are then meaningless.
+    std::size_t addVariable(bool isDecision = true);
+    std::size_t variableCount() const;
+
+    // Add a clause at the top level. Returns false if the formula is now known to be
+    // unsatisfiable.
+    bool addClause(std::vector<Literal> literals);
+
+    Result solve();
+
+    // Checked before every decision and after every conflict; nullptr for none. The token must
+    // outlive any solve() it is set for.
+    void setCancellationToken(SudokuCancellationToken const* cancellation);
+
+    // With a seed of 0 branching starts from the order variables were added and tries false
+    // first. Any other seed starts from a pseudo-random order and random phases.
+    void setSeed(std::uint64_t seed);
+
+    // The value to try first the first time the variable is branched on, for starting the search
+    // near a known assignment. A seed other than 0 replaces these with random phases.
+    void setPhase(std::size_t variable, bool value);
+
+    // The value of a variable in the model found by the last successful solve()
+    bool modelValue(std::size_t variable) const;
+
+    SudokuSatStatistics const& statistics() const;
+
+private:
+    // Typedefs
+    //============================================================
+    using ClauseReference = std::uint32_t;
+
+    // Values are stored per literal: true, false or unassigned
+    enum : std::uint8_t { c_true = 0, c_false = 1, c_unassigned = 2 };
+
+    struct Watcher
+    {
+        ClauseReference clause;
+        Literal blocker;
+    };
+
+    // Helpers
+    //============================================================
+    // Clause arena access: header word 0 is the size, word 1 is learned flag and LBD
+    std::uint32_t clauseSize(ClauseReference clause) const  { return m_arena[clause]; }
+    bool clauseLearned(ClauseReference clause) const        { return (m_arena[clause + 1] & 0x80000000u) != 0; }
+    bool clauseDeleted(ClauseReference clause) const        { return (m_arena[clause + 1] & 0x40000000u) != 0; }
+    std::uint32_t clauseLbd(ClauseReference clause) const   { return m_arena[clause + 1] & 0x3FFFFFFFu; }
+    Literal* clauseLiterals(ClauseReference clause)         { return &m_arena[clause + 2]; }
+
+    ClauseReference storeClause(std::vector<Literal> const& literals, bool learned, std::uint32_t lbd);
+    void watchClause(ClauseReference clause);
+
+    std::uint8_t literalValue(Literal literal) const;
+    std::size_t decisionLevel() const;
+    void assign(Literal literal, ClauseReference reason);
+    void newDecisionLevel();
+    void backtrack(std::size_t level);
+
+    // Returns the conflicting clause or noClause()
+    ClauseReference propagate();
+    // Learn a clause from a conflict, returning the level to go back to
+    std::size_t analyse(ClauseReference conflict, std::vector<Literal>& learned, std::uint32_t& lbd);
+    bool literalRedundant(Literal literal, std::uint32_t levels);
+    std::uint32_t levelBit(std::size_t variable) const;
+
+    Literal pickBranchLiteral();
+    void bumpVariable(std::size_t variable);
+    void decayActivities();
+
+    // Variable order heap, largest activity on top
+    bool heapLess(std::size_t lhs, std::size_t rhs) const;
+    void heapInsert(std::size_t variable);
+    std::size_t heapPop();
+    void heapUp(std::size_t position);
+    void heapDown(std::size_t position);
+
+    void reduceLearned();
+    void collectGarbage();
+
+    static std::size_t luby(std::size_t index);
+    void randomiseBranching();
+
+    static ClauseReference noClause() { return 0xFFFFFFFFu; }
+
+    // Data Members
+    //============================================================
+    std::vector<std::uint32_t> m_arena;
+    std::vector<ClauseReference> m_learned;
+    std::size_t m_wastedWords;
+    std::vector<std::vector<Watcher>> m_watches;
+
+    std::vector<std::uint8_t> m_values;         // per literal
+    std::vector<std::size_t> m_levels;          // per variable
+    std::vector<ClauseReference> m_reasons;     // per variable
+    std::vector<bool> m_savedPhases;            // per variable, true means positive
+    std::vector<bool> m_model;                  // per variable
+
+    std::vector<Literal> m_trail;
+    std::vector<std::size_t> m_trailLimits;
+    std::size_t m_propagateHead;
+
+    std::vector<double> m_activities;
+    double m_activityIncrement;
+    std::vector<std::size_t> m_heap;
+    std::vector<std::size_t> m_heapPositions;   // per variable, c_notInHeap if absent
+    std::vector<bool> m_decisions;              // per variable
+
+    std::vector<std::uint8_t> m_seen;           // per variable, used by analyse
+    std::vector<Literal> m_analyseStack;
+    std::vector<Literal> m_analyseClear;        // literals to unmark once analyse is done
+    std::vector<std::size_t> m_levelStamps;     // per level, used to count LBD
+    std::size_t m_levelStamp;
+
+    bool m_unsatisfiable;
+    SudokuCancellationToken const* m_cancellation;
+    std::uint64_t m_seed;
+    SudokuSatStatistics m_statistics;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSATSOLVER_H
@@ -0,0 +1,28 @@
+#ifndef SUDOKUSEARCHSTATISTICS_H
+#define SUDOKUSEARCHSTATISTICS_H
+/*
+struct SudokuSearchStatistics
+====================================================================================================
+Counters filled in by a solve so runs can be compared. Everything starts at 0.
+
+nodes           Number of guesses tried when propagation alone couldn't finish the board.
+backtracks      Number of those guesses that were undone.
+maxDepth        Deepest the guesses were nested.
+maxTrailSize    Most tile masks the undo trail held at once.
+*/
+#include <cstddef>
+
+namespace puzzles
+{
+
+struct SudokuSearchStatistics
+{
+    std::size_t nodes;
+    std::size_t backtracks;
+    std::size_t maxDepth;
+    std::size_t maxTrailSize;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSEARCHSTATISTICS_H
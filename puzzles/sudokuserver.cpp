@@ -0,0 +1,113 @@
+#include "sudokuserver.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+
+// Special 6
+//============================================================
+puzzles::SudokuServer::SudokuServer(std::size_t workerCount, QObject* parent) :
+    QObject(parent),
+    m_server{new QLocalServer(this)},
+    m_clients(),
+    m_nextClient{1},
+    m_service()
+{
+    QObject::connect(m_server, &QLocalServer::newConnection,
+                     this, &SudokuServer::slot_newConnection);
+    QObject::connect(this, &SudokuServer::responseReady,
+                     this, &SudokuServer::slot_writeResponse, Qt::QueuedConnection);
+
+    m_service.reset(new SudokuSolveService(workerCount, [this](std::uint64_t client, std::string const& response)
+    {
+        emit responseReady(static_cast<quint64>(client), QByteArray::fromStdString(response + '\n'));
+    }));
+}
+
+// Stop the workers first: they emit through this object
+puzzles::SudokuServer::~SudokuServer()
+{
+    m_service.reset();
+}
+
+// Interface
+//============================================================
+bool puzzles::SudokuServer::listen(QString const& name)
+{
+    QLocalServer::removeServer(name);
+    return m_server->listen(name);
+}
+
+QString puzzles::SudokuServer::errorString() const
+{
+    return m_server->errorString();
+}
+
+puzzles::SudokuSolveService& puzzles::SudokuServer::service()
+{
+    return *m_service;
+}
+
+// Slots
+//============================================================
+void puzzles::SudokuServer::slot_newConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection())
+    {
+        quint64 const client{ m_nextClient++ };
+        m_clients.insert(client, socket);
+
+        QObject::connect(socket, &QLocalSocket::readyRead,
+                         this, [this, client]() { readClient(client); });
+        QObject::connect(socket, &QLocalSocket::disconnected,
+                         this, [this, client]() { dropClient(client); });
+        // Anything that arrived with the connection
+        readClient(client);
+    }
+}
+
+void puzzles::SudokuServer::slot_writeResponse(quint64 client, QByteArray response)
+{
+    auto found = m_clients.find(client);
+    if (found != m_clients.end())
+        found.value()->write(response);
+}
+
+// Helpers
+//============================================================
+void puzzles::SudokuServer::readClient(quint64 client)
+{
+    auto found = m_clients.find(client);
+    if (found == m_clients.end())
+        return;
+
+    // A line longer than any request could be is never buffered whole: the client is dropped
+    QLocalSocket* socket{ found.value() };
+    qint64 const maxLength{ static_cast<qint64>(SudokuSolveService::maxLineLength()) };
+    while (socket->canReadLine())
+    {
+        QByteArray const line{ socket->readLine(maxLength + 1) };
+        if (!line.endsWith('\n'))
+        {
+            socket->abort();
+            dropClient(client);
+            return;
+        }
+        m_service->submit(client, line.trimmed().toStdString());
+    }
+    if (socket->bytesAvailable() > maxLength)
+    {
+        socket->abort();
+        dropClient(client);
+    }
+}
+
+void puzzles::SudokuServer::dropClient(quint64 client)
+{
+    auto found = m_clients.find(client);
+    if (found == m_clients.end())
+        return;
+
+    m_service->cancelClient(client);
+    found.value()->deleteLater();
+    m_clients.erase(found);
+}
@@ -0,0 +1,81 @@
+#ifndef SUDOKUSERVER_H
+#define SUDOKUSERVER_H
+/*
+class SudokuServer
+====================================================================================================
+Serves SudokuSolveService over a local socket (a Unix domain socket, or a named pipe on Windows)
+using QLocalServer, so any number of local clients can send request lines and get response lines
+back on the same connection. Responses come back in the order the requests finish, not the order
+they were sent; the ids match them up.
+
+Workers hand their responses to the server's thread through a queued signal, which writes them to
+the client if it is still connected. A client that disconnects has its outstanding requests
+cancelled, and one that sends a line longer than SudokuSolveService::maxLineLength() is
+disconnected.
+*/
+#include "sudokusolveservice.h"
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <memory>
+
+// Forward Declarations
+class QLocalServer;
+class QLocalSocket;
+
+namespace puzzles
+{
+
+class SudokuServer :
+        public QObject
+{
+    Q_OBJECT
+
+public:
+    // Special 6
+    //============================================================
+    // workerCount 0 means one per hardware thread
+    explicit SudokuServer(std::size_t workerCount, QObject* parent = nullptr);
+    ~SudokuServer() override;
+
+    // No copying
+    SudokuServer(SudokuServer const& other) = delete;
+    SudokuServer& operator=(SudokuServer const& other) = delete;
+
+    // Interface
+    //============================================================
+    // Start listening on this socket name, removing a stale socket left by a server that died
+    bool listen(QString const& name);
+    QString errorString() const;
+
+    SudokuSolveService& service();
+
+signals:
+    // Emitted on a worker thread
+    void responseReady(quint64 client, QByteArray response);
+
+    // Slots
+    //============================================================
+private slots:
+    void slot_newConnection();
+    void slot_writeResponse(quint64 client, QByteArray response);
+
+private:
+    // Helpers
+    //============================================================
+    void readClient(quint64 client);
+    void dropClient(quint64 client);
+
+    // Data Members
+    //============================================================
+    QLocalServer* m_server;
+    QHash<quint64, QLocalSocket*> m_clients;
+    quint64 m_nextClient;
+    // Last so the workers stop before anything they report to goes away
+    std::unique_ptr<SudokuSolveService> m_service;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSERVER_H
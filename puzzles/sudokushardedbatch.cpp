@@ -0,0 +1,584 @@
+#include "sudokushardedbatch.h"
+
+#include "sudokucompressedinput.h"
+#include "sudokupuzzletext.h"
+#include "sudokuruntimesolver.h"
+#include "sudokuvalidator.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QProcess>
+#include <QSharedMemory>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using clock_type = puzzles::SudokuCancellationToken::clock_type;
+    using Counter = std::atomic<std::uint64_t>;
+
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the shared counters must be lock-free to work across processes");
+
+    std::uint64_t const c_magic{ 0x5355444F4B555348 };
+    std::uint8_t const c_badPuzzle{ 0xFF };
+    std::uint8_t const c_conflictingGivens{ 0xFE };
+    std::uint8_t const c_invalidSolution{ 0xFD };
+    std::size_t const c_maxRestarts{ 16 };
+    char const* const c_statusNames[]{ "solved ", "unsolvable ", "timeout ", "cancelled " };
+
+    // The start of the segment: what the workers need to know, and the work queue
+    struct Header
+    {
+        std::uint64_t magic;
+        std::uint64_t shardCount;
+        std::uint64_t workerCount;
+        std::uint64_t slotCount;
+        std::uint64_t slotBytes;
+        std::uint64_t engine;
+        std::uint64_t seed;
+        std::uint64_t timeout;          // milliseconds, 0 for none
+        std::uint64_t cacheLimit;
+        alignas(64) Counter nextShard;
+        alignas(64) Counter workerWaits;
+        Counter stop;
+    };
+
+    // What one worker is doing: the shard it holds plus one, or 0 between shards
+    struct WorkerState
+    {
+        alignas(64) Counter shard;
+    };
+
+    // A shard's results: the turn counter, the worker's hardware counters while it solved the
+    // shard, then count records taking bytes bytes in all
+    struct ResultSlot
+    {
+        alignas(64) Counter turn;
+        std::uint64_t count;
+        std::uint64_t bytes;
+        puzzles::SudokuPerfSample counters;
+    };
+
+    // One puzzle's result, followed by its tileCount values padded to 8 bytes
+    struct Record
+    {
+        std::uint8_t status;            // a SudokuSolveStatus, or c_badPuzzle, c_conflictingGivens or c_invalidSolution
+        std::uint8_t boxSize;
+        std::uint16_t reserved;
+        std::uint32_t tileCount;
+        std::uint64_t time;             // nanoseconds
+    };
+
+    std::size_t roundUp(std::size_t size, std::size_t alignment)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    std::size_t recordSize(std::size_t tileCount)
+    {
+        return sizeof(Record) + roundUp(tileCount, 8);
+    }
+
+    // Where everything is in the segment, worked out the same way by every process from the header
+    class SharedView
+    {
+    public:
+        static std::size_t size(std::size_t shardCount, std::size_t workerCount, std::size_t slotCount, std::size_t slotBytes)
+        {
+            return workersOffset(shardCount) + workerCount * sizeof(WorkerState) + slotCount * slotStride(slotBytes);
+        }
+
+        static std::size_t slotStride(std::size_t slotBytes)
+        {
+            return roundUp(sizeof(ResultSlot) + slotBytes, 64);
+        }
+
+        explicit SharedView(void* data) :
+            m_data(static_cast<unsigned char*>(data)),
+            m_header(static_cast<Header*>(data))
+        {}
+
+        Header& header() const
+        {
+            return *m_header;
+        }
+        // shardCount + 1 of them, the last being the end of the file
+        std::uint64_t* shardOffsets() const
+        {
+            return reinterpret_cast<std::uint64_t*>(m_data + roundUp(sizeof(Header), 64));
+        }
+        WorkerState& worker(std::size_t index) const
+        {
+            return reinterpret_cast<WorkerState*>(m_data + workersOffset(m_header->shardCount))[index];
+        }
+        ResultSlot& slot(std::uint64_t shard) const
+        {
+            std::size_t const slotsOffset{ workersOffset(m_header->shardCount) + m_header->workerCount * sizeof(WorkerState) };
+            return *reinterpret_cast<ResultSlot*>(m_data + slotsOffset + shard % m_header->slotCount * slotStride(m_header->slotBytes));
+        }
+        unsigned char* records(ResultSlot& slot) const
+        {
+            return reinterpret_cast<unsigned char*>(&slot) + sizeof(ResultSlot);
+        }
+
+    private:
+        static std::size_t workersOffset(std::size_t shardCount)
+        {
+            return roundUp(roundUp(sizeof(Header), 64) + (shardCount + 1) * sizeof(std::uint64_t), 64);
+        }
+
+        unsigned char* m_data;
+        Header* m_header;
+    };
+
+    // Call visit(text, length) with each line of [begin, end) the batch pipeline would read a
+    // puzzle from: trimmed, and skipping blank lines and comments
+    template <typename Visit>
+    void forEachPuzzleLine(char const* begin, char const* end, Visit visit)
+    {
+        while (begin != end)
+        {
+            char const* const newline{ static_cast<char const*>(std::memchr(begin, '\n', static_cast<std::size_t>(end - begin))) };
+            char const* const lineEnd{ newline != nullptr ? newline : end };
+            std::size_t first{ 0 };
+            std::size_t length{ 0 };
+            if (puzzles::SudokuPuzzleText::findPuzzle(begin, static_cast<std::size_t>(lineEnd - begin), first, length))
+                visit(begin + first, length);
+            begin = newline != nullptr ? newline + 1 : end;
+        }
+    }
+
+    // As SudokuRingBuffer waits: spin, then yield, then sleep
+    void pause(std::size_t waits)
+    {
+        if (waits >= 1024)
+            std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+        else if (waits >= 64)
+            std::this_thread::yield();
+    }
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuShardedBatch::SudokuShardedBatch(std::size_t workerCount) :
+    m_workerCount{ workerCount != 0 ? workerCount : std::max(1u, std::thread::hardware_concurrency()) },
+    m_program{},
+    m_arguments{},
+    m_shardSize{ 256 },
+    m_slotsPerWorker{ 4 },
+    m_options{ SudokuSolveOptions{} },
+    m_timeout{ 0 },
+    m_cacheLimit{ 3 },
+    m_errorString{}
+{}
+
+// Interface
+//============================================================
+bool puzzles::SudokuShardedBatch::run(QString const& inputName, std::ostream& output, SudokuBatchStatistics& statistics,
+                                      SudokuCancellationToken const& cancellation)
+{
+    clock_type::time_point const started{ clock_type::now() };
+    statistics = SudokuBatchStatistics{};
+    m_errorString.clear();
+
+    QFile input{ inputName };
+    if (!input.open(QIODevice::ReadOnly))
+    {
+        m_errorString = input.errorString();
+        return false;
+    }
+    std::size_t const size{ static_cast<std::size_t>(input.size()) };
+    char const* data{ nullptr };
+    if (size != 0)
+    {
+        data = reinterpret_cast<char const*>(input.map(0, input.size()));
+        if (data == nullptr)
+        {
+            m_errorString = input.errorString();
+            return false;
+        }
+    }
+    // Shards are byte ranges of the file, which a compressed stream doesn't have
+    SudokuCompression const compression{ SudokuCompressedInput::detect(data, size) };
+    if (compression != SudokuCompression::None)
+    {
+        m_errorString = QStringLiteral("%1 compressed input can't be split into shards")
+                            .arg(QString::fromLatin1(SudokuCompressedInput::name(compression)));
+        return false;
+    }
+
+    // Shard boundaries every so many lines
+    std::vector<std::uint64_t> offsets{ 0 };
+    for (std::size_t position = 0, lines = 0; position != size; )
+    {
+        char const* const newline{ static_cast<char const*>(std::memchr(data + position, '\n', size - position)) };
+        std::size_t const lineEnd{ newline != nullptr ? static_cast<std::size_t>(newline - data) : size };
+        position = newline != nullptr ? lineEnd + 1 : size;
+        if (++lines % m_shardSize == 0 && position != size)
+            offsets.push_back(position);
+    }
+    offsets.push_back(size);
+
+    // The most tiles any puzzle has, which sizes the result slots. A puzzle has no more tiles than
+    // characters, so only lines longer than the most so far need parsing; comments, blank lines
+    // and lines that aren't puzzles only ever get a bare record.
+    std::size_t largestPuzzle{ 0 };
+    std::vector<std::uint8_t> values{};
+    forEachPuzzleLine(data, data + size, [&largestPuzzle, &values](char const* text, std::size_t length)
+    {
+        std::size_t boxSize{ 0 };
+        if (length > largestPuzzle && SudokuPuzzleText::parse(text, length, values, boxSize))
+            largestPuzzle = std::max(largestPuzzle, values.size());
+    });
+
+    std::size_t const shardCount{ offsets.size() - 1 };
+    std::size_t const workerCount{ std::min(m_workerCount, shardCount) };
+    std::size_t const slotCount{ std::max<std::size_t>(2, workerCount * m_slotsPerWorker) };
+    std::size_t const maxRecord{ recordSize(largestPuzzle) };
+    // QSharedMemory takes its size as an int
+    std::size_t const maxSegment{ static_cast<std::size_t>(std::numeric_limits<int>::max()) };
+    std::size_t const slotBytes{ m_shardSize <= maxSegment / maxRecord ? m_shardSize * maxRecord : maxSegment };
+    std::size_t const fixedBytes{ SharedView::size(shardCount, workerCount, 0, 0) };
+    if (fixedBytes > maxSegment || slotCount > (maxSegment - fixedBytes) / SharedView::slotStride(slotBytes))
+    {
+        m_errorString = QStringLiteral("shards of %1 lines of up to %2 tiles need more shared memory than can be made; "
+                                       "use a smaller batch size").arg(m_shardSize).arg(largestPuzzle);
+        return false;
+    }
+
+    static std::atomic<unsigned> s_runs{ 0 };
+    QString const key{ QStringLiteral("sudoku_solver_shards_%1_%2").arg(QCoreApplication::applicationPid()).arg(s_runs++) };
+    QSharedMemory memory{ key };
+    if (!memory.create(static_cast<int>(SharedView::size(shardCount, workerCount, slotCount, slotBytes))))
+    {
+        m_errorString = memory.errorString();
+        return false;
+    }
+
+    Header& header = *new (memory.data()) Header();
+    header.shardCount = shardCount;
+    header.workerCount = workerCount;
+    header.slotCount = slotCount;
+    header.slotBytes = slotBytes;
+    header.engine = static_cast<std::uint64_t>(m_options.engine);
+    header.seed = m_options.seed;
+    header.timeout = static_cast<std::uint64_t>(m_timeout.count());
+    header.cacheLimit = m_cacheLimit;
+    SharedView const view{ memory.data() };
+    std::copy(offsets.cbegin(), offsets.cend(), view.shardOffsets());
+    for (std::size_t index = 0; index != workerCount; ++index)
+        new (&view.worker(index)) WorkerState();
+    for (std::size_t index = 0; index != slotCount; ++index)
+        new (&view.slot(index)) ResultSlot{ { 2 * index }, 0, 0, SudokuPerfSample{} };
+    // Last, so a worker that sees the magic sees everything else
+    std::atomic_thread_fence(std::memory_order_release);
+    header.magic = c_magic;
+
+    std::vector<std::unique_ptr<QProcess>> workers(workerCount);
+    auto const startWorker = [this, &workers, &key, &inputName](std::size_t index)
+    {
+        workers[index].reset(new QProcess{});
+        workers[index]->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        workers[index]->start(m_program, m_arguments + QStringList{ QStringLiteral("--shard-key"), key,
+                                                                    QStringLiteral("--shard-index"), QString::number(index),
+                                                                    QStringLiteral("--input"), inputName });
+    };
+    for (std::size_t index = 0; index != workerCount; ++index)
+        startWorker(index);
+
+    // Find workers that have stopped. A shard one was holding is lost, and it is replaced while
+    // there is work left for it. Returns whether any are still running.
+    std::vector<bool> lost(shardCount, false);
+    std::size_t restarts{ 0 };
+    auto const heldByOther = [&view, workerCount](std::size_t index, std::uint64_t held)
+    {
+        for (std::size_t other = 0; other != workerCount; ++other)
+            if (other != index && view.worker(other).shard.load() == held)
+                return true;
+        return false;
+    };
+    auto const reapWorkers = [&]()
+    {
+        bool running{ false };
+        for (std::size_t index = 0; index != workerCount; ++index)
+        {
+            QProcess* const worker{ workers[index].get() };
+            if (worker == nullptr)
+                continue;
+            if (worker->state() != QProcess::NotRunning && !worker->waitForFinished(0))
+            {
+                running = true;
+                continue;
+            }
+
+            // A worker says which shard it is about to take before taking it. If it died before
+            // taking it, or another worker took it meanwhile, the shard isn't lost.
+            std::uint64_t const held{ view.worker(index).shard.exchange(0) };
+            if (held != 0 && header.nextShard.load() >= held && !heldByOther(index, held))
+            {
+                lost[held - 1] = true;
+                std::cerr << "worker " << index << " stopped during shard " << held - 1 << '\n';
+            }
+            bool const failed{ held != 0 || worker->exitStatus() != QProcess::NormalExit || worker->exitCode() != 0 };
+            if (failed && restarts != c_maxRestarts && header.nextShard.load() < shardCount)
+            {
+                ++restarts;
+                startWorker(index);
+                running = true;
+            }
+            else
+            {
+                workers[index].reset();
+            }
+        }
+        return running;
+    };
+
+    // Write the shards out in order straight from their slots
+    std::string text{};
+    for (std::uint64_t shard = 0; shard != shardCount; ++shard)
+    {
+        ResultSlot& slot = view.slot(shard);
+        std::size_t waits{ 0 };
+        while (slot.turn.load(std::memory_order_acquire) != 2 * shard + 1 && !lost[shard])
+        {
+            if (cancellation.shouldStop())
+                break;
+            // Once it's a long wait, check nothing has died; if every worker has stopped, whatever
+            // hasn't arrived never will
+            if (waits >= 1024 && waits % 16 == 0 && !reapWorkers())
+                lost[shard] = slot.turn.load(std::memory_order_acquire) != 2 * shard + 1;
+            pause(waits++);
+        }
+        if (cancellation.shouldStop())
+            break;
+        if (waits != 0)
+            ++statistics.writerWaits;
+
+        text.clear();
+        if (slot.turn.load(std::memory_order_acquire) == 2 * shard + 1)
+        {
+            SudokuPerfCounters::add(statistics.counters, slot.counters);
+            unsigned char const* records{ view.records(slot) };
+            for (std::uint64_t index = 0; index != slot.count; ++index)
+            {
+                Record const& record = *reinterpret_cast<Record const*>(records);
+                ++statistics.puzzles;
+                if (record.status == c_badPuzzle || record.status == c_conflictingGivens || record.status == c_invalidSolution)
+                {
+                    ++statistics.errors;
+                    text += record.status == c_badPuzzle ? "error bad puzzle\n"
+                          : record.status == c_conflictingGivens ? "error conflicting givens\n"
+                          : "error invalid solution\n";
+                    records += recordSize(record.tileCount);
+                    continue;
+                }
+
+                switch (static_cast<SudokuSolveStatus>(record.status))
+                {
+                case SudokuSolveStatus::Solved:     ++statistics.solved; break;
+                case SudokuSolveStatus::Unsolvable: ++statistics.unsolvable; break;
+                case SudokuSolveStatus::TimedOut:   ++statistics.timedOut; break;
+                case SudokuSolveStatus::Cancelled:  ++statistics.cancelled; break;
+                }
+                statistics.solveTime += std::chrono::nanoseconds{ record.time };
+                text += c_statusNames[record.status];
+                SudokuPuzzleText::append(records + sizeof(Record), record.boxSize, text);
+                text += '\n';
+                records += recordSize(record.tileCount);
+            }
+        }
+        else
+        {
+            forEachPuzzleLine(data + offsets[shard], data + offsets[shard + 1], [&statistics, &text](char const*, std::size_t)
+            {
+                ++statistics.puzzles;
+                ++statistics.errors;
+                text += "error worker crashed\n";
+            });
+        }
+        output.write(text.data(), static_cast<std::streamsize>(text.size()));
+        ++statistics.batches;
+        slot.turn.store(2 * (shard + slotCount), std::memory_order_release);
+    }
+    output.flush();
+
+    // Workers stop by themselves once the shards run out; a cancelled run doesn't wait for them
+    header.stop.store(1);
+    for (auto& worker : workers)
+    {
+        if (worker != nullptr && (cancellation.shouldStop() || !worker->waitForFinished(5000)))
+        {
+            worker->kill();
+            worker->waitForFinished(-1);
+        }
+    }
+
+    statistics.readerWaits = header.workerWaits.load();
+    statistics.wallTime = clock_type::now() - started;
+    return true;
+}
+
+QString puzzles::SudokuShardedBatch::errorString() const
+{
+    return m_errorString;
+}
+
+int puzzles::SudokuShardedBatch::runWorker(QString const& key, std::size_t index, QString const& inputName)
+{
+    QSharedMemory memory{ key };
+    if (!memory.attach())
+    {
+        std::cerr << "cannot attach to " << key.toStdString() << ": " << memory.errorString().toStdString() << '\n';
+        return 1;
+    }
+    SharedView const view{ memory.data() };
+    Header& header = view.header();
+    if (header.magic != c_magic || index >= header.workerCount)
+    {
+        std::cerr << key.toStdString() << " is not a shard segment for worker " << index << '\n';
+        return 1;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    QFile input{ inputName };
+    if (!input.open(QIODevice::ReadOnly))
+    {
+        std::cerr << "cannot open " << inputName.toStdString() << ": " << input.errorString().toStdString() << '\n';
+        return 1;
+    }
+    char const* const data{ input.size() != 0 ? reinterpret_cast<char const*>(input.map(0, input.size())) : nullptr };
+    if (input.size() != 0 && data == nullptr)
+    {
+        std::cerr << "cannot map " << inputName.toStdString() << ": " << input.errorString().toStdString() << '\n';
+        return 1;
+    }
+
+    SudokuRuntimeSolver solver{};
+    solver.setCacheLimit(static_cast<std::size_t>(header.cacheLimit));
+    SudokuSolveOptions const options{ static_cast<SudokuEngine>(header.engine), header.seed };
+    std::chrono::milliseconds const timeout{ header.timeout };
+    SudokuCancellationToken const cancellation{};
+    SudokuPerfCounters const counters{};
+    std::uint64_t const* const offsets{ view.shardOffsets() };
+    Counter& held = view.worker(index).shard;
+
+    std::vector<std::uint8_t> values{};
+    while (header.stop.load() == 0)
+    {
+        // Say which shard this is before taking it, so that if the worker dies straight after, the
+        // coordinator knows the shard was lost
+        std::uint64_t shard{ header.nextShard.load() };
+        do
+        {
+            if (shard >= header.shardCount)
+                break;
+            held.store(shard + 1);
+        }
+        while (!header.nextShard.compare_exchange_weak(shard, shard + 1));
+        if (shard >= header.shardCount)
+        {
+            held.store(0);
+            break;
+        }
+
+        ResultSlot& slot = view.slot(shard);
+        std::size_t waits{ 0 };
+        while (slot.turn.load(std::memory_order_acquire) != 2 * shard)
+        {
+            if (header.stop.load() != 0)
+                return 0;
+            pause(waits++);
+        }
+        if (waits != 0)
+            ++header.workerWaits;
+
+        // Solve each puzzle straight into its record
+        unsigned char* const records{ view.records(slot) };
+        std::size_t used{ 0 };
+        std::uint64_t count{ 0 };
+        SudokuPerfSample const start{ counters.read() };
+        slot.counters = SudokuPerfSample{};
+        forEachPuzzleLine(data + offsets[shard], data + offsets[shard + 1], [&](char const* text, std::size_t length)
+        {
+            Record& record = *reinterpret_cast<Record*>(records + used);
+            std::size_t boxSize{ 0 };
+            ++count;
+            if (!SudokuPuzzleText::parse(text, length, values, boxSize))
+            {
+                record = Record{ c_badPuzzle, 0, 0, 0, 0 };
+                used += sizeof(Record);
+                return;
+            }
+            if (SudokuValidator::checkGivens(values.data(), boxSize) != SudokuValidity::Valid)
+            {
+                record = Record{ c_conflictingGivens, 0, 0, 0, 0 };
+                used += sizeof(Record);
+                return;
+            }
+
+            std::uint8_t* const solution{ records + used + sizeof(Record) };
+            clock_type::time_point const deadline{ timeout.count() == 0 ? clock_type::time_point::max() : clock_type::now() + timeout };
+            SudokuRuntimeReport const report{ solver.solve(boxSize, values.data(), solution, options, deadline, cancellation) };
+            std::uint8_t status{ static_cast<std::uint8_t>(report.status) };
+            if (report.status == SudokuSolveStatus::Solved
+                && SudokuValidator::checkSolution(solution, values.data(), boxSize) != SudokuValidity::Valid)
+                status = c_invalidSolution;
+            record = Record{ status, static_cast<std::uint8_t>(boxSize), 0,
+                             static_cast<std::uint32_t>(values.size()), static_cast<std::uint64_t>(report.time.count()) };
+            used += recordSize(values.size());
+        });
+
+        counters.addSince(start, slot.counters);
+        slot.count = count;
+        slot.bytes = used;
+        slot.turn.store(2 * shard + 1, std::memory_order_release);
+        held.store(0);
+    }
+    return 0;
+}
+
+std::size_t puzzles::SudokuShardedBatch::workerCount() const
+{
+    return m_workerCount;
+}
+
+void puzzles::SudokuShardedBatch::setWorkerCommand(QString const& program, QStringList const& arguments)
+{
+    m_program = program;
+    m_arguments = arguments;
+}
+
+void puzzles::SudokuShardedBatch::setShardSize(std::size_t shardSize)
+{
+    m_shardSize = std::max<std::size_t>(1, shardSize);
+}
+
+void puzzles::SudokuShardedBatch::setSlotsPerWorker(std::size_t slots)
+{
+    m_slotsPerWorker = std::max<std::size_t>(1, slots);
+}
+
+void puzzles::SudokuShardedBatch::setOptions(SudokuSolveOptions const& options)
+{
+    m_options = options;
+}
+
+void puzzles::SudokuShardedBatch::setTimeout(std::chrono::milliseconds timeout)
+{
+    m_timeout = timeout;
+}
+
+void puzzles::SudokuShardedBatch::setCacheLimit(std::size_t boxSize)
+{
+    m_cacheLimit = boxSize;
+}
@@ -0,0 +1,99 @@
+#ifndef SUDOKUSHARDEDBATCH_H
+#define SUDOKUSHARDEDBATCH_H
+/*
+class SudokuShardedBatch
+====================================================================================================
+Solves a corpus file the way SudokuBatchPipeline does, with the same output, but with the solving
+done by worker processes rather than threads. A worker that crashes takes only its own shard with it,
+and each worker has its own heap, so there is no allocator to contend for.
+
+The coordinator maps the corpus file and splits it into shards of a fixed number of lines. A single
+QSharedMemory segment then holds everything the processes share:
+- a header with the solve options and the work queue, which is just the next shard to hand out;
+  a worker takes one by incrementing it,
+- the byte offset of each shard in the file,
+- a slot per worker saying which shard it is on, so the coordinator knows what a crash lost,
+- a ring of result slots, a shard each.
+Workers map the corpus file themselves, so the puzzles are read straight from the page cache by
+every process and never copied between them. A worker solves its shard into the result slot for
+it, as a record per puzzle holding the status, solve time and board, and marks the slot ready. The
+coordinator writes slots out in shard order straight from shared memory and hands each slot on to
+the shard one lap of the ring later. The ring bounds how far ahead of the writer the workers get.
+
+Each slot's turn counter says whose it is: 2s while it waits for shard s to be solved into it,
+2s + 1 once shard s is there. All the counters are lock-free atomics, which work across
+processes.
+
+Each worker reads its hardware counters (SudokuPerfCounters) around the solving of a shard and
+leaves the counts in the shard's slot, so the run's statistics have the counters of every process.
+
+If a worker exits while holding a shard, its puzzles are reported as "error worker crashed" and a
+replacement is started while shards remain. Workers are started as program + arguments +
+"--shard-key <key> --shard-index <n> --input <file>", and the worker's end is runWorker().
+*/
+#include "sudokubatchpipeline.h"
+#include "sudokucancellation.h"
+#include "sudokusolver.h"
+#include <QString>
+#include <QStringList>
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+
+namespace puzzles
+{
+
+class SudokuShardedBatch
+{
+public:
+    // Special 6
+    //============================================================
+    // workerCount 0 means one per hardware thread
+    explicit SudokuShardedBatch(std::size_t workerCount = 0);
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // Solve every puzzle in the file, writing results to output. readerWaits counts the times a
+    // worker had to wait for a free result slot and writerWaits the times the coordinator had to
+    // wait for a shard. batches counts shards. Returns false, with errorString() saying why, if
+    // the file can't be mapped, is compressed, or the shared memory can't be created.
+    bool run(QString const& inputName, std::ostream& output, SudokuBatchStatistics& statistics,
+             SudokuCancellationToken const& cancellation = SudokuCancellationToken{});
+    QString errorString() const;
+
+    // Attach to the coordinator's segment as worker index and solve shards until there are none
+    // left. Returns the process exit code.
+    static int runWorker(QString const& key, std::size_t index, QString const& inputName);
+
+    std::size_t workerCount() const;
+
+    // How to start a worker process
+    void setWorkerCommand(QString const& program, QStringList const& arguments);
+    // Lines per shard, default 256
+    void setShardSize(std::size_t shardSize);
+    // Result slots per worker, default 4
+    void setSlotsPerWorker(std::size_t slots);
+    void setOptions(SudokuSolveOptions const& options);
+    // Time allowed for each puzzle; 0, the default, for no limit
+    void setTimeout(std::chrono::milliseconds timeout);
+    void setCacheLimit(std::size_t boxSize);
+
+private:
+    // Data Members
+    //============================================================
+    std::size_t m_workerCount;
+    QString m_program;
+    QStringList m_arguments;
+    std::size_t m_shardSize;
+    std::size_t m_slotsPerWorker;
+    SudokuSolveOptions m_options;
+    std::chrono::milliseconds m_timeout;
+    std::size_t m_cacheLimit;
+    QString m_errorString;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSHARDEDBATCH_H
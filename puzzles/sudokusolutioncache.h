@@ -0,0 +1,264 @@
+#ifndef SUDOKUSOLUTIONCACHE_H
+#define SUDOKUSOLUTIONCACHE_H
+/*
+class SudokuSolutionCache<N>
+====================================================================================================
+Sits in front of SudokuSolver<N> and remembers solutions by the canonical hash of the
+puzzle, so a puzzle that has been solved before - verbatim or as any symmetric variant - is
+answered by mapping the stored solution back through the inverse symmetry.
+
+Solutions are stored in canonical position. The table is split into shards, each with its own lock,
+so threads solving different puzzles rarely wait on each other. Attaching a SudokuSolutionStore
+loads the solutions already in it and appends every new one, so the cache survives restarts.
+
+Only boards played with the classic units are cached. The symmetries are classic ones, so they
+don't preserve diagonals, jigsaw regions or extra units, and the same givens can have a different
+solution on a variant board; variant boards go straight to SudokuSolver<N>.
+*/
+#include "sudokuboard.h"
+#include "sudokucanonicalform.h"
+#include "sudokusolutionstore.h"
+#include "sudokusolver.h"
+#include "sudokuvalidator.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace puzzles
+{
+
+template <std::size_t N>
+class SudokuSolutionCache
+{
+public:
+    // Typedefs
+    //============================================================
+    using value_array = std::array<std::size_t, N*N*N*N>;
+
+    // Special 6
+    //============================================================
+    SudokuSolutionCache() :
+        m_shards(),
+        m_store{ nullptr },
+        m_hits{ 0 },
+        m_misses{ 0 }
+    {}
+
+    // No copying
+    SudokuSolutionCache(SudokuSolutionCache const& other) = delete;
+    SudokuSolutionCache& operator=(SudokuSolutionCache const& other) = delete;
+
+    // Interface
+    //============================================================
+    // The cache the dialog and the command line modes share for this board size
+    static SudokuSolutionCache& shared()
+    {
+        static SudokuSolutionCache s_cache{};
+        return s_cache;
+    }
+
+    // Load the solutions for this board size from the store and append new ones to it. The store
+    // must outlive the cache or be detached by passing nullptr. Records that aren't a valid
+    // solution, say from a torn write or a file that isn't ours, are skipped.
+    void attachStore(SudokuSolutionStore* store)
+    {
+        m_store = store;
+        if (m_store == nullptr)
+            return;
+
+        m_store->visit([this](SudokuCanonicalHash hash, std::size_t boxSize, std::uint8_t const* values, std::size_t valueCount)
+        {
+            if (boxSize != N || valueCount != N*N*N*N
+                || SudokuValidator::checkSolution(values, nullptr, N) != SudokuValidity::Valid)
+                return;
+            solution_bytes solution{};
+            std::copy(values, values + valueCount, solution.begin());
+            Shard& shard = shardFor(hash);
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+            shard.solutions[hash] = solution;
+        });
+    }
+
+    // Solve the board, using the cache if the puzzle has been seen before and the engine picked
+    // by the options if not. Returns true if the board ends up solved.
+    bool solve(SudokuBoard<N>& board, SudokuSolveOptions const& options = SudokuSolveOptions{})
+    {
+        if (!board.unitTable().isClassic())
+            return SudokuSolver<N>{ options }.solve(board);
+
+        // One canonicaliser per thread so its buffers get reused
+        thread_local SudokuCanonicaliser<N> canonicaliser{};
+        SudokuCanonicalForm<N> const form{ canonicaliser.canonicalise(board) };
+
+        value_array solution{};
+        if (lookup(form, solution))
+        {
+            fill(board, solution);
+            return true;
+        }
+
+        SudokuSolver<N> solver{ options };
+        if (!solver.solve(board))
+            return false;
+        insert(form, board.getTileSolutions());
+        return true;
+    }
+
+    // Like SudokuSolver<N>::solveWithin(), answering from the cache where it can
+    SudokuSolveReport<N> solveWithin(SudokuBoard<N> const& puzzle,
+                                     SudokuSolveOptions const& options,
+                                     SudokuCancellationToken::clock_type::time_point deadline,
+                                     SudokuCancellationToken const& cancellation = SudokuCancellationToken{})
+    {
+        if (!puzzle.unitTable().isClassic())
+            return SudokuSolver<N>{ options }.solveWithin(puzzle, deadline, cancellation);
+
+        auto const start = SudokuCancellationToken::clock_type::now();
+        thread_local SudokuCanonicaliser<N> canonicaliser{};
+        SudokuCanonicalForm<N> const form{ canonicaliser.canonicalise(puzzle) };
+
+        value_array solution{};
+        if (lookup(form, solution))
+        {
+            SudokuSolveReport<N> report{};
+            report.status = SudokuSolveStatus::Solved;
+            report.board = puzzle;
+            fill(report.board, solution);
+            report.engine = SudokuSolver<N>::chooseEngine(options.engine);
+            report.time = SudokuCancellationToken::clock_type::now() - start;
+            report.cached = true;
+            return report;
+        }
+
+        SudokuSolveReport<N> report{ SudokuSolver<N>{ options }.solveWithin(puzzle, deadline, cancellation) };
+        if (report.status == SudokuSolveStatus::Solved)
+            insert(form, report.board.getTileSolutions());
+        report.time = SudokuCancellationToken::clock_type::now() - start;
+        return report;
+    }
+
+    // Find the solution for this puzzle, in the puzzle's own position. Counts a hit or a miss.
+    bool lookup(SudokuCanonicalForm<N> const& form, value_array& solution)
+    {
+        solution_bytes stored{};
+        {
+            Shard& shard = shardFor(form.hash());
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+            auto found = shard.solutions.find(form.hash());
+            if (found == shard.solutions.end())
+            {
+                ++m_misses;
+                return false;
+            }
+            stored = found->second;
+        }
+
+        value_array canonicalSolution{};
+        for (std::size_t index = 0; index != N*N*N*N; ++index)
+        {
+            // a hash collision would give a solution that disagrees with a clue, and a value out of
+            // range would run off the end of the inverse digit map
+            if ((form.values()[index] != 0 && form.values()[index] != stored[index]) || stored[index] == 0 || stored[index] > N*N)
+            {
+                ++m_misses;
+                return false;
+            }
+            canonicalSolution[index] = stored[index];
+        }
+        solution = form.symmetry().applyInverse(canonicalSolution);
+        ++m_hits;
+        return true;
+    }
+
+    // Remember the solution to this puzzle, given in the puzzle's own position
+    void insert(SudokuCanonicalForm<N> const& form, value_array const& solution)
+    {
+        value_array const canonicalSolution{ form.symmetry().apply(solution) };
+        solution_bytes stored{};
+        for (std::size_t index = 0; index != N*N*N*N; ++index)
+            stored[index] = static_cast<std::uint8_t>(canonicalSolution[index]);
+
+        {
+            Shard& shard = shardFor(form.hash());
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+            // only the first solution found is kept, and only it goes to the store
+            if (!shard.solutions.emplace(form.hash(), stored).second)
+                return;
+        }
+        if (m_store)
+            m_store->append(form.hash(), N, stored.data(), stored.size());
+    }
+
+    // Statistics
+    std::uint64_t hits() const      { return m_hits; }
+    std::uint64_t misses() const    { return m_misses; }
+    std::size_t size() const
+    {
+        std::size_t result{ 0 };
+        for (auto& shard : m_shards)
+        {
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+            result += shard.solutions.size();
+        }
+        return result;
+    }
+    void resetStatistics()
+    {
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+    void clear()
+    {
+        for (auto& shard : m_shards)
+        {
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+            shard.solutions.clear();
+        }
+        resetStatistics();
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    using solution_bytes = std::array<std::uint8_t, N*N*N*N>;
+
+    struct HashHasher
+    {
+        std::size_t operator()(SudokuCanonicalHash hash) const { return static_cast<std::size_t>(hash.low); }
+    };
+
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        std::unordered_map<SudokuCanonicalHash, solution_bytes, HashHasher> solutions;
+    };
+
+    // Helpers
+    //============================================================
+    // The high half picks the shard so the low half is left for the table inside it
+    Shard& shardFor(SudokuCanonicalHash hash)
+    {
+        return m_shards[static_cast<std::size_t>(hash.high % m_shards.size())];
+    }
+
+    // Put a cached solution on the board, keeping the board's own settings and units
+    static void fill(SudokuBoard<N>& board, value_array const& solution)
+    {
+        for (std::size_t tile = 0; tile != N*N*N*N; ++tile)
+            board.setTileSolution(tile / (N*N), tile % (N*N), solution[tile]);
+    }
+
+    // Data Members
+    //============================================================
+    std::array<Shard, 16> m_shards;
+    SudokuSolutionStore* m_store;
+    std::atomic<std::uint64_t> m_hits;
+    std::atomic<std::uint64_t> m_misses;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSOLUTIONCACHE_H
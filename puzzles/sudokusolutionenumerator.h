@@ -0,0 +1,349 @@
+#ifndef SUDOKUSOLUTIONENUMERATOR_H
+#define SUDOKUSOLUTIONENUMERATOR_H
+/*
+class SudokuSolutionEnumerator<N>
+====================================================================================================
+Walks every solution of a puzzle one at a time, for puzzles with too many solutions to keep. The
+search that SudokuBoard<N>::solveAll() does recursively is kept here as an explicit stack of
+guesses, each with the board's undo checkpoint for it, so it can stop at a solution and carry on
+from the same place on the next call to next(). Nothing is allocated per solution.
+
+Each solution is handed out as a View of the enumerator's own board, valid until the next call to
+next(); copy the values out of it to keep them. The enumerator also works as a range:
+
+    SudokuSolutionEnumerator<3> solutions{ puzzle };
+    for (auto const& solution : solutions)
+        use(solution.getTileSolution(0, 0));
+
+split() divides a puzzle's search into disjoint parts by expanding the first few guesses, so the
+parts can be enumerated on different threads and between them give every solution exactly once.
+enumerateParallel() does that over a pool of threads.
+*/
+#include "sudokuboard.h"
+#include "sudokubits.h"
+#include "sudokucancellation.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace puzzles
+{
+
+template <std::size_t N>
+class SudokuSolutionEnumerator
+{
+public:
+    // Typedefs
+    //============================================================
+    using mask_type = typename SudokuBoard<N>::mask_type;
+
+    // A solution, looked at in place
+    class View
+    {
+    public:
+        explicit View(SudokuBoard<N> const& board) :
+            m_board(&board)
+        {}
+
+        std::size_t getTileSolution(std::size_t xPosition, std::size_t yPosition) const
+        {
+            return m_board->getTileSolution(xPosition, yPosition);
+        }
+        // Row-major, as SudokuBoard<N>::getTileSolutions() orders them
+        std::size_t operator[](std::size_t index) const
+        {
+            return m_board->getTileSolution(index / (N*N), index % (N*N));
+        }
+        SudokuBoard<N> const& board() const
+        {
+            return *m_board;
+        }
+
+    private:
+        SudokuBoard<N> const* m_board;
+    };
+
+    // Input iterator over the solutions; advancing it advances the enumerator
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = View;
+        using difference_type = std::ptrdiff_t;
+        using pointer = View const*;
+        using reference = View const&;
+
+        explicit Iterator(SudokuSolutionEnumerator* enumerator) :
+            m_enumerator(enumerator)
+        {}
+
+        reference operator*() const     { return m_enumerator->view(); }
+        pointer operator->() const      { return &m_enumerator->view(); }
+        Iterator& operator++()
+        {
+            if (!m_enumerator->next())
+                m_enumerator = nullptr;
+            return *this;
+        }
+        bool operator==(Iterator const& other) const { return m_enumerator == other.m_enumerator; }
+        bool operator!=(Iterator const& other) const { return m_enumerator != other.m_enumerator; }
+
+    private:
+        SudokuSolutionEnumerator* m_enumerator;
+    };
+
+    // Special 6
+    //============================================================
+    // The token, if given, must outlive the enumerator; a cancelled enumeration just ends.
+    explicit SudokuSolutionEnumerator(SudokuBoard<N> const& puzzle,
+                                      SudokuCancellationToken const* cancellation = nullptr) :
+        m_board(puzzle),
+        m_view(m_board),
+        m_stack(),
+        m_cancellation(cancellation),
+        m_started(false),
+        m_finished(false),
+        m_solutions(0),
+        m_nodes(0)
+    {}
+
+    // No copying: views point into the board
+    SudokuSolutionEnumerator(SudokuSolutionEnumerator const& other) = delete;
+    SudokuSolutionEnumerator& operator=(SudokuSolutionEnumerator const& other) = delete;
+
+    // Interface
+    //============================================================
+    // Move to the next solution. Returns false once there are no more or the token is cancelled.
+    bool next()
+    {
+        if (m_finished)
+            return false;
+
+        bool found{ false };
+        if (!m_started)
+        {
+            m_started = true;
+            found = m_board.propagateAll();
+        }
+        else
+        {
+            found = nextGuess();
+        }
+
+        // Keep guessing at the tile with the fewest candidates until the board is solved
+        while (found && !m_board.isSolved())
+        {
+            std::size_t xBest{ 0 }, yBest{ 0 };
+            mask_type const candidates{ fewestCandidates(m_board, xBest, yBest) };
+            m_stack.push_back(Frame{ xBest, yBest, candidates, false });
+            found = nextGuess();
+        }
+
+        if (!found)
+        {
+            m_finished = true;
+            return false;
+        }
+        ++m_solutions;
+        return true;
+    }
+
+    // The current solution, valid after next() has returned true and until it is called again
+    View const& view() const
+    {
+        return m_view;
+    }
+
+    Iterator begin()
+    {
+        Iterator result{ this };
+        return ++result;
+    }
+    Iterator end()
+    {
+        return Iterator{ nullptr };
+    }
+
+    bool isFinished() const
+    {
+        return m_finished;
+    }
+    // Solutions handed out so far
+    std::uint64_t solutionCount() const
+    {
+        return m_solutions;
+    }
+    // Guesses made so far
+    std::uint64_t nodeCount() const
+    {
+        return m_nodes;
+    }
+
+    // Divide the search into at least this many disjoint parts where there are that many, by
+    // trying every candidate of the tile with the fewest on the earliest unsolved part until there
+    // are enough. Parts that propagation shows have no solution are dropped.
+    static std::vector<SudokuBoard<N>> split(SudokuBoard<N> const& puzzle, std::size_t parts)
+    {
+        std::vector<SudokuBoard<N>> result{};
+        std::deque<SudokuBoard<N>> open{};
+        open.push_back(puzzle);
+        if (!open.back().propagateAll())
+            return result;
+
+        while (!open.empty() && result.size() + open.size() < parts)
+        {
+            SudokuBoard<N> board{ std::move(open.front()) };
+            open.pop_front();
+            if (board.isSolved())
+            {
+                result.push_back(std::move(board));
+                continue;
+            }
+
+            std::size_t xBest{ 0 }, yBest{ 0 };
+            for (mask_type remaining = fewestCandidates(board, xBest, yBest); remaining != 0; remaining &= static_cast<mask_type>(remaining - 1))
+            {
+                mask_type const guess{ static_cast<mask_type>(remaining & (~remaining + 1)) };
+                SudokuBoard<N> child{ board };
+                child.eliminateTileCandidates(xBest, yBest, static_cast<mask_type>(~guess));
+                if (child.propagateAll())
+                    open.push_back(std::move(child));
+            }
+        }
+        std::move(open.begin(), open.end(), std::back_inserter(result));
+        return result;
+    }
+
+    // Enumerate every solution on this many threads (0 for one per hardware thread), calling the
+    // visitor with each from whichever thread found it. The visitor returns false to stop the
+    // whole enumeration. Returns how many solutions were visited.
+    static std::uint64_t enumerateParallel(SudokuBoard<N> const& puzzle, std::size_t threadCount,
+                                           std::function<bool(View const&)> const& visitor,
+                                           SudokuCancellationToken const& cancellation = SudokuCancellationToken{})
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        // Several parts per thread so that threads given small parts pick up more
+        std::vector<SudokuBoard<N>> const parts{ split(puzzle, threadCount * 8) };
+        SudokuCancellationToken const stop{ SudokuCancellationToken::linkedTo(cancellation) };
+        std::atomic<std::size_t> nextPart{ 0 };
+        std::atomic<std::uint64_t> visited{ 0 };
+
+        auto const work = [&parts, &stop, &nextPart, &visited, &visitor]()
+        {
+            for (std::size_t part = nextPart++; part < parts.size() && !stop.shouldStop(); part = nextPart++)
+            {
+                SudokuSolutionEnumerator enumerator{ parts[part], &stop };
+                while (enumerator.next())
+                {
+                    ++visited;
+                    if (!visitor(enumerator.view()))
+                    {
+                        stop.cancel();
+                        break;
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads{};
+        for (std::size_t index = 1; index < std::min(threadCount, parts.size()); ++index)
+            threads.emplace_back(work);
+        work();
+        for (auto& thread : threads)
+            thread.join();
+        return visited;
+    }
+
+private:
+    // Typedefs
+    //============================================================
+    // A guessed tile, the candidates not yet tried there, and whether a guess is in place
+    struct Frame
+    {
+        std::size_t xPosition;
+        std::size_t yPosition;
+        mask_type remaining;
+        bool guessing;
+    };
+
+    // Helpers
+    //============================================================
+    // The unsolved tile with the fewest candidates, and those candidates
+    static mask_type fewestCandidates(SudokuBoard<N> const& board, std::size_t& xBest, std::size_t& yBest)
+    {
+        mask_type best{ 0 };
+        std::size_t bestCount{ N*N + 1 };
+        for (std::size_t xPosition = 0; xPosition != N*N && bestCount != 2; ++xPosition)
+        {
+            for (std::size_t yPosition = 0; yPosition != N*N && bestCount != 2; ++yPosition)
+            {
+                mask_type const candidates{ board.getTileCandidates(xPosition, yPosition) };
+                std::size_t const count{ popCount(candidates) };
+                if (count > 1 && count < bestCount)
+                {
+                    xBest = xPosition;
+                    yBest = yPosition;
+                    best = candidates;
+                    bestCount = count;
+                }
+            }
+        }
+        return best;
+    }
+
+    // Undo the newest guess and try the next candidate there, going back up the stack as guesses
+    // run out. Returns false once every guess has been tried.
+    bool nextGuess()
+    {
+        while (!m_stack.empty())
+        {
+            if (m_cancellation != nullptr && m_cancellation->shouldStop())
+                return false;
+
+            Frame& frame = m_stack.back();
+            if (frame.guessing)
+            {
+                m_board.rollback();
+                frame.guessing = false;
+            }
+            if (frame.remaining == 0)
+            {
+                m_stack.pop_back();
+                continue;
+            }
+
+            mask_type const guess{ static_cast<mask_type>(frame.remaining & (~frame.remaining + 1)) };
+            frame.remaining &= static_cast<mask_type>(~guess);
+            ++m_nodes;
+            m_board.checkpoint();
+            frame.guessing = true;
+            m_board.eliminateTileCandidates(frame.xPosition, frame.yPosition, static_cast<mask_type>(~guess));
+            if (m_board.propagateAll())
+                return true;
+        }
+        return false;
+    }
+
+    // Data Members
+    //============================================================
+    SudokuBoard<N> m_board;
+    View m_view;
+    std::vector<Frame> m_stack;
+    SudokuCancellationToken const* m_cancellation;
+    bool m_started;
+    bool m_finished;
+    std::uint64_t m_solutions;
+    std::uint64_t m_nodes;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSOLUTIONENUMERATOR_H
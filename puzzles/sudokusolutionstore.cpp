@@ -0,0 +1,254 @@
+#include "sudokusolutionstore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QStandardPaths>
+#include <QString>
+
+#include <cstring>
+
+namespace
+{
+    // File layout constants
+    //============================================================
+    std::uint32_t const c_magic{ 0x534B4453 }; // "SDKS"
+    std::uint32_t const c_version{ 1 };
+    std::size_t const c_initialSize{ 64 * 1024 };
+
+    struct StoreHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t usedBytes;
+    };
+
+    struct RecordHeader
+    {
+        std::uint64_t hashHigh;
+        std::uint64_t hashLow;
+        std::uint32_t boxSize;
+        std::uint32_t valueCount;
+    };
+
+    // A record header that a board could have written: a box size from 2 to 8 and one value per tile
+    bool isRecordShape(RecordHeader const& record)
+    {
+        std::uint64_t const tiles{ static_cast<std::uint64_t>(record.boxSize) * record.boxSize * record.boxSize * record.boxSize };
+        return record.boxSize >= 2 && record.boxSize <= 8 && record.valueCount == tiles;
+    }
+
+    // Records are padded so the next header stays 8 byte aligned
+    std::size_t recordSize(std::size_t valueCount)
+    {
+        return (sizeof(RecordHeader) + valueCount + 7) / 8 * 8;
+    }
+
+    StoreHeader* header(unsigned char* mapping)
+    {
+        return reinterpret_cast<StoreHeader*>(mapping);
+    }
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuSolutionStore::SudokuSolutionStore() :
+    m_mutex(),
+    m_lock(),
+    m_file(),
+    m_mapping{ nullptr },
+    m_mappedSize{ 0 },
+    m_recordCount{ 0 },
+    m_errorString()
+{}
+
+puzzles::SudokuSolutionStore::~SudokuSolutionStore()
+{
+    close();
+}
+
+// Interface
+//============================================================
+// The store in the user's cache directory
+std::string puzzles::SudokuSolutionStore::defaultFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation).toStdString()
+           + "/sudoku_solver/solutions.store";
+}
+
+// Open or create the store at this path, and the directories it goes in. Returns false if
+// another process has it open, or the file can't be opened, mapped or isn't a store.
+bool puzzles::SudokuSolutionStore::open(std::string const& filePath)
+{
+    close();
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    QString const path{ QString::fromStdString(filePath) };
+    if (!QDir{}.mkpath(QFileInfo{ path }.absolutePath()))
+        return fail("cannot create the directory for it");
+
+    // The lock is held for as long as the store is open, so it never goes stale by age; one left
+    // by a process that has died is taken over
+    m_lock.reset(new QLockFile(path + QStringLiteral(".lock")));
+    m_lock->setStaleLockTime(0);
+    if (!m_lock->tryLock())
+        return fail(m_lock->error() == QLockFile::LockFailedError ? "another process has it open" : "cannot create its lock file");
+
+    m_file.reset(new QFile(path));
+    if (!m_file->open(QIODevice::ReadWrite))
+        return fail(m_file->errorString().toStdString());
+
+    // A new file gets a header and some room to grow
+    bool const isNew{ m_file->size() == 0 };
+    if (isNew && !m_file->resize(static_cast<qint64>(c_initialSize)))
+        return fail(m_file->errorString().toStdString());
+    if (static_cast<std::size_t>(m_file->size()) < sizeof(StoreHeader))
+        return fail("not a solution store");
+    if (!mapFile())
+        return fail(m_file->errorString().toStdString());
+    if (isNew)
+    {
+        header(m_mapping)->magic = c_magic;
+        header(m_mapping)->version = c_version;
+        header(m_mapping)->usedBytes = sizeof(StoreHeader);
+    }
+    else if (header(m_mapping)->magic != c_magic || header(m_mapping)->version != c_version
+             || header(m_mapping)->usedBytes > m_mappedSize)
+        return fail("not a solution store");
+
+    // Count what is already there, dropping everything from the first record that runs off the end
+    // of the used space or has a header no board could have written, since what follows it can't
+    // be found
+    m_recordCount = 0;
+    std::size_t offset{ sizeof(StoreHeader) };
+    for (std::size_t end = header(m_mapping)->usedBytes; offset + sizeof(RecordHeader) <= end; ++m_recordCount)
+    {
+        RecordHeader const* record{ reinterpret_cast<RecordHeader const*>(m_mapping + offset) };
+        if (!isRecordShape(*record) || offset + recordSize(record->valueCount) > end)
+            break;
+        offset += recordSize(record->valueCount);
+    }
+    header(m_mapping)->usedBytes = offset;
+    m_errorString.clear();
+    return true;
+}
+
+void puzzles::SudokuSolutionStore::close()
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    if (m_file)
+    {
+        if (m_mapping)
+            m_file->unmap(m_mapping);
+        m_file->close();
+    }
+    m_file.reset();
+    m_lock.reset();
+    m_mapping = nullptr;
+    m_mappedSize = 0;
+    m_recordCount = 0;
+}
+
+bool puzzles::SudokuSolutionStore::isOpen() const
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_mapping != nullptr;
+}
+
+// Add a record. Returns false if the store isn't open or the file couldn't grow.
+bool puzzles::SudokuSolutionStore::append(SudokuCanonicalHash hash, std::size_t boxSize, std::uint8_t const* values, std::size_t valueCount)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    if (m_mapping == nullptr || !reserve(recordSize(valueCount)))
+        return false;
+
+    // Write the record past the end of the used space...
+    std::size_t const offset{ static_cast<std::size_t>(header(m_mapping)->usedBytes) };
+    RecordHeader record{ hash.high, hash.low, static_cast<std::uint32_t>(boxSize), static_cast<std::uint32_t>(valueCount) };
+    std::memcpy(m_mapping + offset, &record, sizeof(RecordHeader));
+    std::memcpy(m_mapping + offset + sizeof(RecordHeader), values, valueCount);
+
+    // ...then commit it
+    header(m_mapping)->usedBytes = offset + recordSize(valueCount);
+    ++m_recordCount;
+    return true;
+}
+
+// Call the visitor for each record in the order they were added
+void puzzles::SudokuSolutionStore::visit(RecordVisitor const& visitor) const
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    if (m_mapping == nullptr)
+        return;
+
+    for (std::size_t offset = sizeof(StoreHeader), end = header(m_mapping)->usedBytes; offset < end; )
+    {
+        RecordHeader const* record{ reinterpret_cast<RecordHeader const*>(m_mapping + offset) };
+        visitor(SudokuCanonicalHash{ record->hashHigh, record->hashLow },
+                record->boxSize,
+                m_mapping + offset + sizeof(RecordHeader),
+                record->valueCount);
+        offset += recordSize(record->valueCount);
+    }
+}
+
+// Number of records in the file
+std::size_t puzzles::SudokuSolutionStore::recordCount() const
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_recordCount;
+}
+
+// Why open() last failed
+std::string puzzles::SudokuSolutionStore::errorString() const
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_errorString;
+}
+
+// Helpers
+//============================================================
+// Give up opening the store, saying why
+bool puzzles::SudokuSolutionStore::fail(std::string const& reason)
+{
+    if (m_mapping)
+        m_file->unmap(m_mapping);
+    m_mapping = nullptr;
+    m_mappedSize = 0;
+    m_file.reset();
+    m_lock.reset();
+    m_errorString = reason;
+    return false;
+}
+
+// Map the whole file, which must be at least header sized
+bool puzzles::SudokuSolutionStore::mapFile()
+{
+    m_mappedSize = static_cast<std::size_t>(m_file->size());
+    m_mapping = m_file->map(0, static_cast<qint64>(m_mappedSize));
+    return m_mapping != nullptr;
+}
+
+// Grow the file so that it has room for this many more bytes
+bool puzzles::SudokuSolutionStore::reserve(std::size_t extraBytes)
+{
+    std::size_t const needed{ static_cast<std::size_t>(header(m_mapping)->usedBytes) + extraBytes };
+    if (needed <= m_mappedSize)
+        return true;
+
+    std::size_t newSize{ m_mappedSize * 2 };
+    while (newSize < needed)
+        newSize *= 2;
+
+    // The mapping has to be dropped while the file is resized
+    m_file->unmap(m_mapping);
+    m_mapping = nullptr;
+    if (!m_file->resize(static_cast<qint64>(newSize)))
+    {
+        // put the old mapping back so the store stays usable
+        mapFile();
+        return false;
+    }
+    return mapFile();
+}
@@ -0,0 +1,101 @@
+#ifndef SUDOKUSOLUTIONSTORE_H
+#define SUDOKUSOLUTIONSTORE_H
+/*
+class SudokuSolutionStore
+====================================================================================================
+Append-only file of solved puzzles keyed by canonical hash, so SudokuSolutionCache<N> can survive
+restarts. The file is memory-mapped: records are written straight into the mapping and the file
+doubles in size whenever it runs out of room. Boards of every size share the one file; each record
+says what box size it is for.
+
+File layout (native byte order):
+    header:  magic, version, bytes used (including the header)
+    records: hash high, hash low, box size, value count, values (one byte each), padding to 8 bytes
+
+A record only counts once the header's used size has been moved past it, so a process that dies
+part way through an append leaves the file as it was before the append started. That only covers
+the process: nothing syncs the mapping to disk, so records the kernel hadn't written back yet can
+be lost or torn if the machine goes down. open() drops everything from the first record whose box
+size and value count don't match, and SudokuSolutionCache<N> skips records that aren't solutions.
+
+The mapping is only safe for one process at a time, so open() takes a lock file next to the store
+and fails while another process has it open. The dialog and the command line modes all default to
+defaultFilePath(); whichever opens it first keeps it, and the others run without one.
+*/
+#include "sudokucanonicalform.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Forward Declarations
+class QFile;
+class QLockFile;
+
+namespace puzzles
+{
+
+class SudokuSolutionStore
+{
+public:
+    // Typedefs
+    //============================================================
+    using RecordVisitor = std::function<void(SudokuCanonicalHash hash, std::size_t boxSize, std::uint8_t const* values, std::size_t valueCount)>;
+
+    // Special 6
+    //============================================================
+    SudokuSolutionStore();
+    ~SudokuSolutionStore();
+
+    // No copying
+    SudokuSolutionStore(SudokuSolutionStore const& other) = delete;
+    SudokuSolutionStore& operator=(SudokuSolutionStore const& other) = delete;
+
+    // Interface
+    //============================================================
+    // The store in the user's cache directory
+    static std::string defaultFilePath();
+
+    // Open or create the store at this path, and the directories it goes in. Returns false if
+    // another process has it open, or the file can't be opened, mapped or isn't a store.
+    bool open(std::string const& filePath);
+    void close();
+    bool isOpen() const;
+
+    // Add a record. Returns false if the store isn't open or the file couldn't grow.
+    bool append(SudokuCanonicalHash hash, std::size_t boxSize, std::uint8_t const* values, std::size_t valueCount);
+
+    // Call the visitor for each record in the order they were added
+    void visit(RecordVisitor const& visitor) const;
+
+    // Number of records in the file
+    std::size_t recordCount() const;
+
+    // Why open() last failed
+    std::string errorString() const;
+
+private:
+    // Helpers
+    //============================================================
+    // Give up opening the store, saying why
+    bool fail(std::string const& reason);
+    // Map the whole file, which must be at least header sized
+    bool mapFile();
+    // Grow the file so that it has room for this many more bytes
+    bool reserve(std::size_t extraBytes);
+
+    // Data Members
+    //============================================================
+    mutable std::mutex m_mutex;
+    std::unique_ptr<QLockFile> m_lock;
+    std::unique_ptr<QFile> m_file;
+    unsigned char* m_mapping;
+    std::size_t m_mappedSize;
+    std::size_t m_recordCount;
+    std::string m_errorString;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSOLUTIONSTORE_H
@@ -0,0 +1,303 @@
+#ifndef SUDOKUSOLVER_H
+#define SUDOKUSOLVER_H
+/*
+enum class SudokuEngine
+====================================================================================================
+The ways a board can be solved.
+
+Automatic       Bitboard for 9x9 boards, Propagation up to 16x16, Sat for anything larger.
+Propagation     SudokuBoard<N>::solveAll(): propagation and the strategies, then backtracking.
+Sat             SudokuSatEngine<N>: propagation, then clause learning search.
+Bitboard        SudokuBandBoard: singles and locked candidates over per-digit bitboards, then
+                backtracking. 9x9 only, other sizes run Propagation instead. Ignores the seed.
+LocalSearch     SudokuLocalSearch<N>: simulated annealing, then the exact engines from the best
+                state it reached if it doesn't find a solution. Never picked by Automatic; it is
+                for large sparse boards. Runs its restarts on the calling thread only, since the
+                batch modes and the service already solve a puzzle per thread.
+
+Propagation and Sat follow the board's SudokuUnitTable<N>. Bitboard and LocalSearch only know rows,
+columns and squares, so a board with any other units (jigsaw, Sudoku X, windoku) runs Propagation
+instead.
+
+struct SudokuSolveOptions
+====================================================================================================
+Settings for a single solve. SudokuSolveOptions{} picks Automatic with seed 0.
+
+engine          Which engine to run.
+seed            0 for each engine's default branching order, anything else for a pseudo-random
+                one. Solves with different seeds take different paths to the same answer.
+
+enum class SudokuSolveStatus
+====================================================================================================
+How a bounded solve ended.
+
+Solved          The board is solved.
+Unsolvable      The puzzle has been shown to have no solution.
+TimedOut        The deadline passed first.
+Cancelled       The cancellation token was cancelled first.
+
+struct SudokuSolveReport<N>
+====================================================================================================
+The outcome of SudokuSolver<N>::solveWithin(): the status, the board as far as the engine got (the
+solution, or the propagated board with any guesses undone), the engine that ran, its statistics
+and the wall time taken. cached is set if the answer came from a SudokuSolutionCache<N> instead,
+in which case the statistics are empty.
+
+class SudokuSolver<N>
+====================================================================================================
+Solves a board with the engine picked by its options and keeps the statistics of whichever engine
+ran, so callers can send large or hard puzzles to a different engine one solve at a time.
+
+solveWithin() bounds a solve by a deadline and a cancellation token, both checked at the engines'
+propagation and branch points, so a request handler with a time budget per puzzle gets its answer
+or a TimedOut report shortly after the budget runs out.
+*/
+#include "sudokubandboard.h"
+#include "sudokuboard.h"
+#include "sudokucancellation.h"
+#include "sudokulocalsearch.h"
+#include "sudokusatengine.h"
+#include "sudokusatsolver.h"
+#include "sudokusearchstatistics.h"
+#include <chrono>
+#include <cstdint>
+
+namespace puzzles
+{
+
+enum class SudokuEngine
+{
+    Automatic,
+    Propagation,
+    Sat,
+    Bitboard,
+    LocalSearch
+};
+
+struct SudokuSolveOptions
+{
+    SudokuEngine engine;
+    std::uint64_t seed;
+};
+
+enum class SudokuSolveStatus
+{
+    Solved,
+    Unsolvable,
+    TimedOut,
+    Cancelled
+};
+
+template <std::size_t N>
+struct SudokuSolveReport
+{
+    SudokuSolveStatus status;
+    SudokuBoard<N> board;
+    SudokuEngine engine;
+    SudokuSearchStatistics searchStatistics;
+    SudokuSatStatistics satStatistics;
+    SudokuLocalSearchStatistics localSearchStatistics;
+    std::chrono::nanoseconds time;
+    bool cached;
+};
+
+template <std::size_t N>
+class SudokuSolver
+{
+public:
+    // Special 6
+    //============================================================
+    explicit SudokuSolver(SudokuSolveOptions const& options = SudokuSolveOptions{}) :
+        m_options(options),
+        m_engine{ SudokuEngine::Automatic },
+        m_searchStatistics{},
+        m_satStatistics{},
+        m_localSearchStatistics{}
+    {}
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // Solve the board. Returns true if it ends up solved.
+    bool solve(SudokuBoard<N>& board)
+    {
+        return solve(board, SudokuCancellationToken{});
+    }
+    // Stopping early if the token is cancelled
+    bool solve(SudokuBoard<N>& board, SudokuCancellationToken const& cancellation)
+    {
+        m_engine = chooseEngine(m_options.engine);
+        if (!board.unitTable().isClassic() && (m_engine == SudokuEngine::Bitboard || m_engine == SudokuEngine::LocalSearch))
+            m_engine = SudokuEngine::Propagation;
+        m_searchStatistics = SudokuSearchStatistics{};
+        m_satStatistics = SudokuSatStatistics{};
+        m_localSearchStatistics = SudokuLocalSearchStatistics{};
+
+        switch (m_engine)
+        {
+        case SudokuEngine::Sat:
+        {
+            SudokuSatEngine<N> engine{};
+            engine.setSeed(m_options.seed);
+            engine.solve(board, cancellation);
+            m_satStatistics = engine.statistics();
+            break;
+        }
+        case SudokuEngine::Bitboard:
+            solveWithBands(board, cancellation);
+            break;
+        case SudokuEngine::LocalSearch:
+        {
+            SudokuLocalSearch<N> engine{ 1 };
+            engine.setSeed(m_options.seed);
+            engine.solve(board, cancellation);
+            m_localSearchStatistics = engine.statistics();
+            break;
+        }
+        default:
+        {
+            std::uint64_t const seed{ board.searchSeed() };
+            board.setSearchSeed(m_options.seed);
+            board.solveAll(cancellation);
+            board.setSearchSeed(seed);
+            m_searchStatistics = board.searchStatistics();
+            break;
+        }
+        }
+        return board.isSolved();
+    }
+
+    // Solve a copy of the puzzle, stopping at the deadline or when the token is cancelled
+    SudokuSolveReport<N> solveWithin(SudokuBoard<N> const& puzzle,
+                                     SudokuCancellationToken::clock_type::time_point deadline,
+                                     SudokuCancellationToken const& cancellation = SudokuCancellationToken{})
+    {
+        auto const start = SudokuCancellationToken::clock_type::now();
+        SudokuCancellationToken const bounded{ SudokuCancellationToken::linkedTo(cancellation, deadline) };
+
+        SudokuSolveReport<N> report{};
+        report.board = puzzle;
+        solve(report.board, bounded);
+
+        report.status = statusOf(report.board, bounded);
+        report.engine = m_engine;
+        report.searchStatistics = m_searchStatistics;
+        report.satStatistics = m_satStatistics;
+        report.localSearchStatistics = m_localSearchStatistics;
+        report.time = SudokuCancellationToken::clock_type::now() - start;
+        return report;
+    }
+    // Or within this long from now
+    SudokuSolveReport<N> solveWithin(SudokuBoard<N> const& puzzle,
+                                     std::chrono::nanoseconds budget,
+                                     SudokuCancellationToken const& cancellation = SudokuCancellationToken{})
+    {
+        return solveWithin(puzzle, SudokuCancellationToken::clock_type::now() + budget, cancellation);
+    }
+
+    // Why a solve with this token left the board as it is. An engine that finished just as the
+    // token stopped is reported as stopped, never as Unsolvable.
+    static SudokuSolveStatus statusOf(SudokuBoard<N> const& board, SudokuCancellationToken const& cancellation)
+    {
+        if (board.isSolved())
+            return SudokuSolveStatus::Solved;
+        if (cancellation.isCancelled())
+            return SudokuSolveStatus::Cancelled;
+        if (cancellation.hasExpired())
+            return SudokuSolveStatus::TimedOut;
+        return SudokuSolveStatus::Unsolvable;
+    }
+
+    SudokuSolveOptions const& options() const
+    {
+        return m_options;
+    }
+    void setOptions(SudokuSolveOptions const& options)
+    {
+        m_options = options;
+    }
+
+    // The engine the last solve() used, never Automatic once solve() has run
+    SudokuEngine engine() const
+    {
+        return m_engine;
+    }
+
+    // Counters from the last solve(), only those of the engine that ran are filled in
+    SudokuSearchStatistics const& searchStatistics() const
+    {
+        return m_searchStatistics;
+    }
+    SudokuSatStatistics const& satStatistics() const
+    {
+        return m_satStatistics;
+    }
+    SudokuLocalSearchStatistics const& localSearchStatistics() const
+    {
+        return m_localSearchStatistics;
+    }
+
+    // What Automatic means for this board size, on a classic board
+    static SudokuEngine chooseEngine(SudokuEngine engine)
+    {
+        if (engine == SudokuEngine::Bitboard && N != 3)
+            return SudokuEngine::Propagation;
+        if (engine != SudokuEngine::Automatic)
+            return engine;
+        return N == 3 ? SudokuEngine::Bitboard : N >= 5 ? SudokuEngine::Sat : SudokuEngine::Propagation;
+    }
+
+    static char const* name(SudokuEngine engine)
+    {
+        switch (engine)
+        {
+        case SudokuEngine::Automatic:   return "Automatic";
+        case SudokuEngine::Propagation: return "Propagation";
+        case SudokuEngine::Sat:         return "SAT";
+        case SudokuEngine::Bitboard:    return "Bitboard";
+        case SudokuEngine::LocalSearch: return "Local Search";
+        default:                        return "Unknown";
+        }
+    }
+    static char const* name(SudokuSolveStatus status)
+    {
+        switch (status)
+        {
+        case SudokuSolveStatus::Solved:     return "Solved";
+        case SudokuSolveStatus::Unsolvable: return "Unsolvable";
+        case SudokuSolveStatus::TimedOut:   return "Timed Out";
+        case SudokuSolveStatus::Cancelled:  return "Cancelled";
+        default:                            return "Unknown";
+        }
+    }
+
+private:
+    // Helpers
+    //============================================================
+    // The board is only written if the bitboard solves it, so a failed solve leaves the puzzle as
+    // it was given rather than half propagated
+    void solveWithBands(SudokuBoard<3>& board, SudokuCancellationToken const& cancellation)
+    {
+        SudokuBandBoard bands{ board };
+        if (bands.solveAll(cancellation))
+            bands.writeSolutions(board);
+        m_searchStatistics = bands.searchStatistics();
+    }
+    // Never called: chooseEngine() only picks Bitboard for 9x9
+    template <typename Board>
+    void solveWithBands(Board&, SudokuCancellationToken const&)
+    {}
+
+    // Data Members
+    //============================================================
+    SudokuSolveOptions m_options;
+    SudokuEngine m_engine;
+    SudokuSearchStatistics m_searchStatistics;
+    SudokuSatStatistics m_satStatistics;
+    SudokuLocalSearchStatistics m_localSearchStatistics;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSOLVER_H
@@ -2,11 +2,14 @@
 
 #include "sudokuboardwidgetbase.h"
 #include "sudokuboardwidget.h"
+#include "sudokusolutioncache.h"
+#include "sudokusolutionstore.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QComboBox>
 #include <QPushButton>
+#include <QLabel>
 
 // Special 6
 //============================================================
@@ -18,17 +21,34 @@ puzzles::SudokuSolverDialog::SudokuSolverDialog(QWidget *parent) :
     m_clearButton{new QPushButton("Clear", this)},
     m_resetButton{new QPushButton("Reset", this)},
     m_solveButton{new QPushButton("Solve", this)},
+    m_hintButton{new QPushButton("Hint", this)},
+    m_messageLabel{new QLabel(this)},
     m_interfaceEndSpacer{new QSpacerItem(1,1,QSizePolicy::Minimum, QSizePolicy::Expanding)},
-    m_board(nullptr)
+    m_board(nullptr),
+    m_store{new SudokuSolutionStore}
 {
     m_mainLayout->addLayout(m_interfaceLayout);
     m_interfaceLayout->addWidget(m_comboBox);
     m_interfaceLayout->addWidget(m_clearButton);
     m_interfaceLayout->addWidget(m_resetButton);
     m_interfaceLayout->addWidget(m_solveButton);
+    m_interfaceLayout->addWidget(m_hintButton);
+    m_interfaceLayout->addWidget(m_messageLabel);
     m_interfaceLayout->addSpacerItem(m_interfaceEndSpacer);
     setLayout(m_mainLayout);
 
+    // messages are a sentence or two, so wrap them rather than widen the buttons
+    m_messageLabel->setWordWrap(true);
+    m_messageLabel->setFixedWidth(160);
+
+    // keep solutions between runs where the store can be had
+    if (m_store->open(SudokuSolutionStore::defaultFilePath()))
+    {
+        SudokuSolutionCache<2>::shared().attachStore(m_store.get());
+        SudokuSolutionCache<3>::shared().attachStore(m_store.get());
+        SudokuSolutionCache<4>::shared().attachStore(m_store.get());
+    }
+
     // make the solve button the default button
     m_solveButton->setDefault(true);
 
@@ -48,7 +68,15 @@ puzzles::SudokuSolverDialog::SudokuSolverDialog(QWidget *parent) :
     m_comboBox->setCurrentIndex(1);
 }
 
-puzzles::SudokuSolverDialog::~SudokuSolverDialog() = default;
+puzzles::SudokuSolverDialog::~SudokuSolverDialog()
+{
+    if (m_store->isOpen())
+    {
+        SudokuSolutionCache<2>::shared().attachStore(nullptr);
+        SudokuSolutionCache<3>::shared().attachStore(nullptr);
+        SudokuSolutionCache<4>::shared().attachStore(nullptr);
+    }
+}
 
 
 // Slots
@@ -57,10 +85,17 @@ puzzles::SudokuSolverDialog::~SudokuSolverDialog() = default;
 void puzzles::SudokuSolverDialog::slot_setBoardSize(int comboBoxIndex)
 {
     initialiseBoard(comboBoxIndex);
+    m_messageLabel->clear();
     // Resize the dialog to fit the new contents
     adjustSize();
 }
 
+// Show why the last hint was given, or why Solve didn't run
+void puzzles::SudokuSolverDialog::slot_showMessage(QString const& text)
+{
+    m_messageLabel->setText(text);
+}
+
 // Helpers
 //============================================================
 // Initialise m_board
@@ -74,6 +109,12 @@ void puzzles::SudokuSolverDialog::initialiseBoard(int comboBoxIndex)
                      m_board.get(), &SudokuBoardWidgetBase::slot_reset);
     QObject::connect(m_solveButton, &QPushButton::clicked,
                      m_board.get(), &SudokuBoardWidgetBase::slot_solve);
+    QObject::connect(m_hintButton, &QPushButton::clicked,
+                     m_board.get(), &SudokuBoardWidgetBase::slot_hint);
+    QObject::connect(m_board.get(), &SudokuBoardWidgetBase::hintGiven,
+                     this, &SudokuSolverDialog::slot_showMessage);
+    QObject::connect(m_board.get(), &SudokuBoardWidgetBase::solveRefused,
+                     this, &SudokuSolverDialog::slot_showMessage);
     layout()->addWidget(m_board.get());
 }
 
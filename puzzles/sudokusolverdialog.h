@@ -5,6 +5,13 @@ class SudokuSolverDialog
 ====================================================================================================
 A simple dialog to provide a means of solving Sudoku puzzles of potentially any size. Since it's
 simple I decided to have it entirely in code rather than use a qt form for the buttons etc.
+
+Hint takes the next simplest step on the board and says why underneath the buttons, where Solve
+also says why it won't run when it can't.
+
+Solutions are kept in the SudokuSolutionStore at its default path, shared with the command line
+modes, so the cache carries over between runs. If another process has the store open the dialog
+goes on without it.
 */
 #include <QDialog>
 #include <memory>
@@ -14,12 +21,14 @@ class QVBoxLayout;
 class QHBoxLayout;
 class QComboBox;
 class QPushButton;
+class QLabel;
 class QSpacerItem;
 
 namespace puzzles
 {
 // Forward Declarations
 class SudokuBoardWidgetBase;
+class SudokuSolutionStore;
 
 class SudokuSolverDialog :
         public QDialog
@@ -43,6 +52,8 @@ public:
 private slots:
     // Change the size of the board
     void slot_setBoardSize(int comboBoxIndex);
+    // Show why the last hint was given, or why Solve didn't run
+    void slot_showMessage(QString const& text);
 
 private:
     // Helpers
@@ -62,9 +73,12 @@ private:
     QPushButton* m_clearButton;
     QPushButton* m_resetButton;
     QPushButton* m_solveButton;
+    QPushButton* m_hintButton;
+    QLabel* m_messageLabel;
     QSpacerItem* m_interfaceEndSpacer;
 
     std::unique_ptr<SudokuBoardWidgetBase> m_board;
+    std::unique_ptr<SudokuSolutionStore> m_store;
 };
 
 } // namespace puzzles
@@ -0,0 +1,333 @@
+#include "sudokusolveservice.h"
+
+#include "sudokupuzzletext.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    // Defaults
+    //============================================================
+    std::chrono::milliseconds const c_defaultTimeout{ 10000 };
+    std::size_t const c_defaultBatchSize{ 16 };
+    std::size_t const c_maxLineLength{ 64 * 1024 };
+
+    // Split a line into space separated fields
+    std::vector<std::string> splitFields(std::string const& line)
+    {
+        std::vector<std::string> result{};
+        std::istringstream stream{ line };
+        std::string field{};
+        while (stream >> field)
+            result.push_back(field);
+        return result;
+    }
+
+    // Read an unsigned decimal number, returning false if it isn't one
+    bool parseNumber(std::string const& text, std::uint64_t& number)
+    {
+        if (text.empty() || text.size() > 19)
+            return false;
+        number = 0;
+        for (char character : text)
+        {
+            if (character < '0' || character > '9')
+                return false;
+            number = number * 10 + static_cast<std::uint64_t>(character - '0');
+        }
+        return true;
+    }
+
+    // When a request that arrived then with this timeout has to be answered by. A timeout of 0 is no
+    // limit, as in batch mode, and one that would run past the end of the clock stops at it.
+    puzzles::SudokuCancellationToken::clock_type::time_point deadlineFor(puzzles::SudokuCancellationToken::clock_type::time_point received,
+                                                                        std::chrono::milliseconds timeout)
+    {
+        using clock_type = puzzles::SudokuCancellationToken::clock_type;
+        if (timeout.count() == 0
+            || timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(clock_type::time_point::max() - received))
+            return clock_type::time_point::max();
+        return received + timeout;
+    }
+
+    std::uint64_t microseconds(std::chrono::nanoseconds time)
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(time).count());
+    }
+}
+
+// Special 6
+//============================================================
+puzzles::SudokuSolveService::SudokuSolveService(std::size_t workerCount, ResponseHandler const& handler) :
+    m_handler(handler),
+    m_mutex(),
+    m_wake(),
+    m_idle(),
+    m_queue(),
+    m_running{ 0 },
+    m_stopping{ false },
+    m_cancellation(),
+    m_clientTokens(),
+    m_defaultTimeout{ c_defaultTimeout },
+    m_batchSize{ c_defaultBatchSize },
+    m_solver(),
+    m_answered{ 0 },
+    m_solved{ 0 },
+    m_workers()
+{
+    if (workerCount == 0)
+        workerCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    for (std::size_t index = 0; index != workerCount; ++index)
+        m_workers.emplace_back([this]() { work(); });
+}
+
+puzzles::SudokuSolveService::~SudokuSolveService()
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_stopping = true;
+        m_queue.clear();
+        m_cancellation.cancel();
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+// Interface
+//============================================================
+void puzzles::SudokuSolveService::submit(std::uint64_t client, std::string const& line)
+{
+    Request request{};
+    std::string error{};
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        if (parseRequest(line, request, error))
+        {
+            request.client = client;
+            request.received = clock_type::now();
+            request.cancellation = clientToken(client);
+            m_queue.push_back(std::move(request));
+            m_wake.notify_one();
+            return;
+        }
+    }
+    // blank lines and comments have no id and get no answer
+    if (!request.id.empty())
+        m_handler(client, request.id + " error " + error);
+}
+
+void puzzles::SudokuSolveService::cancelClient(std::uint64_t client)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [client](Request const& request) { return request.client == client; }),
+                  m_queue.end());
+    auto found = m_clientTokens.find(client);
+    if (found != m_clientTokens.end())
+    {
+        found->second.cancel();
+        m_clientTokens.erase(found);
+    }
+    if (m_queue.empty() && m_running == 0)
+        m_idle.notify_all();
+}
+
+void puzzles::SudokuSolveService::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_idle.wait(lock, [this]() { return m_queue.empty() && m_running == 0; });
+}
+
+std::size_t puzzles::SudokuSolveService::workerCount() const
+{
+    return m_workers.size();
+}
+
+std::size_t puzzles::SudokuSolveService::maxLineLength()
+{
+    return c_maxLineLength;
+}
+
+void puzzles::SudokuSolveService::setDefaultTimeout(std::chrono::milliseconds timeout)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_defaultTimeout = timeout;
+}
+
+void puzzles::SudokuSolveService::setBatchSize(std::size_t batchSize)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_batchSize = std::max<std::size_t>(1, batchSize);
+}
+
+void puzzles::SudokuSolveService::setCacheLimit(std::size_t boxSize)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_solver.setCacheLimit(boxSize);
+}
+
+std::uint64_t puzzles::SudokuSolveService::answered() const
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_answered;
+}
+
+std::uint64_t puzzles::SudokuSolveService::solved() const
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_solved;
+}
+
+std::string const& puzzles::SudokuSolveService::statusName(SudokuSolveStatus status)
+{
+    static std::string const s_names[]{ "solved", "unsolvable", "timeout", "cancelled" };
+    return s_names[static_cast<std::size_t>(status)];
+}
+
+std::string const& puzzles::SudokuSolveService::engineName(SudokuEngine engine)
+{
+    static std::string const s_names[]{ "auto", "propagation", "sat", "bitboard", "local" };
+    return s_names[static_cast<std::size_t>(engine)];
+}
+
+// Helpers
+//============================================================
+// Called with the mutex held, for the defaults. Sets request.id if there is one, even when the
+// rest of the line is wrong, so the error can be sent back against it.
+bool puzzles::SudokuSolveService::parseRequest(std::string const& line, Request& request, std::string& error) const
+{
+    std::vector<std::string> const fields{ splitFields(line) };
+    if (fields.empty() || fields.front()[0] == '#')
+        return false;
+
+    request.id = fields.front();
+    if (line.size() > c_maxLineLength)
+    {
+        error = "line too long";
+        return false;
+    }
+    if (fields.size() < 2)
+    {
+        error = "missing puzzle";
+        return false;
+    }
+    if (!SudokuPuzzleText::parse(fields[1], request.values, request.boxSize))
+    {
+        error = "bad puzzle";
+        return false;
+    }
+
+    request.options = SudokuSolveOptions{};
+    request.timeout = m_defaultTimeout;
+    for (std::size_t index = 2; index != fields.size(); ++index)
+    {
+        std::string const& field{ fields[index] };
+        std::size_t const equals{ field.find('=') };
+        std::string const name{ field.substr(0, equals) };
+        std::string const value{ equals == std::string::npos ? std::string{} : field.substr(equals + 1) };
+        std::uint64_t number{ 0 };
+
+        if (name == "timeout" && parseNumber(value, number))
+            request.timeout = std::chrono::milliseconds{ std::min<std::uint64_t>(number, std::numeric_limits<std::chrono::milliseconds::rep>::max()) };
+        else if (name == "seed" && parseNumber(value, number))
+            request.options.seed = number;
+        else if (name == "engine" && value == "auto")
+            request.options.engine = SudokuEngine::Automatic;
+        else if (name == "engine" && value == "propagation")
+            request.options.engine = SudokuEngine::Propagation;
+        else if (name == "engine" && value == "sat")
+            request.options.engine = SudokuEngine::Sat;
+        else if (name == "engine" && value == "bitboard")
+            request.options.engine = SudokuEngine::Bitboard;
+        else if (name == "engine" && value == "local")
+            request.options.engine = SudokuEngine::LocalSearch;
+        else
+        {
+            error = "bad option " + field;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Take a batch of requests at a time: up to the batch size, but no more than an even share of the
+// queue so one worker doesn't sit on requests the others could be solving.
+void puzzles::SudokuSolveService::work()
+{
+    std::vector<Request> batch{};
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock{ m_mutex };
+            m_wake.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_stopping)
+                return;
+
+            std::size_t const share{ (m_queue.size() + m_workers.size() - 1) / m_workers.size() };
+            std::size_t const count{ std::min(m_batchSize, std::max<std::size_t>(1, share)) };
+            batch.clear();
+            for (std::size_t index = 0; index != count && !m_queue.empty(); ++index)
+            {
+                batch.push_back(std::move(m_queue.front()));
+                m_queue.pop_front();
+            }
+            m_running += batch.size();
+        }
+
+        for (auto& request : batch)
+        {
+            std::string const response{ answer(request) };
+            m_handler(request.client, response);
+
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            --m_running;
+            if (m_queue.empty() && m_running == 0)
+                m_idle.notify_all();
+        }
+    }
+}
+
+std::string puzzles::SudokuSolveService::answer(Request& request)
+{
+    SudokuRuntimeSolver solver{};
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        solver = m_solver;
+    }
+
+    // The deadline counts from when the request arrived, so time spent queued is part of it
+    clock_type::time_point const started{ clock_type::now() };
+    SudokuRuntimeReport const report{ solver.solve(request.boxSize, request.values.data(), request.values.data(),
+                                                   request.options, deadlineFor(request.received, request.timeout), request.cancellation) };
+
+    std::string response{};
+    response.reserve(request.id.size() + request.values.size() + 96);
+    response += request.id;
+    response += ' ';
+    response += statusName(report.status);
+    response += ' ';
+    SudokuPuzzleText::append(request.values.data(), request.boxSize, response);
+    response += " engine=";
+    response += engineName(report.engine);
+    response += report.cached ? " cached=1" : " cached=0";
+    response += " wait_us=" + std::to_string(microseconds(started - request.received));
+    response += " solve_us=" + std::to_string(microseconds(report.time));
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    ++m_answered;
+    if (report.status == SudokuSolveStatus::Solved)
+        ++m_solved;
+    return response;
+}
+
+// Called with the mutex held
+puzzles::SudokuCancellationToken puzzles::SudokuSolveService::clientToken(std::uint64_t client)
+{
+    auto found = m_clientTokens.find(client);
+    if (found == m_clientTokens.end())
+        found = m_clientTokens.emplace(client, SudokuCancellationToken::linkedTo(m_cancellation)).first;
+    return found->second;
+}
@@ -0,0 +1,137 @@
+#ifndef SUDOKUSOLVESERVICE_H
+#define SUDOKUSOLVESERVICE_H
+/*
+class SudokuSolveService
+====================================================================================================
+The part of the server that doesn't care where requests come from: it parses request lines, queues
+them for a fixed set of worker threads that stay up between requests (along with the shared
+solution caches), and hands back one response line per request through a callback, on whichever
+worker solved it. Idle workers take several queued requests at once, up to the batch size, so a
+burst from many clients costs one lock per batch rather than one per puzzle.
+
+Requests are one line each, made of space separated fields:
+    <id> <puzzle> [timeout=<ms>] [engine=auto|propagation|sat|bitboard|local] [seed=<n>]
+The id is anything without spaces and is echoed back; the puzzle is in a form SudokuPuzzleText
+reads. A timeout of 0 means no limit. Blank lines and lines starting with '#' are ignored, and lines
+longer than maxLineLength() are answered with an error. Responses are:
+    <id> <status> <board> engine=<engine> cached=<0|1> wait_us=<n> solve_us=<n>
+    <id> error <message>
+where status is solved, unsolvable, timeout or cancelled, board is the solution or as far as the
+solve got, wait_us is the time spent queued and solve_us the time spent solving.
+*/
+#include "sudokucancellation.h"
+#include "sudokuruntimesolver.h"
+#include "sudokusolver.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace puzzles
+{
+
+class SudokuSolveService
+{
+public:
+    // Typedefs
+    //============================================================
+    // Called with the client the request came from and the response line, without a newline
+    using ResponseHandler = std::function<void(std::uint64_t client, std::string const& response)>;
+
+    // Special 6
+    //============================================================
+    // workerCount 0 means one per hardware thread
+    SudokuSolveService(std::size_t workerCount, ResponseHandler const& handler);
+    // Cancels whatever is still queued or running and waits for the workers
+    ~SudokuSolveService();
+
+    // No copying
+    SudokuSolveService(SudokuSolveService const& other) = delete;
+    SudokuSolveService& operator=(SudokuSolveService const& other) = delete;
+
+    // Interface
+    //============================================================
+    // Queue a request line. Lines that aren't requests are answered with an error straight away.
+    void submit(std::uint64_t client, std::string const& line);
+
+    // Drop this client's queued requests and cancel the ones being solved, say because it has
+    // disconnected. Responses to requests already running are still sent.
+    void cancelClient(std::uint64_t client);
+
+    // Block until nothing is queued or running
+    void waitUntilIdle();
+
+    std::size_t workerCount() const;
+
+    // Longest request line, without its newline; enough for the largest board with room to spare
+    static std::size_t maxLineLength();
+
+    // Settings, which apply to requests submitted afterwards
+    void setDefaultTimeout(std::chrono::milliseconds timeout);
+    void setBatchSize(std::size_t batchSize);
+    void setCacheLimit(std::size_t boxSize);
+
+    // How many requests have been answered, and how many of those were solved
+    std::uint64_t answered() const;
+    std::uint64_t solved() const;
+
+    // Names as used in requests and responses
+    static std::string const& statusName(SudokuSolveStatus status);
+    static std::string const& engineName(SudokuEngine engine);
+
+private:
+    // Typedefs
+    //============================================================
+    using clock_type = SudokuCancellationToken::clock_type;
+
+    struct Request
+    {
+        std::uint64_t client;
+        std::string id;
+        std::size_t boxSize;
+        std::vector<std::uint8_t> values;
+        SudokuSolveOptions options;
+        std::chrono::milliseconds timeout;
+        clock_type::time_point received;
+        SudokuCancellationToken cancellation;
+    };
+
+    // Helpers
+    //============================================================
+    bool parseRequest(std::string const& line, Request& request, std::string& error) const;
+    void work();
+    std::string answer(Request& request);
+    SudokuCancellationToken clientToken(std::uint64_t client);
+
+    // Data Members
+    //============================================================
+    ResponseHandler m_handler;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::deque<Request> m_queue;
+    std::size_t m_running;
+    bool m_stopping;
+
+    SudokuCancellationToken m_cancellation;     // parent of every client's token
+    std::unordered_map<std::uint64_t, SudokuCancellationToken> m_clientTokens;
+    std::chrono::milliseconds m_defaultTimeout;
+    std::size_t m_batchSize;
+    SudokuRuntimeSolver m_solver;
+    std::uint64_t m_answered;
+    std::uint64_t m_solved;
+
+    std::vector<std::thread> m_workers;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSOLVESERVICE_H
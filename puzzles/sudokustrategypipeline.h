@@ -0,0 +1,186 @@
+#ifndef SUDOKUSTRATEGYPIPELINE_H
+#define SUDOKUSTRATEGYPIPELINE_H
+/*
+enum class SudokuStrategy
+====================================================================================================
+The elimination strategies SudokuBoard<N> can run once the basic eliminations and singles have
+stalled. All of them work on the tiles' candidate bitmasks.
+
+NakedPairs/Triples      k tiles in a unit that can only be k values between them: no other tile in
+                        the unit can be those values.
+HiddenPairs/Triples     k values that can only go in k tiles of a unit: those tiles can't be
+                        anything else.
+PointingPairs           A value that can only go in one row (or column) of a square can't go in
+                        that row (or column) outside the square.
+BoxLineReduction        A value that can only go in one square within a row (or column) can't go
+                        anywhere else in that square.
+
+struct SudokuStrategyStatistics
+====================================================================================================
+How often a strategy ran, how often it found something, how many candidates it removed and how long
+it took in total.
+
+class SudokuStrategyPipeline
+====================================================================================================
+The ordered list of strategies a board runs, each of which can be switched on or off, along with
+their statistics. The board runs the enabled strategies in order and goes back to the basic
+eliminations as soon as one of them removes something, so the cheaper strategies should come first.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace puzzles
+{
+
+enum class SudokuStrategy
+{
+    NakedPairs,
+    HiddenPairs,
+    PointingPairs,
+    BoxLineReduction,
+    NakedTriples,
+    HiddenTriples
+};
+
+struct SudokuStrategyStatistics
+{
+    std::size_t calls;
+    std::size_t hits;
+    std::size_t eliminations;
+    std::chrono::nanoseconds time;
+};
+
+class SudokuStrategyPipeline
+{
+public:
+    // Typedefs
+    //============================================================
+    struct Step
+    {
+        SudokuStrategy strategy;
+        bool enabled;
+        SudokuStrategyStatistics statistics;
+    };
+
+    // Special 6
+    //============================================================
+    // Just the intersection strategies, which are cheap enough to run at every search node
+    SudokuStrategyPipeline() :
+        m_steps()
+    {
+        setOrder({ SudokuStrategy::PointingPairs,
+                   SudokuStrategy::BoxLineReduction });
+    }
+
+    // Every strategy enabled, cheapest first
+    static SudokuStrategyPipeline all()
+    {
+        SudokuStrategyPipeline result{};
+        result.setOrder({ SudokuStrategy::PointingPairs,
+                          SudokuStrategy::BoxLineReduction,
+                          SudokuStrategy::NakedPairs,
+                          SudokuStrategy::HiddenPairs,
+                          SudokuStrategy::NakedTriples,
+                          SudokuStrategy::HiddenTriples });
+        return result;
+    }
+
+    // Only the basic eliminations and singles
+    static SudokuStrategyPipeline none()
+    {
+        SudokuStrategyPipeline result{};
+        result.setOrder({});
+        return result;
+    }
+
+    // Interface
+    //============================================================
+    // Run these strategies in this order; any not listed are disabled and run after them if they
+    // are enabled later.
+    void setOrder(std::vector<SudokuStrategy> const& order)
+    {
+        std::vector<Step> steps{};
+        for (auto strategy : order)
+            steps.push_back(Step{ strategy, true, SudokuStrategyStatistics{} });
+        for (auto strategy : allStrategies())
+        {
+            if (std::find(order.cbegin(), order.cend(), strategy) == order.cend())
+                steps.push_back(Step{ strategy, false, SudokuStrategyStatistics{} });
+        }
+        m_steps = steps;
+    }
+
+    void setEnabled(SudokuStrategy strategy, bool enabled)
+    {
+        step(strategy).enabled = enabled;
+    }
+    bool isEnabled(SudokuStrategy strategy) const
+    {
+        return step(strategy).enabled;
+    }
+
+    std::vector<Step> const& steps() const
+    {
+        return m_steps;
+    }
+    std::vector<Step>& steps()
+    {
+        return m_steps;
+    }
+
+    SudokuStrategyStatistics const& statistics(SudokuStrategy strategy) const
+    {
+        return step(strategy).statistics;
+    }
+    void resetStatistics()
+    {
+        for (auto& step : m_steps)
+            step.statistics = SudokuStrategyStatistics{};
+    }
+
+    static std::vector<SudokuStrategy> allStrategies()
+    {
+        return { SudokuStrategy::NakedPairs,
+                 SudokuStrategy::HiddenPairs,
+                 SudokuStrategy::PointingPairs,
+                 SudokuStrategy::BoxLineReduction,
+                 SudokuStrategy::NakedTriples,
+                 SudokuStrategy::HiddenTriples };
+    }
+
+    static char const* name(SudokuStrategy strategy)
+    {
+        switch (strategy)
+        {
+        case SudokuStrategy::NakedPairs:        return "Naked Pairs";
+        case SudokuStrategy::HiddenPairs:       return "Hidden Pairs";
+        case SudokuStrategy::PointingPairs:     return "Pointing Pairs";
+        case SudokuStrategy::BoxLineReduction:  return "Box/Line Reduction";
+        case SudokuStrategy::NakedTriples:      return "Naked Triples";
+        case SudokuStrategy::HiddenTriples:     return "Hidden Triples";
+        default:                                return "Unknown";
+        }
+    }
+
+private:
+    // Helpers
+    //============================================================
+    Step& step(SudokuStrategy strategy)
+    {
+        return *std::find_if(m_steps.begin(), m_steps.end(), [strategy](Step const& step) { return step.strategy == strategy; });
+    }
+    Step const& step(SudokuStrategy strategy) const
+    {
+        return *std::find_if(m_steps.cbegin(), m_steps.cend(), [strategy](Step const& step) { return step.strategy == strategy; });
+    }
+
+    // Data Members
+    //============================================================
+    std::vector<Step> m_steps;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUSTRATEGYPIPELINE_H
@@ -4,15 +4,20 @@
 class SudokuTile<N>
 ====================================================================================================
 Where N is the maximum number that can appear in the puzzle. N must be a square number. This class
-stores data as an array of N bools, where:
+stores data as a bitmask of N bits, where:
 
-array[index] = state
+bit index = state
 value = index + 1
 
-if (array[index] == true) then the tile can be index + 1
+if (bit index is set) then the tile can be index + 1
+
+Keeping the whole state in one integer means the board can save and restore a tile by copying the
+mask, and the candidate tests are single instructions.
 */
+#include "sudokubits.h"
 #include <array>
 #include <algorithm>
+#include <ostream>
 #include <vector>
 
 namespace puzzles
@@ -24,10 +29,10 @@ class SudokuTile
     static_assert(N >= 4, "SudokuTile cannot be instantiated with a template value less than 4.");
 
 public:
-    using canbe_type = std::array<bool, N>;
+    using canbe_type = typename SudokuMask<N>::type;
 
     SudokuTile() :
-        m_canbe()
+        m_canbe{}
     {
         clear();
     }
@@ -54,15 +59,15 @@ public:
     // Is this tile solved?
     bool isSolved() const
     {
-        // if only one canbe is true, then this tile is solved
-        return std::count(m_canbe.cbegin(), m_canbe.cend(), true) == 1;
+        // if only one bit is set, then this tile is solved
+        return isSingleBit(m_canbe);
     }
 
     // Get the tile solution, returning 0 if it isn't solved
     std::size_t solution() const
     {
         if (isSolved())
-            return indexToValue(std::distance(m_canbe.cbegin(), std::find(m_canbe.cbegin(), m_canbe.cend(), true)));
+            return indexToValue(lowestBitIndex(m_canbe));
         else
             return 0;
     }
@@ -73,13 +78,12 @@ public:
         // if the value is 0, then this tile is cleared
         if (value == 0)
         {
-            m_canbe.fill(true);
+            m_canbe = SudokuMask<N>::full();
         }
         // if the value is within the range, set only that value to true
         else if (value <= N)
         {
-            m_canbe.fill(false);
-            m_canbe[valueToIndex(value)] = true;
+            m_canbe = SudokuMask<N>::bit(value);
         }
     } // canbe is a one value vector
 
@@ -87,10 +91,10 @@ public:
     bool cannotBe(std::size_t value)
     {
         // if the tile is not solved, value is valid and the tile can be value,
-        if (!isSolved() && value != 0 && value <= N && m_canbe[valueToIndex(value)])
+        if (!isSolved() && value != 0 && value <= N && canBe(value))
         {
             // set can be value to false
-            m_canbe[valueToIndex(value)] = false;
+            m_canbe &= static_cast<canbe_type>(~SudokuMask<N>::bit(value));
             // we have changed something
             return true;
         }
@@ -99,16 +103,34 @@ public:
             return false;
     }
 
+    // Can this tile be this value?
+    bool canBe(std::size_t value) const
+    {
+        return (m_canbe & SudokuMask<N>::bit(value)) != 0;
+    }
+
     // Clear the tile data
     void clear()
     {
-        m_canbe.fill(true);
+        m_canbe = SudokuMask<N>::full();
+    }
+
+    // The values this tile could be as a bitmask
+    canbe_type mask() const
+    {
+        return m_canbe;
+    }
+
+    // Replace the values this tile could be
+    void setMask(canbe_type mask)
+    {
+        m_canbe = mask;
     }
 
     // Get the number of values this tile could be.
     std::size_t possibleNumbersCount() const
     {
-        return std::count(m_canbe.cbegin(), m_canbe.cend(), true);
+        return popCount(m_canbe);
     }
 
     // Get the numbers this tile could be
@@ -118,13 +140,11 @@ public:
         std::vector<std::size_t> result{};
         result.reserve(possibleNumbersCount());
 
-        // For each possible index value of m_canbe
-        for (std::size_t index = 0; index != N; ++index)
+        // For each set bit of m_canbe, lowest first
+        for (canbe_type remaining = m_canbe; remaining != 0; remaining &= remaining - 1)
         {
-            // if the index value is true,
-            if (m_canbe[index])
-                // convert the index to the number and add it to result
-                result.push_back(indexToValue(index));
+            // convert the index to the number and add it to result
+            result.push_back(indexToValue(lowestBitIndex(remaining)));
         }
         return result;
     }
@@ -155,8 +175,8 @@ public:
         // For each possible index value of m_canbe
         for (std::size_t index = 0; index != N; ++index)
         {
-            // if the index value is true, output it
-            if (m_canbe[index])
+            // if the index bit is set, output it
+            if (canBe(indexToValue(index)))
                 os << indexToValue(index) << ' ';
         }
         os << ')';
@@ -166,7 +186,7 @@ public:
 private:
     // Data Members
     //============================================================
-    std::array<bool, N> m_canbe;
+    canbe_type m_canbe;
 };
 
 
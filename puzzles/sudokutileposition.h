@@ -5,6 +5,8 @@ struct SudokuTilePosition
 ====================================================================================================
 Simple struct to store a 2D coordinate.
 */
+#include <cstddef>
+
 namespace puzzles
 {
 
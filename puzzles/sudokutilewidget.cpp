@@ -11,11 +11,14 @@ puzzles::SudokuTileWidget::SudokuTileWidget(QWidget *parent) :
     m_defaultPalette{this->palette()},
     m_solvedPalette{this->palette()},
     m_unsolvedPalette{this->palette()},
-    m_startPalette{this->palette()}
+    m_startPalette{this->palette()},
+    m_conflictPalette{this->palette()},
+    m_candidateCount{0}
 {
     m_solvedPalette.setColor(QPalette::Base, Qt::yellow);
     m_unsolvedPalette.setColor(QPalette::Base, Qt::red);
     m_startPalette.setColor(QPalette::Base, Qt::green);
+    m_conflictPalette.setColor(QPalette::Base, QColor(255, 128, 0));
 
     this->setAutoFillBackground(true);
 
@@ -51,6 +54,7 @@ void puzzles::SudokuTileWidget::setState(SudokuTileState state)
     case SudokuTileState::Start:    this->setPalette(m_startPalette); break;
     case SudokuTileState::Solved:   this->setPalette(m_solvedPalette); break;
     case SudokuTileState::Unsolved: this->setPalette(m_unsolvedPalette); break;
+    case SudokuTileState::Conflict: this->setPalette(m_conflictPalette); break;
 
     default:                        this->setPalette(m_defaultPalette); break;
     }
@@ -61,6 +65,19 @@ puzzles::SudokuTileState puzzles::SudokuTileWidget::getState() const
     return m_state;
 }
 
+// How many values the tile could be, kept up to date by the board widget
+void puzzles::SudokuTileWidget::setCandidateCount(std::size_t count)
+{
+    if (count == m_candidateCount)
+        return;
+    m_candidateCount = count;
+    this->setToolTip(count == 1 ? tr("1 candidate") : tr("%1 candidates").arg(count));
+}
+std::size_t puzzles::SudokuTileWidget::getCandidateCount() const
+{
+    return m_candidateCount;
+}
+
 // Slots
 //============================================================
 // Internal slot to extend behaviour when the user changes the QSpinBox value
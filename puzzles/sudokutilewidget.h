@@ -9,7 +9,8 @@ widgets.
 class SudokuTileWidget
 ====================================================================================================
 QSpinBox subclass with a number of colour palettes to signify different states. It provides
-functions to set the value without emitting signals.
+functions to set the value without emitting signals, and shows how many values an empty tile could
+still be in its tooltip.
 */
 #include <QSpinBox>
 
@@ -21,7 +22,8 @@ enum class SudokuTileState
     Empty,
     Start,
     Solved,
-    Unsolved
+    Unsolved,
+    Conflict
 };
 
 class SudokuTileWidget :
@@ -50,6 +52,10 @@ public:
     void setState(SudokuTileState state);
     SudokuTileState getState() const;
 
+    // How many values the tile could be, kept up to date by the board widget
+    void setCandidateCount(std::size_t count);
+    std::size_t getCandidateCount() const;
+
     // Slots
     //============================================================
 private slots:
@@ -64,6 +70,8 @@ private:
     QPalette m_solvedPalette;
     QPalette m_unsolvedPalette;
     QPalette m_startPalette;
+    QPalette m_conflictPalette;
+    std::size_t m_candidateCount;
 };
 
 } // namespace puzzles
@@ -0,0 +1,346 @@
+#ifndef SUDOKUUNITTABLE_H
+#define SUDOKUUNITTABLE_H
+/*
+class SudokuUnitTable<N>
+====================================================================================================
+The units of a SudokuBoard<N>: the groups of N*N tiles that must each hold every value once. A
+default table is classic Sudoku, rows, columns and N by N squares; variants change the table
+rather than the board:
+- setRegions() replaces the squares with irregular regions (jigsaw Sudoku),
+- addDiagonals() adds the two main diagonals (Sudoku X),
+- addWindows() adds the (N-1)^2 extra boxes one tile in from the squares (windoku),
+- addUnit() adds any other group of N*N tiles.
+Units are numbered rows, then columns, then regions (the squares, unless replaced), then any extra
+units in the order they were added, so a classic table numbers its units as the board always has.
+
+Everything the board needs while solving is worked out once, when the table changes:
+- the tiles of each unit,
+- the units of each tile, row, column and region first,
+- the peers of each tile, every other tile sharing a unit with it,
+- every pair of units sharing two or more tiles, with which of each one's tiles are in the other,
+  for the intersection strategies (pointing pairs, box/line reduction) on variants and for hints.
+Tiles are numbered x * N*N + y, as everywhere else.
+
+A table is meant to be built once and shared, through std::shared_ptr<SudokuUnitTable<N> const>,
+by every board that plays that variant; classic() is the one shared classic table.
+*/
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace puzzles
+{
+
+template <std::size_t N>
+class SudokuUnitTable
+{
+public:
+    // Typedefs
+    //============================================================
+    enum : std::size_t { c_maxTileUnits = 8 };
+
+    enum class UnitKind
+    {
+        Row,
+        Column,
+        Region,
+        Extra
+    };
+
+    // Two units with at least two tiles in common. inFirst has a bit for each index of the first
+    // unit's tiles that is also in the second, inSecond the other way round.
+    struct Intersection
+    {
+        std::uint16_t first;
+        std::uint16_t second;
+        std::uint64_t inFirst;
+        std::uint64_t inSecond;
+    };
+
+    // Special 6
+    //============================================================
+    // Classic Sudoku
+    SudokuUnitTable() :
+        m_regions{},
+        m_extraUnits{},
+        m_unitTiles{},
+        m_tileUnits{},
+        m_tileUnitCounts{},
+        m_peerOffsets{},
+        m_peers{},
+        m_intersections{},
+        m_classic{ true }
+    {
+        for (std::size_t tile = 0; tile != tileCount(); ++tile)
+            m_regions[tile] = static_cast<std::uint8_t>(tile / (N*N*N) * N + tile % (N*N) / N);
+        rebuild();
+    }
+
+    // Implicit default copy and move
+
+    // Interface
+    //============================================================
+    // The shared classic table every board starts with
+    static std::shared_ptr<SudokuUnitTable const> const& classic()
+    {
+        static std::shared_ptr<SudokuUnitTable const> const table{ std::make_shared<SudokuUnitTable const>() };
+        return table;
+    }
+
+    // Most units a table can have: rows, columns and regions, and as many extra units again as
+    // there are regions
+    static std::size_t maxUnitCount()       { return 4*N*N; }
+    // Most units one tile can be in
+    static std::size_t maxTileUnits()       { return c_maxTileUnits; }
+    static std::size_t tileCount()          { return N*N*N*N; }
+
+    // Replace the squares with these regions, one number from 0 to N*N - 1 per tile. Returns false,
+    // leaving the table as it was, unless every region has exactly N*N tiles.
+    bool setRegions(std::array<std::uint8_t, N*N*N*N> const& regions)
+    {
+        std::array<std::size_t, N*N> sizes{};
+        for (std::uint8_t const region : regions)
+        {
+            if (region >= N*N || ++sizes[region] > N*N)
+                return false;
+        }
+        m_regions = regions;
+        rebuild();
+        return true;
+    }
+
+    // Add the main diagonal and the anti-diagonal as units
+    bool addDiagonals()
+    {
+        std::array<std::uint16_t, N*N> main{}, anti{};
+        for (std::size_t index = 0; index != N*N; ++index)
+        {
+            main[index] = static_cast<std::uint16_t>(index * N*N + index);
+            anti[index] = static_cast<std::uint16_t>(index * N*N + (N*N - 1 - index));
+        }
+        return addUnits({ main, anti });
+    }
+
+    // Add the windoku boxes: N by N squares starting one tile in from each square, every N + 1
+    // tiles, so (N-1)^2 of them
+    bool addWindows()
+    {
+        std::vector<std::array<std::uint16_t, N*N>> windows{};
+        for (std::size_t xStart = 1; xStart + N <= N*N; xStart += N + 1)
+        {
+            for (std::size_t yStart = 1; yStart + N <= N*N; yStart += N + 1)
+            {
+                std::array<std::uint16_t, N*N> window{};
+                for (std::size_t index = 0; index != N*N; ++index)
+                    window[index] = static_cast<std::uint16_t>((xStart + index / N) * N*N + yStart + index % N);
+                windows.push_back(window);
+            }
+        }
+        return addUnits(windows);
+    }
+
+    // Add a unit of these tiles. Returns false, leaving the table as it was, if a tile is repeated
+    // or out of range, or the table or a tile already has as many units as it can.
+    bool addUnit(std::array<std::uint16_t, N*N> const& tiles)
+    {
+        return addUnits({ tiles });
+    }
+
+    // Just rows, columns and squares?
+    bool isClassic() const
+    {
+        return m_classic;
+    }
+    // Are the regions the N by N squares, whatever extra units there are?
+    bool hasSquareRegions() const
+    {
+        for (std::size_t tile = 0; tile != tileCount(); ++tile)
+        {
+            if (m_regions[tile] != tile / (N*N*N) * N + tile % (N*N) / N)
+                return false;
+        }
+        return true;
+    }
+
+    std::size_t unitCount() const
+    {
+        return 3*N*N + m_extraUnits.size() / (N*N);
+    }
+    static UnitKind unitKind(std::size_t unit)
+    {
+        return unit < N*N ? UnitKind::Row : unit < 2*N*N ? UnitKind::Column : unit < 3*N*N ? UnitKind::Region : UnitKind::Extra;
+    }
+    // The N*N tiles of a unit
+    std::uint16_t const* unitTiles(std::size_t unit) const
+    {
+        return m_unitTiles.data() + unit * N*N;
+    }
+
+    // The units of a tile: its row, column and region, then any extra units
+    std::uint16_t const* tileUnits(std::size_t tile) const
+    {
+        return m_tileUnits.data() + tile * maxTileUnits();
+    }
+    std::size_t tileUnitCount(std::size_t tile) const
+    {
+        return m_tileUnitCounts[tile];
+    }
+    std::size_t regionUnit(std::size_t tile) const
+    {
+        return 2*N*N + m_regions[tile];
+    }
+
+    // Every other tile sharing a unit with a tile
+    std::uint16_t const* peers(std::size_t tile) const
+    {
+        return m_peers.data() + m_peerOffsets[tile];
+    }
+    std::size_t peerCount(std::size_t tile) const
+    {
+        return m_peerOffsets[tile + 1] - m_peerOffsets[tile];
+    }
+
+    // The pairs of units sharing two or more tiles. Boards solving a classic table use the
+    // squares' geometry instead.
+    std::vector<Intersection> const& intersections() const
+    {
+        return m_intersections;
+    }
+
+private:
+    // Helpers
+    //============================================================
+    bool addUnits(std::vector<std::array<std::uint16_t, N*N>> const& units)
+    {
+        if (m_extraUnits.size() / (N*N) + units.size() > N*N)
+            return false;
+        std::array<std::size_t, N*N*N*N> extras{};
+        for (std::size_t tile = 0; tile != tileCount(); ++tile)
+            extras[tile] = m_tileUnitCounts[tile] - 3;
+        for (auto const& unit : units)
+        {
+            std::array<bool, N*N*N*N> seen{};
+            for (std::uint16_t const tile : unit)
+            {
+                if (tile >= tileCount() || seen[tile] || ++extras[tile] + 3 > maxTileUnits())
+                    return false;
+                seen[tile] = true;
+            }
+        }
+        for (auto const& unit : units)
+            m_extraUnits.insert(m_extraUnits.end(), unit.cbegin(), unit.cend());
+        rebuild();
+        return true;
+    }
+
+    void rebuild()
+    {
+        std::size_t const units{ unitCount() };
+        m_unitTiles.fill(0);
+        std::array<std::size_t, N*N> regionSizes{};
+        for (std::size_t tile = 0; tile != tileCount(); ++tile)
+        {
+            std::size_t const xPosition{ tile / (N*N) };
+            std::size_t const yPosition{ tile % (N*N) };
+            m_unitTiles[xPosition * N*N + yPosition] = static_cast<std::uint16_t>(tile);
+            m_unitTiles[(N*N + yPosition) * N*N + xPosition] = static_cast<std::uint16_t>(tile);
+            m_unitTiles[(2*N*N + m_regions[tile]) * N*N + regionSizes[m_regions[tile]]++] = static_cast<std::uint16_t>(tile);
+        }
+        std::copy(m_extraUnits.cbegin(), m_extraUnits.cend(), m_unitTiles.begin() + 3*N*N*N*N);
+
+        // Each tile's units, in unit order so the row, column and region come first
+        m_tileUnits.fill(0);
+        m_tileUnitCounts.fill(0);
+        for (std::size_t unit = 0; unit != units; ++unit)
+        {
+            for (std::size_t index = 0; index != N*N; ++index)
+            {
+                std::size_t const tile{ m_unitTiles[unit * N*N + index] };
+                m_tileUnits[tile * maxTileUnits() + m_tileUnitCounts[tile]++] = static_cast<std::uint16_t>(unit);
+            }
+        }
+
+        // Peers, each once, in tile order
+        m_peers.clear();
+        std::vector<std::uint32_t> marks(tileCount(), 0);
+        for (std::size_t tile = 0; tile != tileCount(); ++tile)
+        {
+            m_peerOffsets[tile] = static_cast<std::uint32_t>(m_peers.size());
+            std::size_t const first{ m_peers.size() };
+            marks[tile] = static_cast<std::uint32_t>(tile + 1);
+            for (std::size_t unit = 0; unit != m_tileUnitCounts[tile]; ++unit)
+            {
+                std::uint16_t const* const tiles = unitTiles(m_tileUnits[tile * maxTileUnits() + unit]);
+                for (std::size_t index = 0; index != N*N; ++index)
+                {
+                    if (marks[tiles[index]] != tile + 1)
+                    {
+                        marks[tiles[index]] = static_cast<std::uint32_t>(tile + 1);
+                        m_peers.push_back(tiles[index]);
+                    }
+                }
+            }
+            std::sort(m_peers.begin() + static_cast<std::ptrdiff_t>(first), m_peers.end());
+        }
+        m_peerOffsets[tileCount()] = static_cast<std::uint32_t>(m_peers.size());
+
+        m_classic = m_extraUnits.empty() && hasSquareRegions();
+        m_intersections.clear();
+        findIntersections();
+    }
+
+    void findIntersections()
+    {
+        std::vector<std::int16_t> indexes(tileCount(), -1);     // of each tile in the first unit
+        std::size_t const units{ unitCount() };
+        for (std::size_t first = 0; first != units; ++first)
+        {
+            std::uint16_t const* const firstTiles = unitTiles(first);
+            for (std::size_t index = 0; index != N*N; ++index)
+                indexes[firstTiles[index]] = static_cast<std::int16_t>(index);
+
+            for (std::size_t second = first + 1; second != units; ++second)
+            {
+                std::uint16_t const* const secondTiles = unitTiles(second);
+                Intersection intersection{ static_cast<std::uint16_t>(first), static_cast<std::uint16_t>(second), 0, 0 };
+                for (std::size_t index = 0; index != N*N; ++index)
+                {
+                    std::int16_t const inFirst{ indexes[secondTiles[index]] };
+                    if (inFirst >= 0)
+                    {
+                        intersection.inFirst |= std::uint64_t{ 1 } << inFirst;
+                        intersection.inSecond |= std::uint64_t{ 1 } << index;
+                    }
+                }
+                // One shared tile leaves nothing to eliminate; all of them would be the same unit twice
+                std::size_t shared{ 0 };
+                for (std::uint64_t remaining = intersection.inFirst; remaining != 0 && shared != 2; remaining &= remaining - 1)
+                    ++shared;
+                if (shared == 2 && intersection.inFirst != (N*N == 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << (N*N)) - 1))
+                    m_intersections.push_back(intersection);
+            }
+
+            for (std::size_t index = 0; index != N*N; ++index)
+                indexes[firstTiles[index]] = -1;
+        }
+    }
+
+    // Data Members
+    //============================================================
+    std::array<std::uint8_t, N*N*N*N> m_regions;            // per tile
+    std::vector<std::uint16_t> m_extraUnits;                // N*N tiles each
+    std::array<std::uint16_t, 4*N*N * N*N> m_unitTiles;     // N*N per unit, for maxUnitCount() units
+    std::array<std::uint16_t, N*N*N*N * c_maxTileUnits> m_tileUnits;   // maxTileUnits() per tile
+    std::array<std::uint8_t, N*N*N*N> m_tileUnitCounts;
+    std::array<std::uint32_t, N*N*N*N + 1> m_peerOffsets;   // into m_peers, per tile and one past the last
+    std::vector<std::uint16_t> m_peers;
+    std::vector<Intersection> m_intersections;
+    bool m_classic;
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUUNITTABLE_H
@@ -0,0 +1,229 @@
+#include "sudokuvalidator.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define SUDOKUVALIDATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    using puzzles::SudokuValidity;
+
+    // One board through the unit masks. givens, if not null, is the puzzle a solution must keep.
+    SudokuValidity checkBoard(std::uint8_t const* values, std::uint8_t const* givens, std::size_t boxSize, bool solution)
+    {
+        std::size_t const size{ boxSize * boxSize };
+        std::uint64_t rows[64], columns[64], squares[64];
+        std::fill(rows, rows + size, 0);
+        std::fill(columns, columns + size, 0);
+        std::fill(squares, squares + size, 0);
+        std::size_t squareColumns[64];
+        for (std::size_t column = 0; column != size; ++column)
+            squareColumns[column] = column / boxSize;
+
+        std::uint64_t repeated{ 0 };
+        bool empty{ false };
+        bool changed{ false };
+        for (std::size_t row = 0; row != size; ++row)
+        {
+            std::size_t const squareRow{ row / boxSize * boxSize };
+            for (std::size_t column = 0; column != size; ++column)
+            {
+                std::size_t const tile{ row * size + column };
+                std::size_t const value{ values[tile] };
+                if (value > size)
+                    return SudokuValidity::BadValue;
+                empty |= value == 0;
+                changed |= givens != nullptr && givens[tile] != 0 && givens[tile] != value;
+
+                std::uint64_t const mask{ value != 0 ? std::uint64_t{ 1 } << (value - 1) : 0 };
+                std::size_t const square{ squareRow + squareColumns[column] };
+                repeated |= (rows[row] | columns[column] | squares[square]) & mask;
+                rows[row] |= mask;
+                columns[column] |= mask;
+                squares[square] |= mask;
+            }
+        }
+
+        if (solution && empty)
+            return SudokuValidity::Incomplete;
+        if (changed)
+            return SudokuValidity::GivenChanged;
+        return repeated != 0 ? SudokuValidity::Conflict : SudokuValidity::Valid;
+    }
+
+#if defined(SUDOKUVALIDATOR_SSE2)
+    // Boards checked together, a 16 bit lane each
+    std::size_t const c_groupSize{ 8 };
+
+    // A 16 byte chunk of each of eight boards turned into the chunk's sixteen tiles of all eight
+    // boards, two tiles to a register: tile 2i in the low half of out[i], tile 2i + 1 in the high
+    void transpose(__m128i const* in, __m128i* out)
+    {
+        __m128i pairs[8];       // boards 2i and 2i + 1 interleaved, tiles 0-7 then 8-15
+        for (std::size_t index = 0; index != 4; ++index)
+        {
+            pairs[2 * index] = _mm_unpacklo_epi8(in[2 * index], in[2 * index + 1]);
+            pairs[2 * index + 1] = _mm_unpackhi_epi8(in[2 * index], in[2 * index + 1]);
+        }
+        __m128i quads[8];       // boards 0-3 then 4-7, four tiles each
+        for (std::size_t half = 0; half != 2; ++half)
+        {
+            __m128i const* const pair = pairs + 4 * half;
+            quads[4 * half] = _mm_unpacklo_epi16(pair[0], pair[2]);
+            quads[4 * half + 1] = _mm_unpackhi_epi16(pair[0], pair[2]);
+            quads[4 * half + 2] = _mm_unpacklo_epi16(pair[1], pair[3]);
+            quads[4 * half + 3] = _mm_unpackhi_epi16(pair[1], pair[3]);
+        }
+        for (std::size_t index = 0; index != 4; ++index)
+        {
+            out[2 * index] = _mm_unpacklo_epi32(quads[index], quads[4 + index]);
+            out[2 * index + 1] = _mm_unpackhi_epi32(quads[index], quads[4 + index]);
+        }
+    }
+
+    // 1 << (value - 1) for eight 16 bit values, 0 for 0. 2^(value - 1) as a float is value + 126
+    // in the exponent field; the bias of 32768 keeps 1 << 15 clear of packs' signed saturation.
+    __m128i valueMasks(__m128i values)
+    {
+        __m128i const zero{ _mm_setzero_si128() };
+        __m128i const bias{ _mm_set1_epi32(126) };
+        __m128i const offset{ _mm_set1_epi32(32768) };
+        __m128i const low{ _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_unpacklo_epi16(values, zero), bias), 23))) };
+        __m128i const high{ _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_unpackhi_epi16(values, zero), bias), 23))) };
+        return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(low, offset), _mm_sub_epi32(high, offset)), _mm_set1_epi16(-32768));
+    }
+
+    bool isZero(__m128i value)
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(value, _mm_setzero_si128())) == 0xFFFF;
+    }
+
+    // Eight boards of N^4 values, and their givens if not null
+    template <std::size_t N>
+    void checkGroup(std::uint8_t const* values, std::uint8_t const* givens, bool solution, SudokuValidity* results)
+    {
+        std::size_t const size{ N*N };
+        std::size_t const tileCount{ N*N*N*N };
+        __m128i const zero{ _mm_setzero_si128() };
+        __m128i const ones{ _mm_set1_epi8(-1) };
+        __m128i const largest{ _mm_set1_epi8(static_cast<char>(size)) };
+
+        __m128i units[3 * size];        // rows, columns, squares
+        std::fill(units, units + 3 * size, zero);
+        __m128i repeated{ zero };
+        __m128i tooLarge[c_groupSize], empty[c_groupSize], kept[c_groupSize];
+        std::fill(tooLarge, tooLarge + c_groupSize, zero);
+        std::fill(empty, empty + c_groupSize, zero);
+        std::fill(kept, kept + c_groupSize, ones);
+
+        // The last chunk is moved back to end with the board; its tiles already seen are skipped
+        for (std::size_t start = 0; start < tileCount; start += 16)
+        {
+            std::size_t const chunk{ std::min(start, tileCount - 16) };
+            __m128i in[c_groupSize], tiles[c_groupSize];
+            for (std::size_t board = 0; board != c_groupSize; ++board)
+            {
+                in[board] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(values + board * tileCount + chunk));
+                tooLarge[board] = _mm_or_si128(tooLarge[board], _mm_subs_epu8(in[board], largest));
+                empty[board] = _mm_or_si128(empty[board], _mm_cmpeq_epi8(in[board], zero));
+                if (givens != nullptr)
+                {
+                    __m128i const given{ _mm_loadu_si128(reinterpret_cast<__m128i const*>(givens + board * tileCount + chunk)) };
+                    kept[board] = _mm_and_si128(kept[board], _mm_or_si128(_mm_cmpeq_epi8(given, in[board]), _mm_cmpeq_epi8(given, zero)));
+                }
+            }
+            transpose(in, tiles);
+
+            for (std::size_t index = start - chunk; index != 16; ++index)
+            {
+                __m128i const pair{ tiles[index / 2] };
+                __m128i const mask{ valueMasks(index % 2 == 0 ? _mm_unpacklo_epi8(pair, zero) : _mm_unpackhi_epi8(pair, zero)) };
+                std::size_t const tile{ chunk + index };
+                __m128i& row = units[tile / size];
+                __m128i& column = units[size + tile % size];
+                __m128i& square = units[2 * size + tile / size / N * N + tile % size / N];
+                repeated = _mm_or_si128(repeated, _mm_and_si128(_mm_or_si128(_mm_or_si128(row, column), square), mask));
+                row = _mm_or_si128(row, mask);
+                column = _mm_or_si128(column, mask);
+                square = _mm_or_si128(square, mask);
+            }
+        }
+
+        int const clear{ _mm_movemask_epi8(_mm_cmpeq_epi16(repeated, zero)) };
+        for (std::size_t board = 0; board != c_groupSize; ++board)
+        {
+            if (!isZero(tooLarge[board]))
+                results[board] = SudokuValidity::BadValue;
+            else if (solution && !isZero(empty[board]))
+                results[board] = SudokuValidity::Incomplete;
+            else if (_mm_movemask_epi8(_mm_cmpeq_epi8(kept[board], ones)) != 0xFFFF)
+                results[board] = SudokuValidity::GivenChanged;
+            else
+                results[board] = (clear & (1 << (2 * board))) == 0 ? SudokuValidity::Conflict : SudokuValidity::Valid;
+        }
+    }
+#endif
+
+    std::size_t checkAll(std::uint8_t const* values, std::uint8_t const* givens, std::size_t count, std::size_t boxSize,
+                         bool solution, SudokuValidity* results)
+    {
+        std::size_t const tileCount{ boxSize * boxSize * boxSize * boxSize };
+        std::size_t board{ 0 };
+#if defined(SUDOKUVALIDATOR_SSE2)
+        if (boxSize == 3 || boxSize == 4)
+        {
+            for (; count - board >= c_groupSize; board += c_groupSize)
+            {
+                std::uint8_t const* const groupGivens{ givens != nullptr ? givens + board * tileCount : nullptr };
+                if (boxSize == 3)
+                    checkGroup<3>(values + board * tileCount, groupGivens, solution, results + board);
+                else
+                    checkGroup<4>(values + board * tileCount, groupGivens, solution, results + board);
+            }
+        }
+#endif
+        for (; board != count; ++board)
+            results[board] = checkBoard(values + board * tileCount, givens != nullptr ? givens + board * tileCount : nullptr, boxSize, solution);
+        return static_cast<std::size_t>(std::count(results, results + count, SudokuValidity::Valid));
+    }
+}
+
+// Interface
+//============================================================
+puzzles::SudokuValidity puzzles::SudokuValidator::checkGivens(std::uint8_t const* values, std::size_t boxSize)
+{
+    return checkBoard(values, nullptr, boxSize, false);
+}
+
+puzzles::SudokuValidity puzzles::SudokuValidator::checkSolution(std::uint8_t const* solution, std::uint8_t const* givens, std::size_t boxSize)
+{
+    return checkBoard(solution, givens, boxSize, true);
+}
+
+std::size_t puzzles::SudokuValidator::checkAllGivens(std::uint8_t const* values, std::size_t count, std::size_t boxSize,
+                                                     SudokuValidity* results)
+{
+    return checkAll(values, nullptr, count, boxSize, false, results);
+}
+
+std::size_t puzzles::SudokuValidator::checkAllSolutions(std::uint8_t const* solutions, std::uint8_t const* givens, std::size_t count,
+                                                        std::size_t boxSize, SudokuValidity* results)
+{
+    return checkAll(solutions, givens, count, boxSize, true, results);
+}
+
+char const* puzzles::SudokuValidator::name(SudokuValidity validity)
+{
+    switch (validity)
+    {
+    case SudokuValidity::Valid:         return "valid";
+    case SudokuValidity::BadValue:      return "bad value";
+    case SudokuValidity::Incomplete:    return "incomplete";
+    case SudokuValidity::GivenChanged:  return "given changed";
+    case SudokuValidity::Conflict:      return "conflicting values";
+    default:                            return "unknown";
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SUDOKUVALIDATOR_H
+#define SUDOKUVALIDATOR_H
+/*
+enum class SudokuValidity
+====================================================================================================
+What a validity check found, most serious first when a board has more than one fault.
+
+Valid           Nothing wrong.
+BadValue        A value larger than the board's values.
+Incomplete      An empty tile, for a solution.
+GivenChanged    A solution tile that differs from the puzzle's value there.
+Conflict        A value twice in a row, column or square.
+
+class SudokuValidator
+====================================================================================================
+Checks boards given as N^4 bytes (row-major, 0 for empty) as they come into and go out of the batch
+modes, without building a SudokuBoard<N>: SudokuBoard<N> takes contradictory givens without
+complaint, and nothing else looks again at a board reported solved.
+
+Each tile's value becomes a one bit mask, and every row, column and square ORs together the masks of
+its tiles. A tile whose mask is already in one of its three unit masks repeats a value there, so one
+pass over the tiles finds every conflict. For a solution with no empty tiles and no conflicts every
+unit holds every value once, so nothing else needs checking.
+
+checkAllGivens() and checkAllSolutions() check many boards of one size at once. For 9x9 and 16x16
+boards on SSE2 they work on eight boards at a time, a 16 bit lane each: the boards' bytes are
+transposed so a register holds one tile of all eight, the masks come from the float exponent
+(2^(v - 1) is v + 126 shifted into the exponent field), and the unit masks are registers, so a tile
+costs a handful of instructions for all eight boards. Other sizes, and boards left over from the
+groups of eight, go through the plain loop.
+*/
+#include <cstddef>
+#include <cstdint>
+
+namespace puzzles
+{
+
+enum class SudokuValidity
+{
+    Valid,
+    BadValue,
+    Incomplete,
+    GivenChanged,
+    Conflict
+};
+
+class SudokuValidator
+{
+public:
+    // Interface
+    //============================================================
+    // Are the boxSize^4 values a puzzle: each 0 to boxSize^2, and no value twice in a unit?
+    static SudokuValidity checkGivens(std::uint8_t const* values, std::size_t boxSize);
+    // Is the solution complete and free of conflicts, and does it keep every given? givens may be
+    // null to check the solution alone.
+    static SudokuValidity checkSolution(std::uint8_t const* solution, std::uint8_t const* givens, std::size_t boxSize);
+
+    // The same for count boards stored back to back, writing one result per board. Returns the
+    // number found valid.
+    static std::size_t checkAllGivens(std::uint8_t const* values, std::size_t count, std::size_t boxSize,
+                                      SudokuValidity* results);
+    static std::size_t checkAllSolutions(std::uint8_t const* solutions, std::uint8_t const* givens, std::size_t count,
+                                         std::size_t boxSize, SudokuValidity* results);
+
+    static char const* name(SudokuValidity validity);
+};
+
+} // namespace puzzles
+
+#endif // SUDOKUVALIDATOR_H
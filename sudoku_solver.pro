@@ -8,13 +8,36 @@ QT       += core gui
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
+QT       += network
+
 TARGET = sudoku_solver
 TEMPLATE = app
 
+# gzip input through zlib; zstd input too with qmake CONFIG+=zstd
+LIBS += -lz
+zstd {
+    DEFINES += SUDOKU_WITH_ZSTD
+    LIBS += -lzstd
+}
+
 
 SOURCES += main.cpp \
     puzzles/sudokusolverdialog.cpp \
-    puzzles/sudokutilewidget.cpp
+    puzzles/sudokutilewidget.cpp \
+    puzzles/sudokusolutionstore.cpp \
+    puzzles/sudokusatsolver.cpp \
+    puzzles/sudokupuzzletext.cpp \
+    puzzles/sudokuruntimesolver.cpp \
+    puzzles/sudokusolveservice.cpp \
+    puzzles/sudokuserver.cpp \
+    puzzles/sudokucommandline.cpp \
+    puzzles/sudokubatchpipeline.cpp \
+    puzzles/sudokubandboard.cpp \
+    puzzles/sudokushardedbatch.cpp \
+    puzzles/sudokuvalidator.cpp \
+    puzzles/sudokuperfcounters.cpp \
+    puzzles/sudokubenchmark.cpp \
+    puzzles/sudokucompressedinput.cpp
 
 HEADERS  += \
     puzzles/sudokusolverdialog.h \
@@ -23,6 +46,37 @@ HEADERS  += \
     puzzles/sudokuboardwidgetbase.h \
     puzzles/sudokuboardwidget.h \
     puzzles/sudokutileposition.h \
-    puzzles/sudokutilewidget.h
+    puzzles/sudokutilewidget.h \
+    puzzles/sudokucanonicalform.h \
+    puzzles/sudokusolutionstore.h \
+    puzzles/sudokusolutioncache.h \
+    puzzles/sudokubits.h \
+    puzzles/sudokusearchstatistics.h \
+    puzzles/sudokustrategypipeline.h \
+    puzzles/sudokusatsolver.h \
+    puzzles/sudokusatengine.h \
+    puzzles/sudokusolver.h \
+    puzzles/sudokucancellation.h \
+    puzzles/sudokuportfoliosolver.h \
+    puzzles/sudokupuzzletext.h \
+    puzzles/sudokuruntimesolver.h \
+    puzzles/sudokusolveservice.h \
+    puzzles/sudokuserver.h \
+    puzzles/sudokucommandline.h \
+    puzzles/sudokuringbuffer.h \
+    puzzles/sudokubatchpipeline.h \
+    puzzles/sudokuboardsnapshot.h \
+    puzzles/sudokusolutionenumerator.h \
+    puzzles/sudokuminimizer.h \
+    puzzles/sudokubandboard.h \
+    puzzles/sudokushardedbatch.h \
+    puzzles/sudokulocalsearch.h \
+    puzzles/sudokuvalidator.h \
+    puzzles/sudokuperfcounters.h \
+    puzzles/sudokubenchmark.h \
+    puzzles/sudokucompressedinput.h \
+    puzzles/sudokuunittable.h \
+    puzzles/sudokuhintengine.h \
+    puzzles/sudokucompletioncounter.h
 
 FORMS    +=